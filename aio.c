@@ -0,0 +1,707 @@
+// aio.c - E/S fichiers asynchrones pour SwiftFlow (io.read_async / io.write_async)
+// Backend io_uring (appels système directs, sans liburing) avec repli sur un
+// pool de threads quand io_uring n'est pas disponible (noyau ancien, seccomp...).
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "common.h"
+#include "io.h"
+#include "aio.h"
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define AIO_HAVE_URING 1
+#else
+#define AIO_HAVE_URING 0
+#endif
+
+// ======================================================
+// [SECTION] REQUÊTES
+// ======================================================
+#define AIO_MAX_REQUESTS   4096
+#define AIO_RING_ENTRIES   256
+#define AIO_READ_INITIAL   (16 * 1024)
+#define AIO_POOL_THREADS   8
+
+typedef enum { AIO_OP_READ, AIO_OP_WRITE } AioOp;
+typedef enum { AIO_STAGE_OPEN, AIO_STAGE_IO, AIO_STAGE_CLOSE } AioStage;
+
+struct AioState;
+
+typedef struct AioRequest {
+    bool in_use;
+    bool done;
+    AioOp op;
+    AioStage stage;
+    char* path;
+    bool append;
+    int fd;
+    char* buffer;     // lecture : contenu (agrandi au besoin) ; écriture : données
+    size_t capacity;
+    size_t length;    // octets lus / octets à écrire
+    size_t offset;    // octets déjà écrits
+    int error;        // errno de la première erreur
+    struct AioState* owner;       // isolat qui a soumis la requête
+    struct AioRequest* next;      // file du pool de threads
+} AioRequest;
+
+typedef enum { AIO_BACKEND_NONE, AIO_BACKEND_URING, AIO_BACKEND_THREADS, AIO_BACKEND_SYNC } AioBackend;
+
+// ======================================================
+// [SECTION] ÉTAT PAR ISOLAT
+// ======================================================
+// Chaque isolat (thread principal, workers de spawn) a ses requêtes, son
+// anneau io_uring et son tube de réveil : un await ne récolte et ne draine
+// que ce qui le concerne. Seuls les threads du pool bloquant sont partagés.
+// Alloué à la première opération asynchrone de l'isolat.
+#if AIO_HAVE_URING
+typedef struct {
+    int fd;
+    // Anneau de soumission
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned sq_entries;
+    unsigned to_submit;
+    // Anneau de complétion
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned in_flight;
+} Uring;
+#endif
+
+typedef struct AioState {
+    AioRequest requests[AIO_MAX_REQUESTS];
+    AioBackend backend;
+    int notify[2];    // pool : un octet par complétion (boucle d'événements)
+#if AIO_HAVE_URING
+    Uring ring;
+    bool ring_failed; // io_uring_enter en échec : requêtes reprises par le pool
+#endif
+} AioState;
+
+static ISOLATE AioState* aio = NULL;
+
+static int alloc_request(const char* path, AioOp op) {
+    for (int i = 0; i < AIO_MAX_REQUESTS; i++) {
+        if (!aio->requests[i].in_use) {
+            AioRequest* req = &aio->requests[i];
+            memset(req, 0, sizeof(*req));
+            req->owner = aio;
+            req->in_use = true;
+            req->op = op;
+            req->fd = -1;
+            req->path = str_copy(path);
+            return i;
+        }
+    }
+    printf("%s[IO ERROR]%s Too many pending async operations (max %d)\n",
+           COLOR_RED, COLOR_RESET, AIO_MAX_REQUESTS);
+    return -1;
+}
+
+static void free_request(AioRequest* req) {
+    free(req->path);
+    free(req->buffer);
+    memset(req, 0, sizeof(*req));
+}
+
+static int open_flags(AioRequest* req) {
+    if (req->op == AIO_OP_READ) return O_RDONLY | O_CLOEXEC;
+    return O_WRONLY | O_CREAT | O_CLOEXEC | (req->append ? O_APPEND : O_TRUNC);
+}
+
+// Agrandit le buffer de lecture quand il est plein ; false si mémoire épuisée
+static bool grow_read_buffer(AioRequest* req) {
+    if (req->length < req->capacity) return true;
+    size_t cap = req->capacity ? req->capacity * 2 : AIO_READ_INITIAL;
+    char* grown = realloc(req->buffer, cap + 1); // +1 : terminateur
+    if (!grown) return false;
+    req->buffer = grown;
+    req->capacity = cap;
+    return true;
+}
+
+// Exécution synchrone (pool de threads et dernier recours). Reprend une
+// requête abandonnée par io_uring là où elle en était si le fichier est ouvert.
+static void run_blocking(AioRequest* req) {
+    int fd = req->fd;
+    if (fd < 0) {
+        fd = open(req->path, open_flags(req), 0644);
+        if (fd < 0) {
+            req->error = errno;
+            return;
+        }
+    } else if (req->op == AIO_OP_READ || !req->append) {
+        // io_uring travaille à positions explicites : on se replace à la suite
+        off_t pos = (off_t)(req->op == AIO_OP_READ ? req->length : req->offset);
+        if (lseek(fd, pos, SEEK_SET) < 0 && !req->error) req->error = errno;
+    }
+    req->fd = -1;
+
+    if (req->error) {
+        // Étape d'E/S déjà en échec : il ne reste qu'à fermer
+    } else if (req->op == AIO_OP_READ) {
+        for (;;) {
+            if (!grow_read_buffer(req)) { req->error = ENOMEM; break; }
+            ssize_t n = read(fd, req->buffer + req->length, req->capacity - req->length);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) { req->error = errno; break; }
+            if (n == 0) break;
+            req->length += (size_t)n;
+        }
+    } else {
+        while (req->offset < req->length) {
+            ssize_t n = write(fd, req->buffer + req->offset, req->length - req->offset);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) { req->error = errno; break; }
+            req->offset += (size_t)n;
+        }
+    }
+
+    if (close(fd) != 0 && !req->error) req->error = errno;
+}
+
+// ======================================================
+// [SECTION] BACKEND IO_URING
+// ======================================================
+// Les soumissions s'accumulent dans l'anneau et partent en un seul
+// io_uring_enter() au prochain await (ou quand l'anneau est plein).
+// Chaque requête enchaîne openat -> read/write -> close ; les étapes de
+// toutes les requêtes en vol progressent dans les mêmes appels système.
+#if AIO_HAVE_URING
+static bool pool_init(void);
+static void start_request(int id);
+
+#define AIO_CANCEL_TAG UINT64_MAX // user_data des SQE d'annulation (complétions ignorées)
+
+static int uring_setup(unsigned entries, struct io_uring_params* p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, aio->ring.fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static bool uring_init(void) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = uring_setup(AIO_RING_ENTRIES, &p);
+    if (fd < 0) return false;
+
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && cq_size > sq_size) sq_size = cq_size;
+
+    char* sq = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) { close(fd); return false; }
+    char* cq = sq;
+    if (!single) {
+        cq = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) { munmap(sq, sq_size); close(fd); return false; }
+    }
+    struct io_uring_sqe* sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe),
+                                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(sq, sq_size);
+        if (!single) munmap(cq, cq_size);
+        close(fd);
+        return false;
+    }
+
+    aio->ring.fd = fd;
+    aio->ring.sq_head = (unsigned*)(sq + p.sq_off.head);
+    aio->ring.sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    aio->ring.sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+    aio->ring.sq_array = (unsigned*)(sq + p.sq_off.array);
+    aio->ring.sq_entries = p.sq_entries;
+    aio->ring.sqes = sqes;
+    aio->ring.cq_head = (unsigned*)(cq + p.cq_off.head);
+    aio->ring.cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    aio->ring.cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    aio->ring.cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    aio->ring.to_submit = 0;
+    aio->ring.in_flight = 0;
+    return true;
+}
+
+static int uring_submit(unsigned min_complete) {
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = uring_enter(aio->ring.to_submit, min_complete, flags);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) return -errno;
+    aio->ring.to_submit -= (unsigned)ret < aio->ring.to_submit ? (unsigned)ret : aio->ring.to_submit;
+    return ret;
+}
+
+// Erreur d'io_uring_enter qui ne se résorbe pas en réessayant
+static bool uring_fatal(int ret) {
+    return ret < 0 && ret != -EBUSY && ret != -EAGAIN;
+}
+
+static void uring_reap(void);
+static void uring_abandon(int err);
+
+// NULL si l'anneau a dû être abandonné (la requête est alors reprise ailleurs)
+static struct io_uring_sqe* uring_get_sqe(void) {
+    for (;;) {
+        unsigned head = __atomic_load_n(aio->ring.sq_head, __ATOMIC_ACQUIRE);
+        unsigned tail = *aio->ring.sq_tail;
+        // Anneau plein ou trop d'opérations en vol pour la file de complétion :
+        // on soumet et on attend une complétion
+        if (tail - head < aio->ring.sq_entries && aio->ring.in_flight < aio->ring.sq_entries) {
+            unsigned index = tail & *aio->ring.sq_mask;
+            struct io_uring_sqe* sqe = &aio->ring.sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            aio->ring.sq_array[index] = index;
+            return sqe;
+        }
+        int ret = uring_submit(1);
+        if (uring_fatal(ret)) {
+            uring_abandon(-ret);
+            return NULL;
+        }
+        uring_reap();
+    }
+}
+
+static void uring_push(struct io_uring_sqe* sqe) {
+    (void)sqe;
+    __atomic_store_n(aio->ring.sq_tail, *aio->ring.sq_tail + 1, __ATOMIC_RELEASE);
+    aio->ring.to_submit++;
+    aio->ring.in_flight++;
+}
+
+static void uring_queue_stage(int id) {
+    AioRequest* req = &aio->requests[id];
+    struct io_uring_sqe* sqe = aio->ring_failed ? NULL : uring_get_sqe();
+    if (!sqe) return;
+    sqe->user_data = (uint64_t)id;
+
+    switch (req->stage) {
+        case AIO_STAGE_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t)(uintptr_t)req->path;
+            sqe->len = 0644;
+            sqe->open_flags = (uint32_t)open_flags(req);
+            break;
+        case AIO_STAGE_IO:
+            sqe->fd = req->fd;
+            if (req->op == AIO_OP_READ) {
+                sqe->opcode = IORING_OP_READ;
+                sqe->addr = (uint64_t)(uintptr_t)(req->buffer + req->length);
+                sqe->len = (uint32_t)(req->capacity - req->length);
+                sqe->off = req->length;
+            } else {
+                sqe->opcode = IORING_OP_WRITE;
+                sqe->addr = (uint64_t)(uintptr_t)(req->buffer + req->offset);
+                sqe->len = (uint32_t)(req->length - req->offset);
+                sqe->off = req->append ? (uint64_t)-1 : req->offset; // -1 : position courante (O_APPEND)
+            }
+            break;
+        case AIO_STAGE_CLOSE:
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = req->fd;
+            break;
+    }
+    uring_push(sqe);
+}
+
+// Fait avancer une requête après la complétion de son étape courante
+static void uring_advance(int id, int res) {
+    AioRequest* req = &aio->requests[id];
+    if (res == -ECANCELED && aio->ring_failed) return; // reprise bloquante à la même étape
+
+    switch (req->stage) {
+        case AIO_STAGE_OPEN:
+            if (res < 0) {
+                req->error = -res;
+                req->done = true;
+                return;
+            }
+            req->fd = res;
+            req->stage = AIO_STAGE_IO;
+            if (req->op == AIO_OP_READ && !grow_read_buffer(req)) {
+                req->error = ENOMEM;
+                req->stage = AIO_STAGE_CLOSE;
+            } else if (req->op == AIO_OP_WRITE && req->length == 0) {
+                req->stage = AIO_STAGE_CLOSE;
+            }
+            break;
+        case AIO_STAGE_IO:
+            if (res < 0) {
+                if (res == -EINTR || res == -EAGAIN) break; // même étape resoumise
+                req->error = -res;
+                req->stage = AIO_STAGE_CLOSE;
+            } else if (req->op == AIO_OP_READ) {
+                req->length += (size_t)res;
+                if (res == 0) req->stage = AIO_STAGE_CLOSE; // fin de fichier
+                else if (!grow_read_buffer(req)) {
+                    req->error = ENOMEM;
+                    req->stage = AIO_STAGE_CLOSE;
+                }
+            } else {
+                req->offset += (size_t)res;
+                if (req->offset >= req->length) req->stage = AIO_STAGE_CLOSE;
+            }
+            break;
+        case AIO_STAGE_CLOSE:
+            if (res < 0 && !req->error) req->error = -res;
+            req->fd = -1;
+            req->done = true;
+            return;
+    }
+    if (!aio->ring_failed) uring_queue_stage(id);
+}
+
+static void uring_reap(void) {
+    unsigned head = *aio->ring.cq_head;
+    for (;;) {
+        unsigned tail = __atomic_load_n(aio->ring.cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail) break;
+        struct io_uring_cqe* cqe = &aio->ring.cqes[head & *aio->ring.cq_mask];
+        int id = (int)cqe->user_data;
+        int res = cqe->res;
+        head++;
+        __atomic_store_n(aio->ring.cq_head, head, __ATOMIC_RELEASE);
+        if (cqe->user_data == AIO_CANCEL_TAG) continue;
+        aio->ring.in_flight--;
+        uring_advance(id, res);
+        head = *aio->ring.cq_head; // uring_advance a pu consommer d'autres complétions
+    }
+}
+
+// io_uring_enter échoue durablement. Une requête ne peut pas être reprise
+// tant que le noyau peut encore écrire dans son buffer : les SQE non soumises
+// sont retirées de l'anneau, celles que le noyau détient sont annulées
+// (IORING_OP_ASYNC_CANCEL) et leurs complétions récoltées. Les requêtes
+// inachevées repartent ensuite sur le pool de threads.
+static void uring_abandon(int err) {
+    if (aio->ring_failed) return;
+    aio->ring_failed = true;
+    printf("%s[IO ERROR]%s io_uring_enter failed: %s (falling back to threads)\n",
+           COLOR_RED, COLOR_RESET, strerror(err));
+
+    // Sans SQPOLL, seul io_uring_enter consomme les SQE : celles au-delà de
+    // sq_head n'ont jamais été vues par le noyau
+    bool withdrawn[AIO_MAX_REQUESTS] = { false };
+    unsigned head = __atomic_load_n(aio->ring.sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *aio->ring.sq_tail;
+    for (unsigned i = head; i != tail; i++) {
+        uint64_t id = aio->ring.sqes[aio->ring.sq_array[i & *aio->ring.sq_mask]].user_data;
+        if (id < AIO_MAX_REQUESTS) withdrawn[id] = true;
+    }
+    aio->ring.in_flight -= tail - head;
+
+    // Une annulation par requête en vol dans le noyau (une seule SQE chacune)
+    unsigned cancels = 0;
+    for (int id = 0; id < AIO_MAX_REQUESTS && cancels < aio->ring.sq_entries; id++) {
+        if (!aio->requests[id].in_use || aio->requests[id].done || withdrawn[id]) continue;
+        unsigned index = (head + cancels) & *aio->ring.sq_mask;
+        struct io_uring_sqe* sqe = &aio->ring.sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = (uint64_t)id;
+        sqe->user_data = AIO_CANCEL_TAG;
+        aio->ring.sq_array[index] = index;
+        cancels++;
+    }
+    __atomic_store_n(aio->ring.sq_tail, head + cancels, __ATOMIC_RELEASE);
+    aio->ring.to_submit = cancels;
+
+    bool drained = true;
+    while (aio->ring.to_submit > 0 || aio->ring.in_flight > 0) {
+        int ret = uring_submit(aio->ring.in_flight ? 1 : 0);
+        if (uring_fatal(ret)) {
+            drained = false;
+            break;
+        }
+        uring_reap();
+    }
+
+    aio->backend = pool_init() ? AIO_BACKEND_THREADS : AIO_BACKEND_SYNC;
+    for (int id = 0; id < AIO_MAX_REQUESTS; id++) {
+        AioRequest* req = &aio->requests[id];
+        if (!req->in_use || req->done) continue;
+        if (drained) {
+            start_request(id);
+            continue;
+        }
+        // Opération peut-être encore en cours dans le noyau : buffer et chemin
+        // lui sont laissés (fuite volontaire), la requête échoue
+        req->error = err;
+        req->fd = -1;
+        req->buffer = NULL;
+        req->path = str_copy(req->path);
+        req->done = true;
+    }
+}
+
+static void uring_wait(int id) {
+    while (!aio->requests[id].done && !aio->ring_failed) {
+        int ret = uring_submit(1);
+        if (uring_fatal(ret)) {
+            uring_abandon(-ret);
+            break;
+        }
+        uring_reap();
+    }
+}
+#endif
+
+// ======================================================
+// [SECTION] BACKEND POOL DE THREADS
+// ======================================================
+// Threads communs à tous les isolats : une requête porte son isolat
+// propriétaire, dont le tube reçoit l'octet de complétion.
+static pthread_t pool[AIO_POOL_THREADS];
+static int pool_size = 0;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static AioRequest* pool_head = NULL; // file FIFO chaînée par req->next
+static AioRequest* pool_tail = NULL;
+
+static void* pool_worker(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!pool_head) pthread_cond_wait(&pool_work, &pool_lock);
+        AioRequest* req = pool_head;
+        pool_head = req->next;
+        if (!pool_head) pool_tail = NULL;
+        pthread_mutex_unlock(&pool_lock);
+
+        run_blocking(req);
+
+        pthread_mutex_lock(&pool_lock);
+        req->done = true;
+        pthread_cond_broadcast(&pool_done);
+        if (req->owner->notify[1] >= 0) {
+            char byte = 1;
+            ssize_t ignored = write(req->owner->notify[1], &byte, 1);
+            (void)ignored;
+        }
+    }
+    return NULL;
+}
+
+// Tube de l'isolat courant, threads démarrés par le premier isolat
+static bool pool_init(void) {
+    if (aio->notify[0] < 0 && pipe(aio->notify) == 0) {
+        fcntl(aio->notify[0], F_SETFL, O_NONBLOCK);
+        fcntl(aio->notify[1], F_SETFL, O_NONBLOCK);
+    }
+    pthread_mutex_lock(&pool_lock);
+    if (pool_size == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        int wanted = cpus > 0 ? (int)cpus * 2 : 2; // E/S bloquantes : plus de threads que de CPU
+        if (wanted > AIO_POOL_THREADS) wanted = AIO_POOL_THREADS;
+        for (int i = 0; i < wanted; i++) {
+            if (pthread_create(&pool[pool_size], NULL, pool_worker, NULL) != 0) break;
+            pthread_detach(pool[pool_size]);
+            pool_size++;
+        }
+    }
+    bool ok = pool_size > 0;
+    pthread_mutex_unlock(&pool_lock);
+    return ok;
+}
+
+// ======================================================
+// [SECTION] API
+// ======================================================
+static void init_backend(void) {
+    if (aio && aio->backend != AIO_BACKEND_NONE) return;
+    if (!aio) {
+        aio = calloc(1, sizeof(AioState));
+        if (!aio) { fprintf(stderr, "%s[FATAL]%s Out of memory (async I/O)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        aio->notify[0] = aio->notify[1] = -1;
+    }
+    const char* forced = getenv("SWIFT_AIO_BACKEND");
+
+#if AIO_HAVE_URING
+    if (!forced || strcmp(forced, "uring") == 0) {
+        if (uring_init()) {
+            aio->backend = AIO_BACKEND_URING;
+            return;
+        }
+    }
+#endif
+    if (!forced || strcmp(forced, "sync") != 0) {
+        if (pool_init()) {
+            aio->backend = AIO_BACKEND_THREADS;
+            return;
+        }
+    }
+    aio->backend = AIO_BACKEND_SYNC;
+}
+
+static void start_request(int id) {
+    switch (aio->backend) {
+#if AIO_HAVE_URING
+        case AIO_BACKEND_URING:
+            uring_queue_stage(id);
+            break;
+#endif
+        case AIO_BACKEND_THREADS:
+            pthread_mutex_lock(&pool_lock);
+            aio->requests[id].next = NULL;
+            if (pool_tail) pool_tail->next = &aio->requests[id];
+            else pool_head = &aio->requests[id];
+            pool_tail = &aio->requests[id];
+            pthread_cond_signal(&pool_work);
+            pthread_mutex_unlock(&pool_lock);
+            break;
+        default:
+            run_blocking(&aio->requests[id]);
+            aio->requests[id].done = true;
+            break;
+    }
+}
+
+// Les identifiants exposés au script commencent à 1 (0 = échec, falsy)
+int aio_read_submit(const char* path) {
+    if (!path) return 0;
+    init_backend();
+    io_sync_path(path);
+    int id = alloc_request(path, AIO_OP_READ);
+    if (id < 0) return 0;
+    start_request(id);
+    return id + 1;
+}
+
+int aio_write_submit(const char* path, const char* data, size_t len, bool append) {
+    if (!path) return 0;
+    init_backend();
+    io_sync_path(path);
+    int id = alloc_request(path, AIO_OP_WRITE);
+    if (id < 0) return 0;
+
+    AioRequest* req = &aio->requests[id];
+    req->append = append;
+    req->buffer = malloc(len + 1);
+    if (!req->buffer) {
+        free_request(req);
+        printf("%s[IO ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+        return 0;
+    }
+    memcpy(req->buffer, data, len);
+    req->length = len;
+    req->capacity = len;
+    start_request(id);
+    return id + 1;
+}
+
+bool aio_is_pending(int handle) {
+    int id = handle - 1;
+    return aio && id >= 0 && id < AIO_MAX_REQUESTS && aio->requests[id].in_use;
+}
+
+char* aio_await(int handle, long long* result) {
+    int id = handle - 1;
+    if (!aio_is_pending(handle)) {
+        if (result) *result = -1;
+        return NULL;
+    }
+    AioRequest* req = &aio->requests[id];
+
+#if AIO_HAVE_URING
+    if (aio->backend == AIO_BACKEND_URING) uring_wait(id); // peut basculer sur le pool
+#endif
+    if (aio->backend == AIO_BACKEND_THREADS) {
+        pthread_mutex_lock(&pool_lock);
+        while (!req->done) pthread_cond_wait(&pool_done, &pool_lock);
+        pthread_mutex_unlock(&pool_lock);
+    }
+
+    char* content = NULL;
+    if (req->error) {
+        printf("%s[IO ERROR]%s Async %s failed: %s (%s)\n", COLOR_RED, COLOR_RESET,
+               req->op == AIO_OP_READ ? "read" : "write", req->path, strerror(req->error));
+        if (result) *result = -1;
+    } else if (req->op == AIO_OP_READ) {
+        // Le buffer devient la chaîne retournée (pas de recopie)
+        content = req->buffer ? req->buffer : malloc(1);
+        if (content) content[req->length] = '\0';
+        req->buffer = NULL;
+        if (result) *result = (long long)req->length;
+    } else {
+        if (result) *result = (long long)req->offset;
+    }
+
+    free_request(req);
+    return content;
+}
+
+int aio_event_fd(void) {
+    init_backend();
+    switch (aio->backend) {
+#if AIO_HAVE_URING
+        case AIO_BACKEND_URING: return aio->ring.fd;
+#endif
+        case AIO_BACKEND_THREADS: return aio->notify[0];
+        default: return -1;
+    }
+}
+
+bool aio_ready(int handle) {
+    int id = handle - 1;
+    if (!aio_is_pending(handle)) return true;
+    AioRequest* req = &aio->requests[id];
+
+    switch (aio->backend) {
+#if AIO_HAVE_URING
+        case AIO_BACKEND_URING:
+            // Complétions reçues, puis soumission des étapes suivantes (sans
+            // attendre) jusqu'à ce que rien de nouveau ne soit en file
+            uring_reap();
+            while (!req->done && aio->ring.to_submit > 0) {
+                int ret = uring_submit(0);
+                if (uring_fatal(ret)) {
+                    uring_abandon(-ret);
+                    return aio_ready(handle); // requête reprise par le pool
+                }
+                if (ret <= 0) break;
+                uring_reap();
+            }
+            return req->done;
+#endif
+        case AIO_BACKEND_THREADS: {
+            char drain[64];
+            while (aio->notify[0] >= 0 && read(aio->notify[0], drain, sizeof(drain)) > 0) {}
+            pthread_mutex_lock(&pool_lock);
+            bool done = req->done;
+            pthread_mutex_unlock(&pool_lock);
+            return done;
+        }
+        default:
+            return true;
+    }
+}
+
+const char* aio_backend_name(void) {
+    init_backend();
+    switch (aio->backend) {
+        case AIO_BACKEND_URING: return "io_uring";
+        case AIO_BACKEND_THREADS: return "threads";
+        default: return "sync";
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef AIO_H
+#define AIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================
+// E/S FICHIERS ASYNCHRONES (io_uring, repli pool de threads)
+// Les soumissions retournent un handle > 0 (0 = échec) consommé par await.
+// L'état est propre à chaque isolat : un handle n'est valable que dans
+// l'isolat qui l'a créé.
+// SWIFT_AIO_BACKEND=uring|threads|sync force le backend.
+// ============================================================
+
+int aio_read_submit(const char* path);
+int aio_write_submit(const char* path, const char* data, size_t len, bool append);
+
+// Vrai si le handle désigne une opération pas encore attendue
+bool aio_is_pending(int handle);
+
+// Attend la fin de l'opération et libère le handle.
+// Lecture : retourne le contenu (à libérer), *result = octets lus.
+// Écriture : retourne NULL, *result = octets écrits. Erreur : NULL et *result = -1.
+char* aio_await(int handle, long long* result);
+
+// Boucle d'événements (sched.h) : fd lisible quand des opérations se
+// terminent (-1 : backend synchrone), et test sans blocage d'un handle
+int aio_event_fd(void);
+bool aio_ready(int handle);
+
+// "io_uring", "threads" ou "sync"
+const char* aio_backend_name(void);
+
+#endif
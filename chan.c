@@ -0,0 +1,193 @@
+// chan.c - Canaux bornés MPMC pour SwiftFlow (tâches et workers)
+// File de Vyukov : chaque case porte un numéro de séquence qui dit si elle
+// attend un producteur (seq == pos) ou un consommateur (seq == pos + 1).
+// Producteurs et consommateurs réservent une position par CAS sur tail ou
+// head, puis publient la case en avançant sa séquence. La fermeture pose le
+// bit de poids fort de tail : plus aucune position ne peut être réservée
+// ensuite, et le canal est vidé quand head rattrape tail.
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "common.h"
+#include "chan.h"
+
+// ======================================================
+// [SECTION] STRUCTURE
+// ======================================================
+#define CHAN_LINE 64 // head et tail sur des lignes de cache distinctes
+#define CHAN_CLOSED_BIT ((size_t)1 << (sizeof(size_t) * 8 - 1)) // dans tail
+
+typedef struct {
+    size_t seq;
+    void* item;
+} ChanCell;
+
+struct Channel {
+    ChanCell* cells;
+    size_t cap;
+    void (*drop)(void* item);
+    int refs;
+    char pad0[CHAN_LINE];
+    size_t head;                   // prochaine position à recevoir
+    char pad1[CHAN_LINE - sizeof(size_t)];
+    size_t tail;                   // prochaine position à envoyer (| CHAN_CLOSED_BIT)
+    char pad2[CHAN_LINE - sizeof(size_t)];
+
+    // Descripteurs en attente (chemin lent seulement)
+    pthread_mutex_t watch_lock;
+    int watch_count;               // lu sans verrou par notify()
+    int watch_cap;
+    int* watchers;
+};
+
+Channel* chan_new(int capacity, void (*drop)(void* item)) {
+    if (capacity < 1) capacity = 1;
+    Channel* ch = calloc(1, sizeof(Channel));
+    ChanCell* cells = calloc((size_t)capacity, sizeof(ChanCell));
+    if (!ch || !cells) { fprintf(stderr, "%s[FATAL]%s Out of memory (channel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    for (int i = 0; i < capacity; i++) cells[i].seq = (size_t)i;
+    ch->cells = cells;
+    ch->cap = (size_t)capacity;
+    ch->drop = drop;
+    ch->refs = 1;
+    pthread_mutex_init(&ch->watch_lock, NULL);
+    return ch;
+}
+
+void chan_retain(Channel* ch) {
+    __atomic_add_fetch(&ch->refs, 1, __ATOMIC_RELAXED);
+}
+
+void chan_release(Channel* ch) {
+    if (__atomic_sub_fetch(&ch->refs, 1, __ATOMIC_ACQ_REL) > 0) return;
+    void* item;
+    while (chan_try_recv(ch, &item) == CHAN_OK) {
+        if (ch->drop) ch->drop(item);
+    }
+    pthread_mutex_destroy(&ch->watch_lock);
+    free(ch->watchers);
+    free(ch->cells);
+    free(ch);
+}
+
+// ======================================================
+// [SECTION] RÉVEILS
+// ======================================================
+static void notify(Channel* ch) {
+    // Case publiée avant de lire watch_count ; l'attente s'inscrit avant de
+    // revérifier le canal : l'un des deux voit toujours l'autre
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ch->watch_count, __ATOMIC_RELAXED) == 0) return;
+    pthread_mutex_lock(&ch->watch_lock);
+    char byte = 1;
+    for (int i = 0; i < ch->watch_count; i++) {
+        ssize_t written = write(ch->watchers[i], &byte, 1); // tube plein : réveil déjà en attente
+        (void)written;
+    }
+    pthread_mutex_unlock(&ch->watch_lock);
+}
+
+void chan_watch(Channel* ch, int fd) {
+    pthread_mutex_lock(&ch->watch_lock);
+    if (ch->watch_count == ch->watch_cap) {
+        int cap = ch->watch_cap ? ch->watch_cap * 2 : 4;
+        int* watchers = realloc(ch->watchers, (size_t)cap * sizeof(int));
+        if (!watchers) { fprintf(stderr, "%s[FATAL]%s Out of memory (channel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        ch->watchers = watchers;
+        ch->watch_cap = cap;
+    }
+    ch->watchers[ch->watch_count] = fd;
+    __atomic_store_n(&ch->watch_count, ch->watch_count + 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&ch->watch_lock);
+}
+
+void chan_unwatch(Channel* ch, int fd) {
+    pthread_mutex_lock(&ch->watch_lock);
+    for (int i = 0; i < ch->watch_count; i++) {
+        if (ch->watchers[i] == fd) {
+            ch->watchers[i] = ch->watchers[ch->watch_count - 1];
+            __atomic_store_n(&ch->watch_count, ch->watch_count - 1, __ATOMIC_SEQ_CST);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&ch->watch_lock);
+}
+
+// ======================================================
+// [SECTION] ENVOI ET RÉCEPTION
+// ======================================================
+ChanStatus chan_try_send(Channel* ch, void* item) {
+    size_t pos = __atomic_load_n(&ch->tail, __ATOMIC_RELAXED);
+    ChanCell* cell;
+    for (;;) {
+        // Le CAS échoue si la fermeture a posé son bit entre-temps
+        if (pos & CHAN_CLOSED_BIT) return CHAN_CLOSED;
+        cell = &ch->cells[pos % ch->cap];
+        size_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ch->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            return CHAN_FULL; // la case n'a pas encore été lue
+        } else {
+            pos = __atomic_load_n(&ch->tail, __ATOMIC_RELAXED);
+        }
+    }
+    cell->item = item;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    notify(ch);
+    return CHAN_OK;
+}
+
+ChanStatus chan_try_recv(Channel* ch, void** item) {
+    size_t pos = __atomic_load_n(&ch->head, __ATOMIC_RELAXED);
+    ChanCell* cell;
+    for (;;) {
+        cell = &ch->cells[pos % ch->cap];
+        size_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ch->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            size_t tail = __atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE);
+            if (!(tail & CHAN_CLOSED_BIT)) return CHAN_EMPTY;
+            // Fermé : tail ne bouge plus. Vide seulement quand head l'a rattrapé ;
+            // sinon un envoi réservé avant la fermeture n'est pas encore publié
+            // (il réveillera les inscrits) ou un autre récepteur a avancé head
+            size_t head = __atomic_load_n(&ch->head, __ATOMIC_RELAXED);
+            if (head == (tail & ~CHAN_CLOSED_BIT)) return CHAN_CLOSED;
+            if (head == pos) return CHAN_EMPTY;
+            pos = head;
+        } else {
+            pos = __atomic_load_n(&ch->head, __ATOMIC_RELAXED);
+        }
+    }
+    *item = cell->item;
+    __atomic_store_n(&cell->seq, pos + ch->cap, __ATOMIC_RELEASE);
+    notify(ch);
+    return CHAN_OK;
+}
+
+void chan_close(Channel* ch) {
+    __atomic_fetch_or(&ch->tail, CHAN_CLOSED_BIT, __ATOMIC_SEQ_CST);
+    notify(ch);
+}
+
+bool chan_closed(Channel* ch) {
+    return (__atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE) & CHAN_CLOSED_BIT) != 0;
+}
+
+int chan_len(Channel* ch) {
+    size_t head = __atomic_load_n(&ch->head, __ATOMIC_ACQUIRE);
+    size_t tail = __atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE) & ~CHAN_CLOSED_BIT;
+    return tail > head ? (int)(tail - head) : 0;
+}
+
+int chan_cap(Channel* ch) {
+    return (int)ch->cap;
+}
@@ -0,0 +1,39 @@
+#ifndef CHAN_H
+#define CHAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================
+// CANAUX BORNÉS MPMC
+// Anneau sans verrou (une séquence par case) : plusieurs producteurs et
+// consommateurs, sur un ou plusieurs threads, sans mutex sur le chemin
+// rapide. Un canal ne fait pas attendre : plein ou vide, l'appelant
+// s'inscrit avec un descripteur (chan_watch), revérifie, puis attend sur ce
+// descripteur à sa façon (boucle d'événements, poll). Chaque envoi, réception
+// ou fermeture écrit un octet sur les descripteurs inscrits.
+// ============================================================
+
+typedef struct Channel Channel;
+
+typedef enum { CHAN_OK, CHAN_FULL, CHAN_EMPTY, CHAN_CLOSED } ChanStatus;
+
+// Canal de 'capacity' éléments (au moins 1) ; drop libère les éléments
+// restants quand le dernier détenteur le lâche
+Channel* chan_new(int capacity, void (*drop)(void* item));
+void chan_retain(Channel* ch);
+void chan_release(Channel* ch);
+
+ChanStatus chan_try_send(Channel* ch, void* item);   // CHAN_OK, CHAN_FULL, CHAN_CLOSED
+ChanStatus chan_try_recv(Channel* ch, void** item);  // CHAN_OK, CHAN_EMPTY, CHAN_CLOSED (vide et fermé)
+void chan_close(Channel* ch);
+
+bool chan_closed(Channel* ch);
+int chan_len(Channel* ch);
+int chan_cap(Channel* ch);
+
+// Inscription d'un descripteur à réveiller (une inscription par appel)
+void chan_watch(Channel* ch, int fd);
+void chan_unwatch(Channel* ch, int fd);
+
+#endif
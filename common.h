@@ -11,6 +11,14 @@
 #include <stdarg.h>
 #include <limits.h>
 
+// ======================================================
+// [SECTION] ISOLATS
+// ======================================================
+// L'état de l'interpréteur (variables, fonctions, tas et GC, chaînes,
+// symboles, lexer/parser, coroutines) est propre à chaque thread : le
+// programme principal et chaque worker de spawn() ont leur isolat (pool.c)
+#define ISOLATE __thread
+
 // ======================================================
 // [SECTION] ANSI COLOR CODES
 // ======================================================
@@ -50,6 +58,9 @@ typedef enum {
     TK_JSON_GET,     TK_MATH_SIN, TK_MATH_COS, TK_MATH_TAN, TK_MATH_SQRT, 
     TK_MATH_POW, TK_MATH_ABS, TK_MATH_FLOOR, TK_MATH_CEIL, 
     TK_MATH_ROUND, TK_MATH_RANDOM,
+    // Tableaux typés et opérations groupées (math.float64, math.sum...)
+    TK_MATH_F64, TK_MATH_I64, TK_MATH_SUM, TK_MATH_MIN, TK_MATH_MAX, TK_MATH_MEAN,
+    TK_MATH_DOT, TK_MATH_VADD, TK_MATH_VSUB, TK_MATH_VMUL, TK_MATH_VDIV, TK_MATH_SIMD,
     
     // STRING
     TK_STR_LEN, TK_STR_UPPER, TK_STR_LOWER, TK_STR_SUB, 
@@ -57,6 +68,10 @@ typedef enum {
     
     // TIME
     TK_TIME_NOW, TK_TIME_SLEEP, TK_TIME_FMT,
+    TK_TIME_NOW_NS, TK_TIME_PERF, TK_TIME_AFTER, TK_TIME_EVERY, TK_TIME_CANCEL,
+    
+    // GC
+    TK_GC_COLLECT, TK_GC_STAT,
     
     // ENC (Encoding)
     TK_ENC_B64ENC, TK_ENC_B64DEC,
@@ -146,6 +161,7 @@ typedef enum {
     TK_IO_EXISTS, TK_IO_ISFILE, TK_IO_ISDIR,
     TK_IO_MKDIR, TK_IO_RMDIR, TK_IO_LISTDIR,
     TK_IO_REMOVE, TK_IO_RENAME, TK_IO_COPY,
+    TK_IO_WRITER, TK_IO_LINES, TK_IO_CHUNKS, TK_IO_WALK, TK_IO_READ_ASYNC, TK_IO_WRITE_ASYNC, TK_IO_ASYNC_BACKEND,
 
     // reseaux
     TK_NET_SOCKET, TK_NET_CONNECT, TK_NET_LISTEN, TK_NET_ACCEPT,
@@ -153,7 +169,7 @@ typedef enum {
     // New keywords
     TK_PASS, TK_GLOBAL, TK_LAMBDA,
     TK_BDD, TK_DEF, TK_TYPE, TK_RAISE,
-    TK_WITH, TK_LEARN, TK_NONLOCAL, TK_LOCK, 
+    TK_WITH, TK_LEARN, TK_NONLOCAL, TK_LOCK, TK_RWLOCK, TK_PARALLEL, 
     TK_APPEND, TK_PUSH, TK_POP,
     
     // JSON & Data
@@ -183,8 +199,18 @@ typedef struct {
         char* str_val;
         bool bool_val;
     } value;
+    int sym;    // Symbole interné des identifiants (intern.h), 0 sinon
 } Token;
 
+// Position du lexer (sauvegarde/restauration pour le lookahead du parser)
+typedef struct {
+    const char* start;
+    const char* current;
+    int line;
+    int column;
+    int start_column;
+} LexerState;
+
 // Keyword mapping
 typedef struct {
     const char* keyword;
@@ -207,6 +233,8 @@ static const Keyword keywords[] = {
     {"def", TK_DEF},          // Alias pour func
     {"nonlocal", TK_NONLOCAL}, // Accès portée parente
     {"lock", TK_LOCK},        // Thread safety / Variable lock
+    {"rwlock", TK_RWLOCK},    // Verrou lecteurs / écrivain
+    {"parallel", TK_PARALLEL}, // parallel for : itérations réparties sur les workers
     {"bdd", TK_BDD},          // Base de données intégrée
     {"utf8", TK_TYPE_UTF8},
 
@@ -306,6 +334,8 @@ typedef enum {
     NODE_STR_FUNC,  // Un seul type générique pour les strings
     NODE_TIME_NOW,
     NODE_TIME_SLEEP,
+    NODE_TIME_FUNC, // time.now_ns / perf / after / every / cancel (op_type)
+    NODE_GC_FUNC,
     NODE_ENV_FUNC,
     NODE_PATH_FUNC,
     NODE_ENC_FUNC,
@@ -316,6 +346,8 @@ typedef enum {
     NODE_SYS_EXEC,
     NODE_SYS_ARGV,
     NODE_SYS_EXIT,
+    NODE_SYS_SPAWN,   // sys.spawn(argv [, options]) -> "proc_N"
+    NODE_SYS_RUN_ALL, // sys.run_all(commandes [, options]) -> liste de résultats
     NODE_JSON_GET,
     NODE_STD_LEN,
     NODE_STD_SPLIT,
@@ -352,18 +384,25 @@ typedef enum {
     NODE_ARRAY_ACCESS,
     NODE_MEMBER_ACCESS,
     NODE_CRYPTO_FUNC,
+    NODE_IO_FUNC,   // Un seul type générique pour les nouvelles primitives io (writer, ...)
+    NODE_MAP_ENTRY, // Entrée d'un littéral map : right = clé, left = valeur
     // Operations
     NODE_BINARY,
     NODE_UNARY,
     NODE_TERNARY,
     NODE_ASSIGN,
     NODE_COMPOUND_ASSIGN,
+    // Superinstructions (optimiseur) : fourth garde la forme générique
+    NODE_INC_LOCAL,       // x = x + k, x += k, x -= k ; right : littéral k, op_type TK_PLUS / TK_MINUS
+    NODE_CMP_LOCALS,      // a < b, a == k... ; left : identifiant, right : identifiant ou littéral
+    NODE_ADD_LOCAL_CONST, // x + k, x - k ; left : identifiant, right : littéral
     NODE_IMPORTDB,
     // Control flow
     NODE_IF,
     NODE_WHILE,
     NODE_FOR,
-    NODE_FOR_IN,
+    NODE_FOR_IN,       // third : fin d'un intervalle a..b (op_type TK_RANGE / TK_RANGE_INCL)
+    NODE_PARALLEL_FOR, // comme NODE_FOR_IN ; fourth : réductions (nom, left : opération)
     NODE_SWITCH,
     NODE_CASE,
     NODE_RETURN,
@@ -468,6 +507,7 @@ typedef struct ASTNode {
     struct ASTNode* right;
     struct ASTNode* third;
     struct ASTNode* fourth;
+    struct ASTNode* next;   // Chaînage séquentiel (instructions d'un bloc, arguments, entrées de map)
     
     union {
         // Basic values
@@ -567,6 +607,13 @@ typedef struct ASTNode {
     int line;
     int column;
     TokenKind op_type;
+    int sym;    // Symbole interné du nom (identifiant, fonction, méthode), 0 si absent
+    
+    // Cache en ligne des accès membres / appels de méthode : forme (Shape) vue
+    // au dernier passage, slot de la propriété ou fonction de la méthode
+    void* ic_shape;
+    void* ic_target;
+    int ic_slot;
 } ASTNode;
 
 // ======================================================
@@ -5,6 +5,7 @@
 #include <curl/curl.h>
 #include "common.h"
 #include "http.h"
+#include "sched.h"
 
 // Structure pour stocker la réponse en mémoire
 struct string {
@@ -59,6 +60,58 @@ int progress_callback(void *clientp, double dltotal, double dlnow, double ultota
     return 0;
 }
 
+// curl_easy_perform() coopératif : dans un programme avec des tâches async,
+// le transfert passe par l'interface multi et attend l'activité de ses
+// sockets via la boucle d'événements au lieu de bloquer tout le processus.
+static CURLcode perform(CURL* curl) {
+    if (!sched_active()) return curl_easy_perform(curl);
+
+    CURLM* multi = curl_multi_init();
+    if (!multi) return curl_easy_perform(curl);
+    curl_multi_add_handle(multi, curl);
+
+    CURLcode result = CURLE_OK;
+    int running = 1;
+    while (running) {
+        if (curl_multi_perform(multi, &running) != CURLM_OK) {
+            result = CURLE_FAILED_INIT;
+            break;
+        }
+        if (!running) break;
+
+        fd_set rd, wr, ex;
+        int max_fd = -1;
+        FD_ZERO(&rd); FD_ZERO(&wr); FD_ZERO(&ex);
+        curl_multi_fdset(multi, &rd, &wr, &ex, &max_fd);
+        long timeout = -1;
+        curl_multi_timeout(multi, &timeout);
+        if (timeout < 0 || timeout > 100) timeout = 100; // résolution DNS sans socket visible
+
+        struct pollfd fds[64];
+        int nfds = 0;
+        for (int fd = 0; fd <= max_fd && nfds < 64; fd++) {
+            short events = (FD_ISSET(fd, &rd) ? POLLIN : 0) | (FD_ISSET(fd, &wr) ? POLLOUT : 0) |
+                           (FD_ISSET(fd, &ex) ? POLLPRI : 0);
+            if (events) {
+                fds[nfds].fd = fd;
+                fds[nfds].events = events;
+                fds[nfds].revents = 0;
+                nfds++;
+            }
+        }
+        sched_poll(fds, nfds, (int)timeout);
+    }
+
+    CURLMsg* msg;
+    int left;
+    while ((msg = curl_multi_info_read(multi, &left))) {
+        if (msg->msg == CURLMSG_DONE && msg->easy_handle == curl) result = msg->data.result;
+    }
+    curl_multi_remove_handle(multi, curl);
+    curl_multi_cleanup(multi);
+    return result;
+}
+
 void init_http_module(void) {
     curl_global_init(CURL_GLOBAL_ALL);
    
@@ -78,7 +131,7 @@ char* http_get(const char* url) {
         curl_easy_setopt(curl, CURLOPT_USERAGENT, "Zarch-Client/1.0");
         curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); // Suivre les redirections
 
-        res = curl_easy_perform(curl);
+        res = perform(curl);
         curl_easy_cleanup(curl);
 
         if(res != CURLE_OK) {
@@ -109,7 +162,7 @@ char* http_post(const char* url, const char* json_data) {
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &s);
         curl_easy_setopt(curl, CURLOPT_USERAGENT, "Zarch-Client/1.0");
 
-        res = curl_easy_perform(curl);
+        res = perform(curl);
         
         curl_slist_free_all(headers);
         curl_easy_cleanup(curl);
@@ -147,7 +200,7 @@ char* http_download(const char* url, const char* output_filename) {
         curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 
         printf("Downloading %s...\n", output_filename);
-        res = curl_easy_perform(curl);
+        res = perform(curl);
         printf("\n"); // Saut de ligne après la barre
 
         fclose(fp);
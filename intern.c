@@ -0,0 +1,164 @@
+// intern.c - Table des symboles (chaînes internées) pour SwiftFlow
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "common.h"
+#include "intern.h"
+
+typedef struct {
+    char* name;
+    size_t len;
+    uint32_t hash;
+} Symbol;
+
+// Symboles indexés par leur identifiant (l'entrée 0 reste vide)
+static ISOLATE Symbol* symbols = NULL;
+static ISOLATE int symbol_count = 1;
+static ISOLATE int symbol_cap = 0;
+
+// Table de hachage à adressage ouvert : slot -> identifiant (0 = vide)
+static ISOLATE int* sym_table = NULL;
+static ISOLATE size_t sym_table_size = 0;
+
+// Cache des noms composés : (owner, member) -> identifiant
+typedef struct {
+    int owner;
+    int member;
+    int sym;
+} MemberEntry;
+
+static ISOLATE MemberEntry* member_table = NULL;
+static ISOLATE size_t member_table_size = 0;
+static ISOLATE size_t member_count = 0;
+
+static void out_of_memory(void) {
+    fprintf(stderr, "%s[FATAL]%s Out of memory (symbol table)\n", COLOR_RED, COLOR_RESET);
+    exit(1);
+}
+
+static uint32_t hash_bytes(const char* s, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)s[i];
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1; // même convention que rstr_hash
+}
+
+static void grow_table(void) {
+    size_t size = sym_table_size ? sym_table_size * 2 : 1024;
+    int* table = calloc(size, sizeof(int));
+    if (!table) out_of_memory();
+    for (int id = 1; id < symbol_count; id++) {
+        size_t slot = symbols[id].hash & (size - 1);
+        while (table[slot]) slot = (slot + 1) & (size - 1);
+        table[slot] = id;
+    }
+    free(sym_table);
+    sym_table = table;
+    sym_table_size = size;
+}
+
+int intern_hashed(const char* s, size_t len, uint32_t hash) {
+    if (!s) return 0;
+    // Facteur de charge <= 1/2
+    if ((size_t)symbol_count * 2 >= sym_table_size) grow_table();
+    
+    size_t slot = hash & (sym_table_size - 1);
+    while (sym_table[slot]) {
+        Symbol* sym = &symbols[sym_table[slot]];
+        if (sym->hash == hash && sym->len == len && memcmp(sym->name, s, len) == 0) {
+            return sym_table[slot];
+        }
+        slot = (slot + 1) & (sym_table_size - 1);
+    }
+    
+    if (symbol_count >= symbol_cap) {
+        int cap = symbol_cap ? symbol_cap * 2 : 1024;
+        Symbol* grown = realloc(symbols, cap * sizeof(Symbol));
+        if (!grown) out_of_memory();
+        symbols = grown;
+        symbol_cap = cap;
+    }
+    
+    int id = symbol_count++;
+    symbols[id].name = malloc(len + 1);
+    if (!symbols[id].name) out_of_memory();
+    memcpy(symbols[id].name, s, len);
+    symbols[id].name[len] = '\0';
+    symbols[id].len = len;
+    symbols[id].hash = hash;
+    sym_table[slot] = id;
+    return id;
+}
+
+int intern_len(const char* s, size_t len) {
+    if (!s) return 0;
+    return intern_hashed(s, len, hash_bytes(s, len));
+}
+
+int intern(const char* s) {
+    if (!s) return 0;
+    return intern_len(s, strlen(s));
+}
+
+const char* symbol_name(int sym) {
+    if (sym <= 0 || sym >= symbol_count) return "";
+    return symbols[sym].name;
+}
+
+static size_t member_slot(int owner, int member, size_t size) {
+    uint32_t h = (uint32_t)owner * 2654435761u ^ (uint32_t)member * 40503u;
+    return h & (size - 1);
+}
+
+int intern_member(int owner, int member) {
+    if (owner <= 0 || member <= 0) return 0;
+    
+    if (member_table_size) {
+        size_t slot = member_slot(owner, member, member_table_size);
+        while (member_table[slot].sym) {
+            if (member_table[slot].owner == owner && member_table[slot].member == member) {
+                return member_table[slot].sym;
+            }
+            slot = (slot + 1) & (member_table_size - 1);
+        }
+    }
+    
+    // Premier accès : construction du nom "<owner>_<member>"
+    size_t olen = symbols[owner].len;
+    size_t mlen = symbols[member].len;
+    char stack_buf[256];
+    char* name = olen + mlen + 2 <= sizeof(stack_buf) ? stack_buf : malloc(olen + mlen + 2);
+    if (!name) out_of_memory();
+    memcpy(name, symbols[owner].name, olen);
+    name[olen] = '_';
+    memcpy(name + olen + 1, symbols[member].name, mlen);
+    int sym = intern_len(name, olen + mlen + 1);
+    if (name != stack_buf) free(name);
+    
+    if ((member_count + 1) * 2 >= member_table_size) {
+        size_t size = member_table_size ? member_table_size * 2 : 1024;
+        MemberEntry* table = calloc(size, sizeof(MemberEntry));
+        if (!table) out_of_memory();
+        for (size_t i = 0; i < member_table_size; i++) {
+            if (!member_table[i].sym) continue;
+            size_t slot = member_slot(member_table[i].owner, member_table[i].member, size);
+            while (table[slot].sym) slot = (slot + 1) & (size - 1);
+            table[slot] = member_table[i];
+        }
+        free(member_table);
+        member_table = table;
+        member_table_size = size;
+    }
+    
+    size_t slot = member_slot(owner, member, member_table_size);
+    while (member_table[slot].sym) slot = (slot + 1) & (member_table_size - 1);
+    member_table[slot].owner = owner;
+    member_table[slot].member = member;
+    member_table[slot].sym = sym;
+    member_count++;
+    return sym;
+}
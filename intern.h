@@ -0,0 +1,27 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// TABLE DES SYMBOLES (chaînes internées)
+// Chaque nom (identifiant, propriété, classe, méthode) reçoit un
+// identifiant entier unique : comparer deux noms revient à comparer
+// deux entiers. Le symbole 0 signifie "aucun".
+// Partagée par le lexer, le parser et l'interpréteur.
+// ============================================================
+
+int intern(const char* s);
+int intern_len(const char* s, size_t len);
+
+// Variante avec un hash FNV-1a déjà calculé (rstr_hash)
+int intern_hashed(const char* s, size_t len, uint32_t hash);
+
+// Symbole du nom composé "<owner>_<member>" (propriété d'instance,
+// méthode de classe), mis en cache : pas de snprintf après le premier appel
+int intern_member(int owner, int member);
+
+const char* symbol_name(int sym);
+
+#endif
@@ -1,4 +1,5 @@
 // io.c - Module IO autonome pour SwiftFlow
+#define _GNU_SOURCE // copy_file_range
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,7 +10,17 @@
 #include <errno.h>
 #include <limits.h>
 #include <time.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>      // FICLONE
+#include <sys/sendfile.h>
+#endif
 #include "common.h"
+#include "io.h"
 
 // ======================================================
 // [SECTION] GESTION DES DESCRIPTEURS DE FICHIER
@@ -23,16 +34,18 @@ typedef struct {
     long position;
     long size;
     time_t last_access;
+    char* buffer;        // Buffer utilisateur (setvbuf) des writers, libéré à la fermeture
 } FileDescriptor;
 
-static FileDescriptor file_descriptors[256];
-static int fd_count = 0;
+#define IO_MAX_FDS 256
+static ISOLATE FileDescriptor* file_descriptors = NULL; // IO_MAX_FDS, alloué par init_io_module
+static ISOLATE int fd_count = 0;
 
 // ======================================================
 // [SECTION] FONCTIONS UTILITAIRES
 // ======================================================
 static int allocate_fd() {
-    for (int i = 3; i < 256; i++) {
+    for (int i = 3; i < IO_MAX_FDS; i++) {
         if (!file_descriptors[i].is_open) {
             file_descriptors[i].id = i;
             file_descriptors[i].is_open = true;
@@ -44,7 +57,7 @@ static int allocate_fd() {
 }
 
 static FileDescriptor* get_fd(int fd) {
-    if (fd < 0 || fd >= 256 || !file_descriptors[fd].is_open) {
+    if (fd < 0 || fd >= IO_MAX_FDS || !file_descriptors[fd].is_open) {
         return NULL;
     }
     return &file_descriptors[fd];
@@ -54,6 +67,7 @@ static void close_fd(int fd) {
     FileDescriptor* desc = get_fd(fd);
     if (desc) {
         if (desc->handle) fclose(desc->handle);
+        if (desc->buffer) free(desc->buffer); // Après fclose : stdio vide le buffer en fermant
         if (desc->name) free(desc->name);
         if (desc->mode) free(desc->mode);
         
@@ -185,7 +199,7 @@ void io_open(ASTNode* node) {
     
     int fd = allocate_fd();
     if (fd == -1) {
-        printf("%s[IO ERROR]%s Too many open files (max 256)\n", COLOR_RED, COLOR_RESET);
+        printf("%s[IO ERROR]%s Too many open files (max %d)\n", COLOR_RED, COLOR_RESET, IO_MAX_FDS);
         fclose(f);
         free(filename);
         free(mode);
@@ -876,6 +890,143 @@ void io_rename(ASTNode* node) {
     free(newname);
 }
 
+// Copie noyau : reflink (FICLONE), puis copy_file_range, puis sendfile,
+// la boucle read/write ne sert qu'en dernier recours.
+// Chaque étape reprend à la position courante des descripteurs.
+#define IO_COPY_BUFFER (256 * 1024)
+
+static bool copy_unsupported(int err) {
+    return err == EXDEV || err == EINVAL || err == ENOSYS || err == EOPNOTSUPP ||
+           err == EBADF || err == ETXTBSY || err == EPERM;
+}
+
+long long io_copy_file(const char* srcname, const char* dstname, bool preserve) {
+    if (!srcname || !dstname) {
+        printf("%s[IO ERROR]%s Missing source or destination filename\n", COLOR_RED, COLOR_RESET);
+        return -1;
+    }
+    
+    // Les buffers en attente sur l'un des deux chemins doivent atteindre le disque
+    io_sync_path(srcname);
+    io_sync_path(dstname);
+    
+    int in = open(srcname, O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        printf("%s[IO ERROR]%s Cannot open source file: %s (%s)\n", 
+               COLOR_RED, COLOR_RESET, srcname, strerror(errno));
+        return -1;
+    }
+    
+    struct stat st;
+    if (fstat(in, &st) != 0 || S_ISDIR(st.st_mode)) {
+        printf("%s[IO ERROR]%s Source is not a regular file: %s\n", 
+               COLOR_RED, COLOR_RESET, srcname);
+        close(in);
+        return -1;
+    }
+    
+    int out = open(dstname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777);
+    if (out < 0) {
+        printf("%s[IO ERROR]%s Cannot open destination file: %s (%s)\n", 
+               COLOR_RED, COLOR_RESET, dstname, strerror(errno));
+        close(in);
+        return -1;
+    }
+    
+    long long total = 0;
+    bool done = false;
+    bool failed = false;
+    
+#ifdef __linux__
+    // Les fichiers spéciaux (/proc, pipes) annoncent souvent une taille nulle :
+    // seule la boucle utilisateur sait les lire correctement.
+    bool kernel_copy = S_ISREG(st.st_mode) && st.st_size > 0;
+    
+#ifdef FICLONE
+    if (kernel_copy && ioctl(out, FICLONE, in) == 0) {
+        total = st.st_size;
+        done = true;
+    }
+#endif
+    
+    if (kernel_copy && !done) {
+        for (;;) {
+            ssize_t n = copy_file_range(in, NULL, out, NULL, 1 << 30, 0);
+            if (n > 0) { total += n; continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && !copy_unsupported(errno)) {
+                printf("%s[IO ERROR]%s Copy failed: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+                failed = true;
+            }
+            break;
+        }
+    }
+    
+    if (kernel_copy && !done && !failed) {
+        for (;;) {
+            ssize_t n = sendfile(out, in, NULL, 1 << 30);
+            if (n > 0) { total += n; continue; }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && !copy_unsupported(errno)) {
+                printf("%s[IO ERROR]%s Copy failed: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+                failed = true;
+            }
+            break;
+        }
+    }
+#endif
+    
+    // Boucle utilisateur : termine ce que les étapes noyau n'ont pas copié
+    // (un seul read() vide si elles ont tout fait)
+    if (!done && !failed) {
+        char* buffer = malloc(IO_COPY_BUFFER);
+        if (!buffer) {
+            printf("%s[IO ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+            failed = true;
+        }
+        while (buffer && !failed) {
+            ssize_t n = read(in, buffer, IO_COPY_BUFFER);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                printf("%s[IO ERROR]%s Read error during copy: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+                failed = true;
+                break;
+            }
+            if (n == 0) break;
+            
+            ssize_t off = 0;
+            while (off < n) {
+                ssize_t w = write(out, buffer + off, n - off);
+                if (w < 0 && errno == EINTR) continue;
+                if (w < 0) {
+                    printf("%s[IO ERROR]%s Write error during copy: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+                    failed = true;
+                    break;
+                }
+                off += w;
+            }
+            total += off;
+        }
+        free(buffer);
+    }
+    
+    if (!failed && preserve) {
+        struct timespec times[2] = { st.st_atim, st.st_mtim };
+        if (fchmod(out, st.st_mode & 07777) != 0 || futimens(out, times) != 0) {
+            printf("%s[IO WARNING]%s Cannot preserve attributes on %s (%s)\n", 
+                   COLOR_YELLOW, COLOR_RESET, dstname, strerror(errno));
+        }
+    }
+    
+    close(in);
+    if (close(out) != 0 && !failed) {
+        printf("%s[IO ERROR]%s Write error during copy: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+        failed = true;
+    }
+    
+    return failed ? -1 : total;
+}
+
 void io_copy(ASTNode* node) {
     if (!node || !node->left || !node->right) {
         printf("%s[IO ERROR]%s Missing source or destination filename\n", COLOR_RED, COLOR_RESET);
@@ -885,83 +1036,671 @@ void io_copy(ASTNode* node) {
     char* srcname = extract_string(node->left);
     char* dstname = extract_string(node->right);
     
-    if (!srcname || !dstname) {
-        if (srcname) free(srcname);
-        if (dstname) free(dstname);
-        return;
+    io_copy_file(srcname, dstname, false);
+    
+    if (srcname) free(srcname);
+    if (dstname) free(dstname);
+}
+
+// ======================================================
+// [SECTION] WRITERS BUFFERISÉS
+// ======================================================
+// Un writer est une entrée de file_descriptors dont le FILE* utilise un gros
+// buffer utilisateur (setvbuf) : les io.write() s'accumulent en mémoire et ne
+// font un appel système que lorsque le buffer est plein ou sur io.flush/io.close.
+#define IO_WRITER_DEFAULT_BUFFER (64 * 1024)
+#define IO_WRITER_MAX_BUFFER     (256 * 1024 * 1024)
+#define IO_APPEND_CACHE_SIZE     32
+
+static int open_buffered(const char* path, const char* mode, size_t buffer_size) {
+    FILE* f = fopen(path, mode);
+    if (!f) {
+        printf("%s[IO ERROR]%s Cannot open file: %s (%s)\n", 
+               COLOR_RED, COLOR_RESET, path, strerror(errno));
+        return -1;
     }
     
-    // Vérifier si la source existe
-    if (access(srcname, F_OK) != 0) {
-        printf("%s[IO ERROR]%s Source file does not exist: %s\n", 
-               COLOR_RED, COLOR_RESET, srcname);
-        free(srcname);
-        free(dstname);
-        return;
+    int fd = allocate_fd();
+    if (fd == -1) {
+        printf("%s[IO ERROR]%s Too many open files (max %d)\n", COLOR_RED, COLOR_RESET, IO_MAX_FDS);
+        fclose(f);
+        return -1;
     }
     
-    // Vérifier que la source est un fichier
-    struct stat st;
-    if (stat(srcname, &st) != 0 || S_ISDIR(st.st_mode)) {
-        printf("%s[IO ERROR]%s Source is not a regular file: %s\n", 
-               COLOR_RED, COLOR_RESET, srcname);
-        free(srcname);
-        free(dstname);
-        return;
+    if (buffer_size == 0) buffer_size = IO_WRITER_DEFAULT_BUFFER;
+    if (buffer_size > IO_WRITER_MAX_BUFFER) buffer_size = IO_WRITER_MAX_BUFFER;
+    
+    FileDescriptor* desc = &file_descriptors[fd];
+    desc->buffer = malloc(buffer_size);
+    if (desc->buffer) setvbuf(f, desc->buffer, _IOFBF, buffer_size);
+    
+    desc->name = str_copy(path);
+    desc->handle = f;
+    desc->mode = str_copy(mode);
+    desc->position = ftell(f);
+    desc->size = desc->position;
+    desc->last_access = time(NULL);
+    return fd;
+}
+
+// Cache des handles ouverts par append(path, data) : un handle par chemin,
+// gardé ouvert jusqu'à la sortie de la portée (fonction) qui l'a ouvert.
+typedef struct {
+    int fd;
+    int scope_level;
+} AppendCacheEntry;
+
+static ISOLATE AppendCacheEntry append_cache[IO_APPEND_CACHE_SIZE];
+static ISOLATE int append_cache_count = 0;
+
+static int find_cached_append(const char* path) {
+    for (int i = 0; i < append_cache_count; i++) {
+        FileDescriptor* desc = get_fd(append_cache[i].fd);
+        if (desc && desc->name && strcmp(desc->name, path) == 0) return i;
+    }
+    return -1;
+}
+
+static void drop_cached_append(int slot) {
+    close_fd(append_cache[slot].fd);
+    append_cache[slot] = append_cache[--append_cache_count];
+}
+
+int io_writer_open(const char* path, size_t buffer_size, bool append) {
+    if (!path) return -1;
+    io_sync_path(path);
+    return open_buffered(path, append ? "a" : "w", buffer_size);
+}
+
+long io_write_fd(int fd, const char* data, size_t len) {
+    FileDescriptor* desc = get_fd(fd);
+    if (!desc || !desc->handle) {
+        printf("%s[IO ERROR]%s Invalid file descriptor: %d\n", COLOR_RED, COLOR_RESET, fd);
+        return -1;
     }
     
-    // Ouvrir la source
-    FILE* src = fopen(srcname, "rb");
-    if (!src) {
-        printf("%s[IO ERROR]%s Cannot open source file: %s (%s)\n", 
-               COLOR_RED, COLOR_RESET, srcname, strerror(errno));
-        free(srcname);
-        free(dstname);
-        return;
+    size_t written = fwrite(data, 1, len, desc->handle);
+    desc->position += (long)written;
+    if (desc->position > desc->size) desc->size = desc->position;
+    
+    if (written != len) {
+        printf("%s[IO ERROR]%s Write failed on fd=%d: %s\n", 
+               COLOR_RED, COLOR_RESET, fd, strerror(errno));
+        return -1;
     }
+    return (long)written;
+}
+
+int io_flush_fd(int fd) {
+    FileDescriptor* desc = get_fd(fd);
+    if (!desc || !desc->handle) {
+        printf("%s[IO ERROR]%s Invalid file descriptor: %d\n", COLOR_RED, COLOR_RESET, fd);
+        return -1;
+    }
+    update_fd_access(fd);
+    return fflush(desc->handle);
+}
+
+int io_close_fd(int fd) {
+    if (fd < 3 || !get_fd(fd)) {
+        printf("%s[IO ERROR]%s Invalid file descriptor: %d\n", COLOR_RED, COLOR_RESET, fd);
+        return -1;
+    }
+    close_fd(fd);
+    return 0;
+}
+
+bool io_append_cached(const char* path, const char* data, size_t len, int scope_level) {
+    if (!path || !data) return false;
     
-    // Ouvrir la destination
-    FILE* dst = fopen(dstname, "wb");
-    if (!dst) {
-        printf("%s[IO ERROR]%s Cannot open destination file: %s (%s)\n", 
-               COLOR_RED, COLOR_RESET, dstname, strerror(errno));
-        fclose(src);
-        free(srcname);
-        free(dstname);
-        return;
+    int slot = find_cached_append(path);
+    if (slot < 0) {
+        // Cache plein : on évince l'entrée la plus ancienne
+        if (append_cache_count >= IO_APPEND_CACHE_SIZE) drop_cached_append(0);
+        
+        int fd = open_buffered(path, "a", IO_WRITER_DEFAULT_BUFFER);
+        if (fd < 0) return false;
+        
+        slot = append_cache_count++;
+        append_cache[slot].fd = fd;
+        append_cache[slot].scope_level = scope_level;
     }
+    return io_write_fd(append_cache[slot].fd, data, len) >= 0;
+}
+
+void io_release_appends(int scope_level) {
+    for (int i = append_cache_count - 1; i >= 0; i--) {
+        if (append_cache[i].scope_level >= scope_level) drop_cached_append(i);
+    }
+}
+
+void io_sync_path(const char* path) {
+    if (!path) return;
+    int slot = find_cached_append(path);
+    if (slot >= 0) drop_cached_append(slot);
+    
+    // Les writers explicites sur le même chemin sont vidés (pas fermés)
+    for (int i = 3; i < IO_MAX_FDS; i++) {
+        FileDescriptor* desc = &file_descriptors[i];
+        if (desc->is_open && desc->buffer && desc->name && strcmp(desc->name, path) == 0) {
+            fflush(desc->handle);
+        }
+    }
+}
+
+// ======================================================
+// [SECTION] ITÉRATEURS DE LIGNES / BLOCS
+// ======================================================
+// Lecture en flux avec un buffer réutilisé : seule la ligne (ou le bloc)
+// courante est en mémoire, quelle que soit la taille du fichier.
+#define IO_ITER_DEFAULT_BUFFER (64 * 1024)
+#define IO_ITER_MAX_CHUNK      (256 * 1024 * 1024)
+#define IO_MAX_ITERATORS       32
+
+typedef struct {
+    bool in_use;
+    int fd;            // descripteur système (open(2))
+    char* buffer;
+    size_t capacity;   // toujours >= données + 1 (terminateur)
+    size_t start;      // début des données non consommées
+    size_t end;        // fin des données lues
+    size_t chunk_size; // 0 = mode lignes
+    bool eof;
+} IoIterator;
+
+static ISOLATE IoIterator iterators[IO_MAX_ITERATORS];
+
+static int open_iterator(const char* path, size_t capacity, size_t chunk_size) {
+    if (!path) return -1;
+    io_sync_path(path);
     
-    // Copier le contenu
-    char buffer[8192];
-    size_t bytes_read, total_bytes = 0;
+    int slot = -1;
+    for (int i = 0; i < IO_MAX_ITERATORS; i++) {
+        if (!iterators[i].in_use) { slot = i; break; }
+    }
+    if (slot < 0) {
+        printf("%s[IO ERROR]%s Too many open iterators\n", COLOR_RED, COLOR_RESET);
+        return -1;
+    }
     
-    while ((bytes_read = fread(buffer, 1, sizeof(buffer), src)) > 0) {
-        size_t bytes_written = fwrite(buffer, 1, bytes_read, dst);
-        if (bytes_written != bytes_read) {
-            printf("%s[IO ERROR]%s Write error during copy\n", COLOR_RED, COLOR_RESET);
-            fclose(src);
-            fclose(dst);
-            free(srcname);
-            free(dstname);
-            return;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("%s[IO ERROR]%s Cannot open file: %s (%s)\n", COLOR_RED, COLOR_RESET, path, strerror(errno));
+        return -1;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    
+    char* buffer = malloc(capacity);
+    if (!buffer) {
+        printf("%s[IO ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+        close(fd);
+        return -1;
+    }
+    
+    IoIterator* it = &iterators[slot];
+    it->in_use = true;
+    it->fd = fd;
+    it->buffer = buffer;
+    it->capacity = capacity;
+    it->start = 0;
+    it->end = 0;
+    it->chunk_size = chunk_size;
+    it->eof = false;
+    return slot;
+}
+
+static IoIterator* get_iterator(int it) {
+    if (it < 0 || it >= IO_MAX_ITERATORS || !iterators[it].in_use) return NULL;
+    return &iterators[it];
+}
+
+// Complète le buffer après les données courantes ; false si plus rien à lire
+static bool fill_iterator(IoIterator* it) {
+    if (it->eof) return false;
+    
+    // Compacter : les octets déjà consommés sont réutilisés
+    if (it->start > 0) {
+        memmove(it->buffer, it->buffer + it->start, it->end - it->start);
+        it->end -= it->start;
+        it->start = 0;
+    }
+    // Ligne plus longue que le buffer : on l'agrandit
+    if (it->end + 1 >= it->capacity) {
+        char* grown = realloc(it->buffer, it->capacity * 2);
+        if (!grown) {
+            printf("%s[IO ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+            it->eof = true;
+            return false;
+        }
+        it->buffer = grown;
+        it->capacity *= 2;
+    }
+    
+    ssize_t n;
+    do {
+        n = read(it->fd, it->buffer + it->end, it->capacity - 1 - it->end);
+    } while (n < 0 && errno == EINTR);
+    
+    if (n <= 0) {
+        if (n < 0) printf("%s[IO ERROR]%s Read failed: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+        it->eof = true;
+        return false;
+    }
+    it->end += (size_t)n;
+    return true;
+}
+
+int io_lines_open(const char* path) {
+    return open_iterator(path, IO_ITER_DEFAULT_BUFFER, 0);
+}
+
+int io_chunks_open(const char* path, size_t chunk_size) {
+    if (chunk_size == 0 || chunk_size > IO_ITER_MAX_CHUNK) {
+        printf("%s[IO ERROR]%s Invalid chunk size: %zu\n", COLOR_RED, COLOR_RESET, chunk_size);
+        return -1;
+    }
+    return open_iterator(path, chunk_size + 1, chunk_size);
+}
+
+const char* io_iter_next(int handle, size_t* len) {
+    IoIterator* it = get_iterator(handle);
+    if (!it) return NULL;
+    
+    if (it->chunk_size > 0) {
+        // Mode blocs : le bloc précédent est entièrement consommé, on repart du début
+        it->start = 0;
+        it->end = 0;
+        while (it->end < it->chunk_size && fill_iterator(it)) {}
+        if (it->end == 0) return NULL;
+        it->buffer[it->end] = '\0'; // capacity = chunk_size + 1
+        if (len) *len = it->end;
+        return it->buffer;
+    }
+    
+    // Mode lignes : recherche du '\n' avec memchr, le buffer n'est relu qu'au besoin
+    size_t scanned = 0;
+    for (;;) {
+        char* base = it->buffer + it->start;
+        size_t avail = it->end - it->start;
+        char* nl = memchr(base + scanned, '\n', avail - scanned);
+        if (nl) {
+            size_t n = (size_t)(nl - base);
+            it->start += n + 1;
+            if (n > 0 && base[n - 1] == '\r') n--; // CRLF
+            base[n] = '\0';
+            if (len) *len = n;
+            return base;
+        }
+        scanned = avail; // Reste valable après compactage (relatif à start)
+        if (!fill_iterator(it)) break;
+    }
+    
+    // Dernière ligne sans '\n' final
+    size_t avail = it->end - it->start;
+    if (avail == 0) return NULL;
+    char* base = it->buffer + it->start;
+    base[avail] = '\0';
+    it->start = it->end;
+    if (len) *len = avail;
+    return base;
+}
+
+void io_iter_close(int handle) {
+    IoIterator* it = get_iterator(handle);
+    if (!it) return;
+    close(it->fd);
+    free(it->buffer);
+    memset(it, 0, sizeof(*it));
+}
+
+// ======================================================
+// [SECTION] PARCOURS RÉCURSIF PARALLÈLE (io.walk)
+// ======================================================
+// Des threads se partagent une pile de répertoires à visiter et publient
+// les entrées dans une file bornée que le thread de l'interpréteur consomme
+// (for e in io.walk(...)). L'ordre des entrées n'est donc pas garanti.
+// Le type vient de d_type ; fstatat() relatif au répertoire ouvert ne sert
+// que pour la taille/date (ou si d_type est inconnu).
+#define IO_WALK_QUEUE_SIZE 4096
+#define IO_WALK_MAX_THREADS 64
+#define IO_WALK_SEEN_INITIAL 1024
+
+typedef struct {
+    dev_t dev;
+    ino_t ino;
+} WalkDirId;
+
+typedef struct {
+    // Options
+    bool follow_links;
+    bool want_stat;
+    char* filter; // motif fnmatch sur le nom, NULL = tout
+    
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;   // répertoires disponibles / fin
+    pthread_cond_t not_full;    // place dans la file d'entrées
+    pthread_cond_t not_empty;   // entrées disponibles / fin
+    
+    // Pile de répertoires à visiter
+    char** dirs;
+    int dir_count;
+    int dir_capacity;
+    int pending;   // répertoires empilés ou en cours de lecture
+    
+    // File circulaire d'entrées produites
+    IoWalkEntry queue[IO_WALK_QUEUE_SIZE];
+    int head;
+    int count;
+    
+    // Répertoires déjà visités (suivi des liens : évite les cycles)
+    WalkDirId* seen;
+    int seen_count;
+    int seen_capacity;
+    
+    pthread_t threads[IO_WALK_MAX_THREADS];
+    int thread_count;
+    int running;
+    bool cancelled;
+} IoWalker;
+
+static ISOLATE IoWalker* walkers[IO_MAX_ITERATORS];
+
+static size_t walk_dir_hash(dev_t dev, ino_t ino) {
+    uint64_t h = ((uint64_t)dev * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)ino;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return (size_t)h;
+}
+
+// Appelé avec le verrou : true si le répertoire n'a pas encore été visité.
+// Table à adressage ouvert (ino 0 = case libre), agrandie à 50% de remplissage.
+static bool walk_mark_seen(IoWalker* w, dev_t dev, ino_t ino) {
+    if ((w->seen_count + 1) * 2 > w->seen_capacity) {
+        int cap = w->seen_capacity ? w->seen_capacity * 2 : IO_WALK_SEEN_INITIAL;
+        WalkDirId* table = calloc(cap, sizeof(WalkDirId));
+        if (!table) return false;
+        for (int i = 0; i < w->seen_capacity; i++) {
+            if (w->seen[i].ino == 0) continue;
+            size_t j = walk_dir_hash(w->seen[i].dev, w->seen[i].ino) & (cap - 1);
+            while (table[j].ino != 0) j = (j + 1) & (cap - 1);
+            table[j] = w->seen[i];
+        }
+        free(w->seen);
+        w->seen = table;
+        w->seen_capacity = cap;
+    }
+    
+    size_t mask = w->seen_capacity - 1;
+    size_t i = walk_dir_hash(dev, ino) & mask;
+    while (w->seen[i].ino != 0) {
+        if (w->seen[i].dev == dev && w->seen[i].ino == ino) return false;
+        i = (i + 1) & mask;
+    }
+    w->seen[i].dev = dev;
+    w->seen[i].ino = ino;
+    w->seen_count++;
+    return true;
+}
+
+// Appelé avec le verrou
+static void walk_push_dir(IoWalker* w, char* path) {
+    if (w->dir_count >= w->dir_capacity) {
+        int cap = w->dir_capacity ? w->dir_capacity * 2 : 64;
+        char** grown = realloc(w->dirs, cap * sizeof(char*));
+        if (!grown) { free(path); return; }
+        w->dirs = grown;
+        w->dir_capacity = cap;
+    }
+    w->dirs[w->dir_count++] = path;
+    w->pending++;
+    pthread_cond_signal(&w->work_cond);
+}
+
+// Publie une entrée ; false si le parcours a été annulé
+static bool walk_emit(IoWalker* w, IoWalkEntry* entry) {
+    pthread_mutex_lock(&w->lock);
+    while (w->count == IO_WALK_QUEUE_SIZE && !w->cancelled) {
+        pthread_cond_wait(&w->not_full, &w->lock);
+    }
+    if (w->cancelled) {
+        pthread_mutex_unlock(&w->lock);
+        free(entry->path);
+        return false;
+    }
+    w->queue[(w->head + w->count) % IO_WALK_QUEUE_SIZE] = *entry;
+    w->count++;
+    pthread_cond_signal(&w->not_empty);
+    pthread_mutex_unlock(&w->lock);
+    return true;
+}
+
+static const char* walk_type_name(mode_t mode) {
+    if (S_ISREG(mode)) return "file";
+    if (S_ISDIR(mode)) return "dir";
+    if (S_ISLNK(mode)) return "link";
+    return "other";
+}
+
+static const char* walk_dtype_name(unsigned char d_type) {
+    switch (d_type) {
+        case DT_REG: return "file";
+        case DT_DIR: return "dir";
+        case DT_LNK: return "link";
+        default: return "other";
+    }
+}
+
+static void walk_read_dir(IoWalker* w, const char* dirpath) {
+    DIR* dir = opendir(dirpath);
+    if (!dir) return; // Répertoire illisible : ignoré comme find(1) le signalerait
+    int dfd = dirfd(dir);
+    size_t dirlen = strlen(dirpath);
+    bool needs_sep = dirlen > 0 && dirpath[dirlen - 1] != '/';
+    
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) {
+        const char* name = ent->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+        
+        bool is_dir = ent->d_type == DT_DIR;
+        const char* type = walk_dtype_name(ent->d_type);
+        struct stat st;
+        bool have_stat = false;
+        
+        // stat seulement si nécessaire : taille/date demandées, type inconnu,
+        // ou liens suivis (il faut alors l'inode des répertoires contre les cycles)
+        if (w->want_stat || ent->d_type == DT_UNKNOWN ||
+            (w->follow_links && (ent->d_type == DT_LNK || ent->d_type == DT_DIR))) {
+            int flags = w->follow_links ? 0 : AT_SYMLINK_NOFOLLOW;
+            if (fstatat(dfd, name, &st, flags) == 0) {
+                have_stat = true;
+                is_dir = S_ISDIR(st.st_mode);
+                type = walk_type_name(st.st_mode);
+            }
+        }
+        
+        size_t namelen = strlen(name);
+        char* path = malloc(dirlen + namelen + 2);
+        if (!path) continue;
+        memcpy(path, dirpath, dirlen);
+        size_t pos = dirlen;
+        if (needs_sep) path[pos++] = '/';
+        memcpy(path + pos, name, namelen + 1);
+        
+        if (is_dir) {
+            pthread_mutex_lock(&w->lock);
+            bool visit = !w->cancelled;
+            if (visit && w->follow_links && have_stat) visit = walk_mark_seen(w, st.st_dev, st.st_ino);
+            if (visit) walk_push_dir(w, str_copy(path));
+            pthread_mutex_unlock(&w->lock);
+        }
+        
+        if (w->filter && fnmatch(w->filter, name, 0) != 0) {
+            free(path);
+            continue;
+        }
+        
+        IoWalkEntry entry;
+        entry.path = path;
+        entry.type = type;
+        entry.size = have_stat ? (long long)st.st_size : -1;
+        entry.mtime = have_stat ? (double)st.st_mtim.tv_sec + st.st_mtim.tv_nsec / 1e9 : -1;
+        if (!walk_emit(w, &entry)) break;
+    }
+    closedir(dir);
+}
+
+static void* walk_worker(void* arg) {
+    IoWalker* w = arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->dir_count == 0 && w->pending > 0 && !w->cancelled) {
+            pthread_cond_wait(&w->work_cond, &w->lock);
         }
-        total_bytes += bytes_written;
+        if (w->cancelled || w->dir_count == 0) break; // pending == 0 : parcours terminé
+        
+        char* dirpath = w->dirs[--w->dir_count];
+        pthread_mutex_unlock(&w->lock);
+        
+        walk_read_dir(w, dirpath);
+        free(dirpath);
+        
+        pthread_mutex_lock(&w->lock);
+        if (--w->pending == 0) pthread_cond_broadcast(&w->work_cond);
+    }
+    if (--w->running == 0) pthread_cond_broadcast(&w->not_empty);
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+int io_walk_open(const char* root, int parallel, bool follow_links, const char* filter, bool want_stat) {
+    if (!root) return -1;
+    
+    struct stat st;
+    if (stat(root, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        printf("%s[IO ERROR]%s Not a directory: %s\n", COLOR_RED, COLOR_RESET, root);
+        return -1;
     }
     
-    fclose(src);
-    fclose(dst);
+    int slot = -1;
+    for (int i = 0; i < IO_MAX_ITERATORS; i++) {
+        if (!walkers[i]) { slot = i; break; }
+    }
+    if (slot < 0) {
+        printf("%s[IO ERROR]%s Too many open iterators\n", COLOR_RED, COLOR_RESET);
+        return -1;
+    }
     
-    printf("%s[IO]%s File copied: %s -> %s (%zu bytes)\n", 
-           COLOR_GREEN, COLOR_RESET, srcname, dstname, total_bytes);
+    IoWalker* w = calloc(1, sizeof(IoWalker));
+    if (!w) {
+        printf("%s[IO ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+        return -1;
+    }
     
-    free(srcname);
-    free(dstname);
+    if (parallel <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        parallel = cpus > 0 ? (int)cpus : 1;
+    }
+    if (parallel > IO_WALK_MAX_THREADS) parallel = IO_WALK_MAX_THREADS;
+    
+    w->follow_links = follow_links;
+    w->want_stat = want_stat;
+    w->filter = (filter && filter[0]) ? str_copy(filter) : NULL;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->work_cond, NULL);
+    pthread_cond_init(&w->not_full, NULL);
+    pthread_cond_init(&w->not_empty, NULL);
+    
+    walk_mark_seen(w, st.st_dev, st.st_ino);
+    walk_push_dir(w, str_copy(root));
+    
+    // 'running' est fixé avant le démarrage : un thread rapide peut finir
+    // le parcours avant que les suivants soient créés
+    w->running = parallel;
+    for (int i = 0; i < parallel; i++) {
+        if (pthread_create(&w->threads[w->thread_count], NULL, walk_worker, w) != 0) break;
+        w->thread_count++;
+    }
+    if (w->thread_count < parallel) {
+        pthread_mutex_lock(&w->lock);
+        w->running -= parallel - w->thread_count;
+        if (w->running == 0) pthread_cond_broadcast(&w->not_empty);
+        pthread_mutex_unlock(&w->lock);
+    }
+    if (w->thread_count == 0) {
+        printf("%s[IO ERROR]%s Cannot start walker threads\n", COLOR_RED, COLOR_RESET);
+        walkers[slot] = w;
+        io_walk_close(slot);
+        return -1;
+    }
+    
+    walkers[slot] = w;
+    return slot;
+}
+
+bool io_walk_next(int handle, IoWalkEntry* out) {
+    if (handle < 0 || handle >= IO_MAX_ITERATORS || !walkers[handle]) return false;
+    IoWalker* w = walkers[handle];
+    
+    pthread_mutex_lock(&w->lock);
+    while (w->count == 0 && w->running > 0) {
+        pthread_cond_wait(&w->not_empty, &w->lock);
+    }
+    if (w->count == 0) {
+        pthread_mutex_unlock(&w->lock);
+        return false;
+    }
+    *out = w->queue[w->head];
+    w->head = (w->head + 1) % IO_WALK_QUEUE_SIZE;
+    w->count--;
+    pthread_cond_signal(&w->not_full);
+    pthread_mutex_unlock(&w->lock);
+    return true;
+}
+
+void io_walk_close(int handle) {
+    if (handle < 0 || handle >= IO_MAX_ITERATORS || !walkers[handle]) return;
+    IoWalker* w = walkers[handle];
+    
+    // Arrêt anticipé (break/return dans la boucle) : réveiller tout le monde
+    pthread_mutex_lock(&w->lock);
+    w->cancelled = true;
+    pthread_cond_broadcast(&w->work_cond);
+    pthread_cond_broadcast(&w->not_full);
+    pthread_mutex_unlock(&w->lock);
+    
+    for (int i = 0; i < w->thread_count; i++) pthread_join(w->threads[i], NULL);
+    
+    while (w->count > 0) {
+        free(w->queue[w->head].path);
+        w->head = (w->head + 1) % IO_WALK_QUEUE_SIZE;
+        w->count--;
+    }
+    for (int i = 0; i < w->dir_count; i++) free(w->dirs[i]);
+    free(w->dirs);
+    free(w->seen);
+    free(w->filter);
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->work_cond);
+    pthread_cond_destroy(&w->not_full);
+    pthread_cond_destroy(&w->not_empty);
+    free(w);
+    walkers[handle] = NULL;
 }
 
 // ======================================================
 // [SECTION] FONCTION D'INITIALISATION
 // ======================================================
 void init_io_module() {
+    // Table allouée par l'isolat qui exécute du script, pas en TLS statique :
+    // les threads d'io.walk et d'aio n'en ont pas besoin
+    if (!file_descriptors) {
+        file_descriptors = calloc(IO_MAX_FDS, sizeof(FileDescriptor));
+        if (!file_descriptors) { fprintf(stderr, "%s[FATAL]%s Out of memory (io)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
         
     // Initialiser stdin, stdout, stderr
     file_descriptors[0].id = 0;
@@ -1005,6 +1744,7 @@ bool io_exists_bool(const char* path) {
 // Lit tout le contenu d'un fichier et le retourne sous forme de string
 char* io_read_string(const char* path) {
     if (!path) return NULL;
+    io_sync_path(path); // Voir les données encore dans un buffer d'append/writer
     
     FILE* f = fopen(path, "rb"); // "rb" pour lire aussi les fichiers binaires/images
     if (!f) return NULL;
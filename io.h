@@ -45,5 +45,64 @@ bool io_exists_bool(const char* path);
 // Lit un fichier et retourne son contenu (ou NULL)
 char* io_read_string(const char* path);
 
+// ============================================================
+// WRITERS BUFFERISÉS ET CACHE D'APPEND
+// Arguments déjà évalués par swf.c (types primitifs)
+// ============================================================
+
+// Ouvre un writer avec un buffer utilisateur de buffer_size octets (0 = défaut)
+int io_writer_open(const char* path, size_t buffer_size, bool append);
+
+// Écriture / flush / fermeture sur un descripteur (writer ou io.open)
+long io_write_fd(int fd, const char* data, size_t len);
+int io_flush_fd(int fd);
+int io_close_fd(int fd);
+
+// append(path, data) : réutilise un handle ouvert par chemin
+bool io_append_cached(const char* path, const char* data, size_t len, int scope_level);
+
+// Ferme les handles d'append ouverts à une portée >= scope_level
+void io_release_appends(int scope_level);
+
+// Vide/ferme les buffers en attente sur path avant un accès direct au fichier
+void io_sync_path(const char* path);
+
+// Copie path -> path (reflink / copy_file_range / sendfile / read-write)
+// preserve : conserve mode et dates. Retourne le nombre d'octets copiés ou -1.
+long long io_copy_file(const char* src, const char* dst, bool preserve);
+
+// ============================================================
+// ITÉRATEURS DE LIGNES / BLOCS (for x in io.lines(path))
+// ============================================================
+
+// Ouvre un itérateur ; retourne un handle >= 0 ou -1
+int io_lines_open(const char* path);
+int io_chunks_open(const char* path, size_t chunk_size);
+
+// Élément suivant (pointe dans le buffer interne, valide jusqu'au prochain appel) ou NULL
+const char* io_iter_next(int handle, size_t* len);
+
+void io_iter_close(int handle);
+
+// ============================================================
+// PARCOURS RÉCURSIF PARALLÈLE (for e in io.walk(root, {...}))
+// ============================================================
+
+typedef struct {
+    char* path;        // chemin complet (à libérer par l'appelant)
+    const char* type;  // "file", "dir", "link", "other"
+    long long size;    // -1 si non demandé (stat: false)
+    double mtime;      // secondes depuis l'epoch, -1 si non demandé
+} IoWalkEntry;
+
+// parallel <= 0 : un thread par CPU ; filter : motif fnmatch sur le nom (NULL = tout)
+int io_walk_open(const char* root, int parallel, bool follow_links, const char* filter, bool want_stat);
+
+// Entrée suivante ; false quand le parcours est terminé
+bool io_walk_next(int handle, IoWalkEntry* out);
+
+// Arrête les threads (y compris en cours de parcours) et libère le handle
+void io_walk_close(int handle);
+
 #endif // IO_H
 
@@ -6,19 +6,14 @@
 #include <ctype.h>
 #include <stdarg.h>
 #include "common.h"
+#include "intern.h"
 
 // ======================================================
 // [SECTION] LEXER STATE
 // ======================================================
-typedef struct {
-    const char* start;
-    const char* current;
-    int line;
-    int column;
-    int start_column;
-} Lexer;
+typedef LexerState Lexer;
 
-static Lexer lexer;
+static ISOLATE Lexer lexer;
 
 // ======================================================
 // [SECTION] LEXER UTILITIES
@@ -31,6 +26,14 @@ void initLexer(const char* source) {
     lexer.start_column = 1;
 }
 
+LexerState saveLexerState() {
+    return lexer;
+}
+
+void restoreLexerState(LexerState state) {
+    lexer = state;
+}
+
 static bool isAtEnd() { 
     return *lexer.current == '\0'; 
 }
@@ -75,6 +78,7 @@ static Token makeToken(TokenKind kind) {
     token.column = lexer.start_column;
     
     token.value.int_val = 0;
+    token.sym = 0;
     return token;
 }
 
@@ -86,6 +90,7 @@ static Token errorToken(const char* message) {
     token.line = lexer.line;
     token.column = lexer.column;
     token.value.str_val = NULL;
+    token.sym = 0;
     return token;
 }
 
@@ -329,6 +334,7 @@ static Token identifier() {
         // Si pas un keyword, c'est un identifiant
         Token token = makeToken(TK_IDENT);
         token.value.str_val = text;
+        token.sym = intern(text);
         return token;
     }
     
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include "common.h"
 #include "net.h"
+#include "sched.h"
 
 void init_net_module(void) {
     printf("%s[NET MODULE]%s Initializing BSD Sockets...\n", COLOR_CYAN, COLOR_RESET);
@@ -92,6 +93,8 @@ int net_accept_client(int server_fd) {
     
     printf("%s[NET]%s Waiting for connection on fd=%d...\n", COLOR_CYAN, COLOR_RESET, server_fd);
     
+    // Attente coopérative : les autres tâches async continuent pendant ce temps
+    sched_wait_fd(server_fd, POLLIN);
     int new_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t*)&addrlen);
     if (new_socket < 0) {
         printf("%s[NET ERROR]%s Accept failed: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
@@ -121,6 +124,7 @@ char* net_recv_data(int fd, int size) {
     if (size > 65535) size = 65535;
     
     char* buffer = malloc(size + 1);
+    sched_wait_fd(fd, POLLIN);
     ssize_t valread = recv(fd, buffer, size, 0);
     
     if (valread > 0) {
@@ -3,7 +3,9 @@
 #include <string.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <ctype.h>
 #include "common.h"
+#include "intern.h"
 // ======================================================
 // [SECTION] PROTOTYPES (FORWARD DECLARATIONS)
 // ======================================================
@@ -25,6 +27,11 @@ static ASTNode* ioListdirStatement();
 static ASTNode* ioRemoveStatement();
 static ASTNode* ioRenameStatement();
 static ASTNode* ioCopyStatement();
+static ASTNode* ioWriterStatement();
+static ASTNode* ioLinesStatement();
+static ASTNode* ioChunksStatement();
+static ASTNode* ioWalkStatement();
+static ASTNode* ioAsyncStatement(TokenKind op);
 
 // Net
 static ASTNode* netSocketStatement();
@@ -44,24 +51,48 @@ static ASTNode* httpDownloadStatement();
 static ASTNode* sysExecStatement();
 static ASTNode* sysArgvStatement();
 static ASTNode* sysExitStatement();
+static ASTNode* sysSpawnStatement();
+static ASTNode* sysRunAllStatement();
 
 // Json
 static ASTNode* jsonGetStatement();
 extern void execute(ASTNode* node);
 extern Token scanToken();
 extern void initLexer(const char* source);
+extern LexerState saveLexerState();
+extern void restoreLexerState(LexerState state);
 extern bool isAtEnd();
 
 // ======================================================
 // [SECTION] PARSER STATE
 // ======================================================
-static Token current;
-static Token previous;
-static bool hadError = false;
-static bool panicMode = false;
-static int errorCount = 0;
-static int warningCount = 0;
-static int scope_level = 0;
+static ISOLATE Token current;
+static ISOLATE Token previous;
+static ISOLATE bool hadError = false;
+static ISOLATE bool panicMode = false;
+static ISOLATE int errorCount = 0;
+static ISOLATE int warningCount = 0;
+static ISOLATE bool parallel_header = false; // for-in en cours : en-tête d'un parallel for
+static ISOLATE bool quiet = false; // isolats des workers : source déjà analysée par le thread principal
+
+// Noeuds parallel for dans l'ordre d'analyse : chaque isolat analyse la même
+// source, un même numéro y désigne donc la même boucle
+static ISOLATE ASTNode** parallel_nodes = NULL;
+static ISOLATE int parallel_count = 0;
+static ISOLATE int parallel_cap = 0;
+
+static void registerParallelNode(ASTNode* node) {
+    if (parallel_count == parallel_cap) {
+        parallel_cap = parallel_cap ? parallel_cap * 2 : 8;
+        parallel_nodes = realloc(parallel_nodes, parallel_cap * sizeof(ASTNode*));
+        if (!parallel_nodes) {
+            fprintf(stderr, "%sPARSER FATAL%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+            exit(1);
+        }
+    }
+    parallel_nodes[parallel_count++] = node;
+}
+static ISOLATE int scope_level = 0;
 
 // ======================================================
 // [SECTION] ERROR HANDLING
@@ -97,6 +128,7 @@ static void errorAtCurrent(const char* message) {
 
 static void warningAt(Token token, const char* message) {
     warningCount++;
+    if (quiet) return;
     fprintf(stderr, "%sPARSER WARNING%s Line %d, Col %d: %s\n", 
             COLOR_YELLOW, COLOR_RESET, token.line, token.column, message);
 }
@@ -121,6 +153,25 @@ static bool check(TokenKind kind) {
     return current.kind == kind;
 }
 
+// Point de retour pour le lookahead : le lexer doit être rembobiné avec les tokens,
+// sinon restaurer 'current' seul désynchronise le flux.
+typedef struct {
+    LexerState lexer;
+    Token current;
+    Token previous;
+} ParserMark;
+
+static ParserMark markParser() {
+    ParserMark mark = { saveLexerState(), current, previous };
+    return mark;
+}
+
+static void resetParser(ParserMark mark) {
+    restoreLexerState(mark.lexer);
+    current = mark.current;
+    previous = mark.previous;
+}
+
 static Token consume(TokenKind kind, const char* message) {
     if (check(kind)) {
         advance();
@@ -217,6 +268,8 @@ static ASTNode* newBoolNode(bool value) {
 static ASTNode* newIdentNode(char* name) {
     ASTNode* node = newNode(NODE_IDENT);
     node->data.name = str_copy(name);
+    // Le lexer a déjà interné l'identifiant du token courant
+    node->sym = (previous.kind == TK_IDENT && name == previous.value.str_val) ? previous.sym : intern(name);
     return node;
 }
 
@@ -301,6 +354,7 @@ static ASTNode* assignment() {
             
             if (expr->type == NODE_IDENT && expr->data.name) {
                 node->data.name = str_copy(expr->data.name);
+                node->sym = expr->sym;
             }
         }
         return node;
@@ -510,7 +564,7 @@ static ASTNode* unary() {
     if (match(TK_MINUS) || match(TK_NOT) || match(TK_BIT_NOT) || 
         match(TK_PLUS) || match(TK_TYPEOF) || match(TK_AWAIT)) {
         TokenKind op = previous.kind;
-        ASTNode* node = newNode(NODE_UNARY);
+        ASTNode* node = newNode(op == TK_AWAIT ? NODE_AWAIT : NODE_UNARY);
         if (node) {
             node->op_type = op;
             node->left = unary();
@@ -604,6 +658,7 @@ static ASTNode* call() {
             
             // Le nom de la méthode est à droite (ex: "install")
             node->data.name = strdup(expr->right->data.name);
+            node->sym = expr->right->sym;
             
             // On libère le noeud temporaire qui contenait l'accès
             free(expr->right);
@@ -617,7 +672,7 @@ static ASTNode* call() {
                 while (match(TK_COMMA)) {
                     ASTNode* next_arg = expression();
                     if(current_arg) {
-                        current_arg->right = next_arg;
+                        current_arg->next = next_arg;
                         current_arg = next_arg;
                     }
                 }
@@ -633,6 +688,7 @@ static ASTNode* call() {
         ASTNode* node = newNode(NODE_FUNC_CALL);
         if (expr->type == NODE_IDENT && expr->data.name) {
             node->data.name = strdup(expr->data.name);
+            node->sym = expr->sym;
         }
         
         // Parse arguments (logique existante)
@@ -643,7 +699,7 @@ static ASTNode* call() {
             while (match(TK_COMMA)) {
                 ASTNode* next_arg = expression();
                  if(current_arg) {
-                    current_arg->right = next_arg;
+                    current_arg->next = next_arg;
                     current_arg = next_arg;
                 }
             }
@@ -667,27 +723,36 @@ static ASTNode* memberAccess() {
         TokenKind op = previous.kind;
         
         if (op == TK_PERIOD || op == TK_SAFE_NAV) {
-            if (!match(TK_IDENT)) {
+            // Un mot-clé est accepté comme nom de membre (e.type, e.size...)
+            bool is_word = current.length > 0 && (isalpha((unsigned char)current.start[0]) || current.start[0] == '_');
+            if (!check(TK_IDENT) && !is_word) {
                 error("Expected member name after '.'");
                 return expr;
             }
+            advance();
             
             ASTNode* node = newNode(NODE_MEMBER_ACCESS);
             if (node) {
                 node->op_type = op;
                 node->left = expr;
-                node->right = newIdentNode(previous.value.str_val);
+                node->right = newIdentNode(previous.kind == TK_IDENT ? previous.value.str_val
+                                                                     : str_ncopy(previous.start, previous.length));
                 expr = node;
             }
         } else if (op == TK_LBRACKET) {
-            ASTNode* index = expression();
+            // a[i] ou tranche a[debut:fin] (bornes facultatives)
+            ASTNode* index = check(TK_COLON) ? NULL : expression();
+            ASTNode* end = NULL;
+            bool is_slice = match(TK_COLON);
+            if (is_slice && !check(TK_RBRACKET)) end = expression();
             consume(TK_RBRACKET, "Expected ']' after index");
             
             ASTNode* node = newNode(NODE_ARRAY_ACCESS);
             if (node) {
-                node->op_type = TK_LBRACKET;
+                node->op_type = is_slice ? TK_COLON : TK_LBRACKET;
                 node->left = expr;
                 node->right = index;
+                node->third = end;
                 expr = node;
             }
         }
@@ -752,6 +817,30 @@ static ASTNode* sysExitStatement() {
     return node;
 }
 
+// sys.spawn(argv [, {env: {...}, cwd: "dir", stdin: "data", limit: N}]) -> processus
+static ASTNode* sysSpawnStatement() {
+    ASTNode* node = newNode(NODE_SYS_SPAWN);
+    consume(TK_LPAREN, "Expected '(' after sys.spawn");
+    node->left = expression(); // liste des arguments
+    if (match(TK_COMMA)) {
+        node->right = expression(); // options (littéral map)
+    }
+    consume(TK_RPAREN, "Expected ')' after sys.spawn arguments");
+    return node;
+}
+
+// sys.run_all(commandes [, {jobs: N, fail_fast: bool, env: {...}, cwd: "dir"}])
+static ASTNode* sysRunAllStatement() {
+    ASTNode* node = newNode(NODE_SYS_RUN_ALL);
+    consume(TK_LPAREN, "Expected '(' after sys.run_all");
+    node->left = expression(); // liste de commandes
+    if (match(TK_COMMA)) {
+        node->right = expression(); // options (littéral map)
+    }
+    consume(TK_RPAREN, "Expected ')' after sys.run_all arguments");
+    return node;
+}
+
 static ASTNode* jsonGetStatement() {
     ASTNode* node = newNode(NODE_JSON_GET);
     consume(TK_LPAREN, "Expected '(' after json.get");
@@ -765,15 +854,18 @@ static ASTNode* primary() {
     // ========================================================================
     // [SECTION] Appels de Modules Natifs (io.open, math.sin, etc.)
     // ========================================================================
-    if (check(TK_IDENT)) {
-        const char* module_name = current.value.str_val;
-        Token start_token = current; 
+    if (check(TK_IDENT) || check(TK_NET)) {
+        // 'net' est aussi un mot-clé de déclaration : net.accept(...) arrive en TK_NET
+        const char* module_name = check(TK_NET) ? "net" : current.value.str_val;
+        ParserMark start_mark = markParser();
 
         // --- MODULE 'io' ---
         if (strcmp(module_name, "io") == 0) {
             advance(); 
-            if (match(TK_PERIOD) && match(TK_IDENT)) {
-                const char* cmd = previous.value.str_val;
+            // 'write' et 'read' sont des mots-clés : on compare le lexème plutôt que str_val
+            if (match(TK_PERIOD) && (match(TK_IDENT) || match(TK_WRITE) || match(TK_READ))) {
+                char cmd[32];
+                snprintf(cmd, sizeof(cmd), "%.*s", previous.length, previous.start);
                 if (strcmp(cmd, "open") == 0) return ioOpenStatement();
                 if (strcmp(cmd, "close") == 0) return ioCloseStatement();
                 if (strcmp(cmd, "read") == 0) return ioReadStatement();
@@ -790,8 +882,21 @@ static ASTNode* primary() {
                 if (strcmp(cmd, "remove") == 0) return ioRemoveStatement();
                 if (strcmp(cmd, "rename") == 0) return ioRenameStatement();
                 if (strcmp(cmd, "copy") == 0) return ioCopyStatement();
+                if (strcmp(cmd, "writer") == 0) return ioWriterStatement();
+                if (strcmp(cmd, "lines") == 0) return ioLinesStatement();
+                if (strcmp(cmd, "chunks") == 0) return ioChunksStatement();
+                if (strcmp(cmd, "walk") == 0) return ioWalkStatement();
+                if (strcmp(cmd, "read_async") == 0) return ioAsyncStatement(TK_IO_READ_ASYNC);
+                if (strcmp(cmd, "write_async") == 0) return ioAsyncStatement(TK_IO_WRITE_ASYNC);
+                if (strcmp(cmd, "async_backend") == 0) {
+                    ASTNode* node = newNode(NODE_IO_FUNC);
+                    node->op_type = TK_IO_ASYNC_BACKEND;
+                    consume(TK_LPAREN, "Expected '(' after io.async_backend");
+                    consume(TK_RPAREN, "Expected ')' after io.async_backend");
+                    return node;
+                }
             }
-            current = start_token; // Reset si pas trouvé
+            resetParser(start_mark); // Reset si pas trouvé
         }
         // --- MODULE 'net' ---
         else if (strcmp(module_name, "net") == 0) {
@@ -806,7 +911,7 @@ static ASTNode* primary() {
                 if (strcmp(cmd, "recv") == 0) return netRecvStatement();
                 if (strcmp(cmd, "close") == 0) return netCloseStatement();
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'http' ---
         else if (strcmp(module_name, "http") == 0) {
@@ -817,7 +922,7 @@ static ASTNode* primary() {
                 if (strcmp(cmd, "post") == 0) return httpPostStatement();
                 if (strcmp(cmd, "download") == 0) return httpDownloadStatement();
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'sys' ---
         else if (strcmp(module_name, "sys") == 0) {
@@ -827,8 +932,10 @@ static ASTNode* primary() {
                 if (strcmp(cmd, "exec") == 0) return sysExecStatement();
                 if (strcmp(cmd, "argv") == 0) return sysArgvStatement();
                 if (strcmp(cmd, "exit") == 0) return sysExitStatement();
+                if (strcmp(cmd, "spawn") == 0) return sysSpawnStatement();
+                if (strcmp(cmd, "run_all") == 0) return sysRunAllStatement();
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'json' ---
         else if (strcmp(module_name, "json") == 0) {
@@ -837,7 +944,7 @@ static ASTNode* primary() {
                 const char* cmd = previous.value.str_val;
                 if (strcmp(cmd, "get") == 0) return jsonGetStatement();
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'std' ---
         else if (strcmp(module_name, "std") == 0) {
@@ -867,7 +974,7 @@ static ASTNode* primary() {
                     return node;
                 }
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'math' ---
         else if (strcmp(module_name, "math") == 0) {
@@ -891,16 +998,30 @@ static ASTNode* primary() {
                 else if (strcmp(cmd, "ceil") == 0) node->op_type = TK_MATH_CEIL;
                 else if (strcmp(cmd, "round") == 0) node->op_type = TK_MATH_ROUND;
                 else if (strcmp(cmd, "pow") == 0) node->op_type = TK_MATH_POW;
+                else if (strcmp(cmd, "float64") == 0) node->op_type = TK_MATH_F64;
+                else if (strcmp(cmd, "int64") == 0) node->op_type = TK_MATH_I64;
+                else if (strcmp(cmd, "sum") == 0) node->op_type = TK_MATH_SUM;
+                else if (strcmp(cmd, "min") == 0) node->op_type = TK_MATH_MIN;
+                else if (strcmp(cmd, "max") == 0) node->op_type = TK_MATH_MAX;
+                else if (strcmp(cmd, "mean") == 0) node->op_type = TK_MATH_MEAN;
+                else if (strcmp(cmd, "dot") == 0) node->op_type = TK_MATH_DOT;
+                else if (strcmp(cmd, "add") == 0) node->op_type = TK_MATH_VADD;
+                else if (strcmp(cmd, "sub") == 0) node->op_type = TK_MATH_VSUB;
+                else if (strcmp(cmd, "mul") == 0) node->op_type = TK_MATH_VMUL;
+                else if (strcmp(cmd, "div") == 0) node->op_type = TK_MATH_VDIV;
+                else if (strcmp(cmd, "simd") == 0) node->op_type = TK_MATH_SIMD;
                 else {
                     free(node);
-                    current = start_token;
+                    resetParser(start_mark);
                     goto end_native_check; 
                 }
                 
                 consume(TK_LPAREN, "(");
-                if (node->op_type != TK_MATH_RANDOM) {
+                if (node->op_type != TK_MATH_RANDOM && node->op_type != TK_MATH_SIMD) {
                     node->left = expression();
-                    if (node->op_type == TK_MATH_POW) {
+                    if (node->op_type == TK_MATH_POW || node->op_type == TK_MATH_DOT ||
+                        node->op_type == TK_MATH_VADD || node->op_type == TK_MATH_VSUB ||
+                        node->op_type == TK_MATH_VMUL || node->op_type == TK_MATH_VDIV) {
                         consume(TK_COMMA, ",");
                         node->right = expression();
                     }
@@ -908,7 +1029,7 @@ static ASTNode* primary() {
                 consume(TK_RPAREN, ")");
                 return node;
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'str' ---
         else if (strcmp(module_name, "str") == 0) {
@@ -927,7 +1048,7 @@ static ASTNode* primary() {
                 else if (strcmp(cmd, "ends") == 0) node->op_type = TK_STR_ENDS;
                 else {
                     free(node);
-                    current = start_token;
+                    resetParser(start_mark);
                     goto end_native_check;
                 }
                 
@@ -945,7 +1066,7 @@ static ASTNode* primary() {
                 consume(TK_RPAREN, ")");
                 return node;
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'time' ---
         else if (strcmp(module_name, "time") == 0) {
@@ -961,8 +1082,51 @@ static ASTNode* primary() {
                     consume(TK_LPAREN, "("); node->left = expression(); consume(TK_RPAREN, ")");
                     return node;
                 }
+                if (strcmp(cmd, "now_ns") == 0 || strcmp(cmd, "perf") == 0) {
+                    ASTNode* node = newNode(NODE_TIME_FUNC);
+                    node->op_type = cmd[0] == 'n' ? TK_TIME_NOW_NS : TK_TIME_PERF;
+                    consume(TK_LPAREN, "("); consume(TK_RPAREN, ")");
+                    return node;
+                }
+                // time.after(delai, f) / time.every(periode, f) / time.cancel(id)
+                if (strcmp(cmd, "after") == 0 || strcmp(cmd, "every") == 0) {
+                    ASTNode* node = newNode(NODE_TIME_FUNC);
+                    node->op_type = cmd[0] == 'a' ? TK_TIME_AFTER : TK_TIME_EVERY;
+                    consume(TK_LPAREN, "(");
+                    node->left = expression();
+                    consume(TK_COMMA, "Expected ',' after timer delay");
+                    node->right = expression();
+                    consume(TK_RPAREN, ")");
+                    return node;
+                }
+                if (strcmp(cmd, "cancel") == 0) {
+                    ASTNode* node = newNode(NODE_TIME_FUNC);
+                    node->op_type = TK_TIME_CANCEL;
+                    consume(TK_LPAREN, "("); node->left = expression(); consume(TK_RPAREN, ")");
+                    return node;
+                }
             }
-            current = start_token;
+            resetParser(start_mark);
+        }
+        // --- MODULE 'gc' ---
+        else if (strcmp(module_name, "gc") == 0) {
+            advance();
+            if (match(TK_PERIOD) && match(TK_IDENT)) {
+                const char* cmd = previous.value.str_val;
+                if (strcmp(cmd, "collect") == 0) {
+                    ASTNode* node = newNode(NODE_GC_FUNC);
+                    node->op_type = TK_GC_COLLECT;
+                    consume(TK_LPAREN, "("); consume(TK_RPAREN, ")");
+                    return node;
+                }
+                if (strcmp(cmd, "stat") == 0) {
+                    ASTNode* node = newNode(NODE_GC_FUNC);
+                    node->op_type = TK_GC_STAT;
+                    consume(TK_LPAREN, "("); node->left = expression(); consume(TK_RPAREN, ")");
+                    return node;
+                }
+            }
+            resetParser(start_mark);
         }
         // --- MODULE 'env' ---
         else if (strcmp(module_name, "env") == 0) {
@@ -974,7 +1138,7 @@ static ASTNode* primary() {
                 if (strcmp(cmd, "get") == 0) node->op_type = TK_ENV_GET;
                 else if (strcmp(cmd, "set") == 0) node->op_type = TK_ENV_SET;
                 else if (strcmp(cmd, "os") == 0) node->op_type = TK_ENV_OS;
-                else { free(node); current = start_token; goto end_native_check; }
+                else { free(node); resetParser(start_mark); goto end_native_check; }
                 
                 consume(TK_LPAREN, "(");
                 if (node->op_type != TK_ENV_OS) {
@@ -986,7 +1150,7 @@ static ASTNode* primary() {
                 consume(TK_RPAREN, ")");
                 return node;
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'path' ---
         else if (strcmp(module_name, "path") == 0) {
@@ -999,7 +1163,7 @@ static ASTNode* primary() {
                 else if (strcmp(cmd, "dirname") == 0) node->op_type = TK_PATH_DIRNAME;
                 else if (strcmp(cmd, "join") == 0) node->op_type = TK_PATH_JOIN;
                 else if (strcmp(cmd, "abs") == 0) node->op_type = TK_PATH_ABS;
-                else { free(node); current = start_token; goto end_native_check; }
+                else { free(node); resetParser(start_mark); goto end_native_check; }
                 
                 consume(TK_LPAREN, "(");
                 node->left = expression();
@@ -1009,7 +1173,7 @@ static ASTNode* primary() {
                 consume(TK_RPAREN, ")");
                 return node;
             }
-            current = start_token;
+            resetParser(start_mark);
         }
         // --- MODULE 'crypto' ---
         else if (strcmp(module_name, "crypto") == 0) {
@@ -1022,14 +1186,14 @@ static ASTNode* primary() {
                 else if (strcmp(cmd, "b64encode") == 0) node->op_type = TK_CRYPTO_B64ENC;
                 else if (strcmp(cmd, "b64decode") == 0) node->op_type = TK_CRYPTO_B64DEC;
                 else if (strcmp(cmd, "md5") == 0) node->op_type = TK_CRYPTO_MD5;
-                else { free(node); current = start_token; goto end_native_check; }
+                else { free(node); resetParser(start_mark); goto end_native_check; }
                 
                 consume(TK_LPAREN, "(");
                 node->left = expression();
                 consume(TK_RPAREN, ")");
                 return node;
             }
-            current = start_token;
+            resetParser(start_mark);
         }
     }
     
@@ -1078,14 +1242,50 @@ static ASTNode* primary() {
     }
     
     if (match(TK_LBRACKET)) {
-        // TODO: Implémenter parsing liste
-        consume(TK_RBRACKET, "]");
-        return newNode(NODE_LIST);
+        // Littéral liste : [a, b, c] (virgule finale acceptée)
+        ASTNode* node = newNode(NODE_LIST);
+        ASTNode* last_item = NULL;
+        while (!check(TK_RBRACKET) && !check(TK_EOF)) {
+            ASTNode* item = expression();
+            if (!item) break;
+            if (last_item) last_item->next = item;
+            else node->left = item;
+            last_item = item;
+            if (!match(TK_COMMA)) break;
+        }
+        consume(TK_RBRACKET, "Expected ']' after list elements");
+        return node;
     }
     if (match(TK_LBRACE)) {
-        // TODO: Implémenter parsing map
-        consume(TK_RBRBRACE, "}"); // Correction: TK_RBRACE
-        return newNode(NODE_MAP);
+        // Littéral map : { clé: valeur, "clé": valeur, ... }
+        ASTNode* node = newNode(NODE_MAP);
+        ASTNode* last_entry = NULL;
+        
+        while (!check(TK_RBRACE) && !check(TK_EOF)) {
+            ASTNode* entry = newNode(NODE_MAP_ENTRY);
+            
+            // Une clé identifiant (ou mot-clé : append, in...) est traitée comme une chaîne (style JSON/JS)
+            if (current.start && (isalpha((unsigned char)current.start[0]) || current.start[0] == '_')) {
+                char* key = str_ncopy(current.start, current.length);
+                advance();
+                entry->right = newStringNode(key);
+                free(key);
+            } else {
+                entry->right = expression();
+            }
+            
+            consume(TK_COLON, "Expected ':' after map key");
+            entry->left = expression();
+            
+            if (last_entry) last_entry->next = entry;
+            else node->left = entry;
+            last_entry = entry;
+            
+            if (!match(TK_COMMA)) break;
+        }
+        
+        consume(TK_RBRACE, "Expected '}' after map literal");
+        return node;
     }
 
     errorAtCurrent("Expected expression.");
@@ -1103,6 +1303,7 @@ static ASTNode* whileStatement();
 static ASTNode* doWhileStatement();
 static ASTNode* forStatement();
 static ASTNode* forInStatement();
+static ASTNode* parallelForStatement();
 static ASTNode* switchStatement();
 static ASTNode* caseStatement();
 static ASTNode* returnStatement();
@@ -1120,6 +1321,7 @@ static ASTNode* passStatement();
 static ASTNode* withStatement();
 static ASTNode* learnStatement();
 static ASTNode* lockStatement();
+static ASTNode* rwlockStatement();
 static ASTNode* appendStatement();
 static ASTNode* pushStatement();
 static ASTNode* popStatement();
@@ -1157,7 +1359,6 @@ static ASTNode* ioOpenStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.open arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.open");
     
     return node;
 }
@@ -1168,7 +1369,7 @@ static ASTNode* ioCloseStatement() {
     consume(TK_LPAREN, "Expected '(' after io.close");
     node->left = expression(); // fd
     consume(TK_RPAREN, "Expected ')' after io.close arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.close");
+    // Pas de ';' ici : io.* passe par primary(), l'expressionStatement le consomme
     
     return node;
 }
@@ -1187,7 +1388,6 @@ static ASTNode* ioReadStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.read arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.read");
     
     return node;
 }
@@ -1201,7 +1401,7 @@ static ASTNode* ioWriteStatement() {
     node->right = expression(); // data
     
     consume(TK_RPAREN, "Expected ')' after io.write arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.write");
+    // Pas de ';' ici : io.* passe par primary(), l'expressionStatement le consomme
     
     return node;
 }
@@ -1219,7 +1419,6 @@ static ASTNode* ioSeekStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.seek arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.seek");
     
     return node;
 }
@@ -1235,7 +1434,6 @@ static ASTNode* ioTellStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.tell arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.tell");
     
     return node;
 }
@@ -1251,7 +1449,6 @@ static ASTNode* ioExistsStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.exists arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.exists");
     
     return node;
 }
@@ -1267,7 +1464,6 @@ static ASTNode* ioIsfileStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.isfile arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.isfile");
     
     return node;
 }
@@ -1283,7 +1479,6 @@ static ASTNode* ioIsdirStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.isdir arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.isdir");
     
     return node;
 }
@@ -1299,7 +1494,6 @@ static ASTNode* ioMkdirStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.mkdir arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.mkdir");
     
     return node;
 }
@@ -1316,7 +1510,6 @@ static ASTNode* ioListdirStatement() {
     }
     
     consume(TK_RPAREN, "Expected ')' after io.listdir arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.listdir");
     
     return node;
 }
@@ -1327,10 +1520,11 @@ static ASTNode* ioFlushStatement() {
     node->left = expression(); // fd
     
     consume(TK_RPAREN, "Expected ')' after io.flush arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.flush");
+    // Pas de ';' ici : io.* passe par primary(), l'expressionStatement le consomme
     
     return node;
 }
+// io.copy(src, dst [, {preserve: bool}]) -> octets copiés
 static ASTNode* ioCopyStatement() {
     ASTNode* node = newNode(NODE_FILE_COPY);
     
@@ -1339,8 +1533,11 @@ static ASTNode* ioCopyStatement() {
     consume(TK_COMMA, "Expected ',' after source");
     node->right = expression(); // destination
     
+    if (match(TK_COMMA)) {
+        node->third = expression(); // options : {preserve: true}
+    }
+    
     consume(TK_RPAREN, "Expected ')' after io.copy arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.copy");
     
     return node;
 }
@@ -1351,7 +1548,6 @@ static ASTNode* ioRemoveStatement() {
     node->left = expression(); // filename
     
     consume(TK_RPAREN, "Expected ')' after io.remove arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.remove");
     
     return node;
 }
@@ -1364,7 +1560,82 @@ static ASTNode* ioRenameStatement() {
     node->right = expression(); // new name
     
     consume(TK_RPAREN, "Expected ')' after io.rename arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.rename");
+    
+    return node;
+}
+// io.writer(path [, {buffer: N, append: bool}]) -> handle bufferisé
+static ASTNode* ioWriterStatement() {
+    ASTNode* node = newNode(NODE_IO_FUNC);
+    node->op_type = TK_IO_WRITER;
+    
+    consume(TK_LPAREN, "Expected '(' after io.writer");
+    node->left = expression(); // path
+    
+    if (match(TK_COMMA)) {
+        node->right = expression(); // options (littéral map)
+    }
+    
+    consume(TK_RPAREN, "Expected ')' after io.writer arguments");
+    
+    return node;
+}
+// io.lines(path) -> itérateur de lignes (for line in io.lines(path))
+static ASTNode* ioLinesStatement() {
+    ASTNode* node = newNode(NODE_IO_FUNC);
+    node->op_type = TK_IO_LINES;
+    
+    consume(TK_LPAREN, "Expected '(' after io.lines");
+    node->left = expression(); // path
+    consume(TK_RPAREN, "Expected ')' after io.lines arguments");
+    
+    return node;
+}
+// io.chunks(path, size) -> itérateur de blocs de 'size' octets
+static ASTNode* ioChunksStatement() {
+    ASTNode* node = newNode(NODE_IO_FUNC);
+    node->op_type = TK_IO_CHUNKS;
+    
+    consume(TK_LPAREN, "Expected '(' after io.chunks");
+    node->left = expression(); // path
+    consume(TK_COMMA, "Expected ',' after io.chunks path");
+    node->right = expression(); // taille des blocs
+    consume(TK_RPAREN, "Expected ')' after io.chunks arguments");
+    
+    return node;
+}
+// io.walk(root [, {parallel: N, follow_links: bool, filter: "*.log", stat: bool}])
+static ASTNode* ioWalkStatement() {
+    ASTNode* node = newNode(NODE_IO_FUNC);
+    node->op_type = TK_IO_WALK;
+    
+    consume(TK_LPAREN, "Expected '(' after io.walk");
+    node->left = expression(); // racine
+    
+    if (match(TK_COMMA)) {
+        node->right = expression(); // options (littéral map)
+    }
+    
+    consume(TK_RPAREN, "Expected ')' after io.walk arguments");
+    
+    return node;
+}
+// io.read_async(path) / io.write_async(path, data [, {append: bool}]) -> handle pour await
+static ASTNode* ioAsyncStatement(TokenKind op) {
+    ASTNode* node = newNode(NODE_IO_FUNC);
+    node->op_type = op;
+    
+    consume(TK_LPAREN, "Expected '(' after io async call");
+    node->left = expression(); // path
+    
+    if (op == TK_IO_WRITE_ASYNC) {
+        consume(TK_COMMA, "Expected ',' after io.write_async path");
+        node->right = expression(); // données
+        if (match(TK_COMMA)) {
+            node->third = expression(); // options
+        }
+    }
+    
+    consume(TK_RPAREN, "Expected ')' after io async arguments");
     
     return node;
 }
@@ -1375,7 +1646,6 @@ static ASTNode* ioRmdirStatement() {
     node->left = expression(); // dirname
     
     consume(TK_RPAREN, "Expected ')' after io.rmdir arguments");
-    consume(TK_SEMICOLON, "Expected ';' after io.rmdir");
     
     return node;
 }
@@ -1399,8 +1669,8 @@ static ASTNode* printStatement() {
             ASTNode* next_arg = expression();
             if (node->left) {
                 ASTNode* current = node->left;
-                while (current->right) current = current->right;
-                current->right = next_arg;
+                while (current->next) current = current->next;
+                current->next = next_arg;
             }
         }
     }
@@ -1525,6 +1795,17 @@ static ASTNode* lockStatement() {
     return node;
 }
 
+// rwlock read(x) { ... } / rwlock write(x) { ... }
+static ASTNode* rwlockStatement() {
+    TokenKind mode = TK_WRITE;
+    if (match(TK_READ)) mode = TK_READ;
+    else if (!match(TK_WRITE)) errorAtCurrent("Expected 'read' or 'write' after 'rwlock'");
+    
+    ASTNode* node = lockStatement();
+    node->op_type = mode;
+    return node;
+}
+
 // Append statement
 static ASTNode* appendStatement() {
     ASTNode* node = newNode(NODE_APPEND);
@@ -1647,21 +1928,55 @@ static ASTNode* forStatement() {
 // For-in statement
 static ASTNode* forInStatement() {
     ASTNode* node = newNode(NODE_FOR_IN);
+    bool parallel = parallel_header;
+    parallel_header = false; // pas les for-in du corps
     
-    consume(TK_LPAREN, "Expected '(' after 'for'");
+    // Parenthèses optionnelles : for (x in it) ou for x in it
+    bool has_paren = match(TK_LPAREN);
     
     consume(TK_IDENT, "Expected variable name in for-in loop");
     node->data.for_in.var_name = str_copy(previous.value.str_val);
     
     consume(TK_IN, "Expected 'in' in for-in loop");
     node->data.for_in.iterable = expression();
+    // Intervalle : for i in a..b (b exclu) ou a..=b (b inclus)
+    if (match(TK_RANGE) || match(TK_RANGE_INCL)) {
+        node->op_type = previous.kind;
+        node->third = expression();
+    }
     
-    consume(TK_RPAREN, "Expected ')' after for-in expression");
+    if (has_paren) consume(TK_RPAREN, "Expected ')' after for-in expression");
+    // parallel for ... reduce(total: sum, best: max) { ... }
+    if (parallel && check(TK_IDENT) && strcmp(current.value.str_val, "reduce") == 0) {
+        advance();
+        consume(TK_LPAREN, "Expected '(' after 'reduce'");
+        ASTNode** link = &node->fourth;
+        do {
+            consume(TK_IDENT, "Expected variable name in reduce clause");
+            ASTNode* reduction = newIdentNode(previous.value.str_val);
+            consume(TK_COLON, "Expected ':' after reduction variable");
+            consume(TK_IDENT, "Expected sum, min, max or concat");
+            reduction->left = newIdentNode(previous.value.str_val);
+            *link = reduction;
+            link = &reduction->next;
+        } while (match(TK_COMMA));
+        consume(TK_RPAREN, "Expected ')' after reduce clause");
+    }
     node->data.for_in.body = statement();
     
     return node;
 }
 
+// parallel for x in a..b { ... } / parallel for x in liste { ... }
+static ASTNode* parallelForStatement() {
+    consume(TK_FOR, "Expected 'for' after 'parallel'");
+    parallel_header = true;
+    ASTNode* node = forInStatement();
+    node->type = NODE_PARALLEL_FOR;
+    registerParallelNode(node);
+    return node;
+}
+
 // Switch statement
 static ASTNode* switchStatement() {
     ASTNode* node = newNode(NODE_SWITCH);
@@ -1692,7 +2007,7 @@ static ASTNode* switchStatement() {
                         case_body = stmt;
                         current_stmt = stmt;
                     } else {
-                        current_stmt->right = stmt;
+                        current_stmt->next = stmt;
                         current_stmt = stmt;
                     }
                 }
@@ -1704,7 +2019,7 @@ static ASTNode* switchStatement() {
                 first_case = case_node;
                 current_case = case_node;
             } else {
-                current_case->right = case_node;
+                current_case->next = case_node;
                 current_case = case_node;
             }
         } else if (match(TK_DEFAULT)) {
@@ -1720,7 +2035,7 @@ static ASTNode* switchStatement() {
                         default_body = stmt;
                         current_stmt = stmt;
                     } else {
-                        current_stmt->right = stmt;
+                        current_stmt->next = stmt;
                         current_stmt = stmt;
                     }
                 }
@@ -1847,7 +2162,7 @@ static ASTNode* block() {
                 node->left = stmt;
                 current = stmt;
             } else {
-                current->right = stmt;
+                current->next = stmt;
                 current = stmt;
             }
         }
@@ -2009,7 +2324,7 @@ static ASTNode* functionDeclaration(bool is_exported) {
                 first_stmt = stmt;
                 current_stmt = stmt;
             } else {
-                current_stmt->right = stmt;
+                current_stmt->next = stmt;
                 current_stmt = stmt;
             }
         }
@@ -2039,6 +2354,7 @@ static ASTNode* variableDeclaration() {
     }
     
     char* varName = str_copy(previous.value.str_val);
+    int varSym = previous.sym;
     ASTNode* node = NULL;
     
     switch (declType) {
@@ -2059,10 +2375,12 @@ static ASTNode* variableDeclaration() {
     }
     
     node->data.name = varName;
+    node->sym = varSym;
     
-    // Optional type annotation
+    // Optional type annotation : int / float sont gardés comme indication
+    // (op_type), les autres types sont ignorés
     if (match(TK_COLON)) {
-        // Skip type for now
+        if (check(TK_TYPE_INT) || check(TK_TYPE_FLOAT)) node->op_type = current.kind;
         while (!check(TK_ASSIGN) && !check(TK_SEMICOLON)) {
             advance();
         }
@@ -2162,7 +2480,7 @@ static ASTNode* classDeclaration() {
                 first_member = member;
                 current_member = member;
             } else {
-                current_member->right = member;
+                current_member->next = member;
                 current_member = member;
             }
         }
@@ -2288,7 +2606,7 @@ static ASTNode* namespaceDeclaration() {
                 first_decl = decl;
                 current_decl = decl;
             } else {
-                current_decl->right = decl;
+                current_decl->next = decl;
                 current_decl = decl;
             }
         }
@@ -2538,6 +2856,15 @@ static ASTNode* declaration() {
         return func;
     }
     
+    // 'net.' : appel du module, pas une déclaration 'net x'
+    if (check(TK_NET)) {
+        ParserMark mark = markParser();
+        advance();
+        bool module_call = check(TK_PERIOD);
+        resetParser(mark);
+        if (module_call) return statement();
+    }
+    
     // Variable declarations
     if (match(TK_VAR) || match(TK_LET) || match(TK_CONST) ||
         match(TK_NET) || match(TK_CLOG) || match(TK_DOS) || match(TK_SEL) ||
@@ -2636,12 +2963,24 @@ static ASTNode* statement() {
         node->right = statement(); // Bloc à exécuter
         return node;
     }
+    if (match(TK_RWLOCK)) return rwlockStatement();
     if (match(TK_SYS_EXIT)) return sysExitStatement();
     // sys.exec peut aussi être un statement
     if (match(TK_SYS_EXEC)) return sysExecStatement();
     if (match(TK_NET_CONNECT)) return netConnectStatement();
     if (match(TK_NET_SEND)) return netSendStatement();
     if (match(TK_NET_CLOSE)) return netCloseStatement();
+    if (check(TK_NET)) {
+        ParserMark mark = markParser();
+        advance();
+        if (match(TK_PERIOD) && match(TK_IDENT)) {
+            const char* cmd = previous.value.str_val;
+            if (strcmp(cmd, "connect") == 0) return netConnectStatement();
+            if (strcmp(cmd, "send") == 0) return netSendStatement();
+            if (strcmp(cmd, "close") == 0) return netCloseStatement();
+        }
+        resetParser(mark);
+    }
     if (match(TK_IO_OPEN)) return ioOpenStatement();
     if (match(TK_IO_CLOSE)) return ioCloseStatement();
     if (match(TK_IO_WRITE)) return ioWriteStatement();
@@ -2671,18 +3010,16 @@ static ASTNode* statement() {
     if (match(TK_WHILE)) return whileStatement();
     if (match(TK_DO)) return doWhileStatement();
     if (match(TK_FOR)) {
-        // Check if it's for-in
-        Token saved = current;
+        // Check if it's for-in: for [(] ident in ...
+        ParserMark saved = markParser();
         bool is_for_in = false;
         
-        // Look ahead
-        advance(); // Skip 'for'
-        if (match(TK_IDENT) && match(TK_IN)) {
+        match(TK_LPAREN);
+        if (match(TK_IDENT) && check(TK_IN)) {
             is_for_in = true;
         }
         
-        // Restore
-        current = saved;
+        resetParser(saved);
         
         if (is_for_in) {
             return forInStatement();
@@ -2690,6 +3027,7 @@ static ASTNode* statement() {
             return forStatement();
         }
     }
+    if (match(TK_PARALLEL)) return parallelForStatement();
     if (match(TK_SWITCH)) return switchStatement();
     if (match(TK_RETURN)) return returnStatement();
     if (match(TK_YIELD)) return yieldStatement();
@@ -2706,6 +3044,21 @@ static ASTNode* statement() {
 // ======================================================
 // [SECTION] MAIN PARSER FUNCTION
 // ======================================================
+void parser_set_quiet(bool enabled) {
+    quiet = enabled;
+}
+
+int parser_parallel_index(ASTNode* node) {
+    for (int i = 0; i < parallel_count; i++) {
+        if (parallel_nodes[i] == node) return i;
+    }
+    return -1;
+}
+
+ASTNode* parser_parallel_node(int index) {
+    return index >= 0 && index < parallel_count ? parallel_nodes[index] : NULL;
+}
+
 ASTNode** parse(const char* source, int* count) {
     initLexer(source);
     advance();
@@ -2747,7 +3100,7 @@ ASTNode** parse(const char* source, int* count) {
         }
     }
     
-    
+    if (quiet && errorCount == 0) return nodes;
     printf("%sPARSER%s Errors: %d, Warnings: %d\n", 
            errorCount > 0 ? COLOR_RED : COLOR_GREEN, COLOR_RESET, errorCount, warningCount);
     
@@ -0,0 +1,182 @@
+// pool.c - Pool de threads à vol de travail pour SwiftFlow (spawn, futures)
+// Une deque par worker protégée par son propre verrou : le propriétaire et
+// les voleurs ne se disputent que cette deque-là, jamais une file globale.
+// Les workers sans travail dorment sur une condition commune.
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "common.h"
+#include "pool.h"
+
+// ======================================================
+// [SECTION] DEQUES
+// ======================================================
+#define POOL_MAX_WORKERS 64
+#define POOL_STACK_SIZE (64 * 1024 * 1024) // récursion profonde de l'interpréteur
+
+typedef struct {
+    PoolFn fn;
+    void* arg;
+} PoolJob;
+
+typedef struct {
+    pthread_mutex_t lock;
+    PoolJob* jobs;       // anneau : [top, bottom)
+    unsigned top;        // côté voleurs
+    unsigned bottom;     // côté propriétaire
+    unsigned cap;        // puissance de 2
+} Deque;
+
+static Deque deques[POOL_MAX_WORKERS];
+static pthread_t threads[POOL_MAX_WORKERS];
+static int worker_count = 0;
+static void (*worker_init)(int index) = NULL;
+static unsigned next_deque = 0;          // tourniquet des soumissions externes
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_idle = PTHREAD_COND_INITIALIZER;
+static int pending = 0;                  // jobs soumis et pas encore terminés
+static int queued = 0;                   // jobs dans les deques
+
+static ISOLATE int worker_index = -1;
+
+static void deque_push(Deque* d, PoolJob job) {
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom - d->top == d->cap) {
+        unsigned cap = d->cap ? d->cap * 2 : 64;
+        PoolJob* jobs = malloc(cap * sizeof(PoolJob));
+        if (!jobs) { fprintf(stderr, "%s[FATAL]%s Out of memory (pool)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        for (unsigned i = d->top; i != d->bottom; i++) jobs[i & (cap - 1)] = d->jobs[i & (d->cap - 1)];
+        free(d->jobs);
+        d->jobs = jobs;
+        d->cap = cap;
+    }
+    d->jobs[d->bottom++ & (d->cap - 1)] = job;
+    pthread_mutex_unlock(&d->lock);
+}
+
+// Propriétaire : le plus récent
+static bool deque_pop(Deque* d, PoolJob* out) {
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->bottom != d->top;
+    if (ok) *out = d->jobs[--d->bottom & (d->cap - 1)];
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+// Voleur : le plus ancien
+static bool deque_steal(Deque* d, PoolJob* out) {
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->bottom != d->top;
+    if (ok) *out = d->jobs[d->top++ & (d->cap - 1)];
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+// ======================================================
+// [SECTION] WORKERS
+// ======================================================
+static bool take_job(PoolJob* job) {
+    int self = worker_index;
+    if (self >= 0 && deque_pop(&deques[self], job)) return true;
+    int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < worker_count; k++) {
+        int victim = (start + k) % worker_count;
+        if (victim != self && deque_steal(&deques[victim], job)) return true;
+    }
+    return false;
+}
+
+static void run_job(PoolJob job) {
+    __atomic_sub_fetch(&queued, 1, __ATOMIC_ACQ_REL);
+    job.fn(job.arg);
+    pthread_mutex_lock(&pool_lock);
+    if (--pending == 0) pthread_cond_broadcast(&pool_idle);
+    pthread_mutex_unlock(&pool_lock);
+}
+
+static void* worker_main(void* arg) {
+    worker_index = (int)(intptr_t)arg;
+    if (worker_init) worker_init(worker_index);
+    for (;;) {
+        PoolJob job;
+        if (take_job(&job)) {
+            run_job(job);
+            continue;
+        }
+        pthread_mutex_lock(&pool_lock);
+        while (__atomic_load_n(&queued, __ATOMIC_ACQUIRE) == 0) pthread_cond_wait(&pool_wake, &pool_lock);
+        pthread_mutex_unlock(&pool_lock);
+    }
+    return NULL;
+}
+
+// ======================================================
+// [SECTION] API
+// ======================================================
+bool pool_start(int workers, void (*init)(int index)) {
+    if (worker_count > 0) return true;
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers <= 0) workers = 1;
+    if (workers > POOL_MAX_WORKERS) workers = POOL_MAX_WORKERS;
+    worker_init = init;
+
+    for (int i = 0; i < workers; i++) pthread_mutex_init(&deques[i].lock, NULL);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, POOL_STACK_SIZE);
+    int started = 0;
+    worker_count = workers; // les voleurs parcourent toutes les deques
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&threads[i], &attr, worker_main, (void*)(intptr_t)i) != 0) break;
+        started++;
+    }
+    pthread_attr_destroy(&attr);
+    worker_count = started;
+    if (started == 0) {
+        fprintf(stderr, "%s[POOL ERROR]%s Cannot start worker threads\n", COLOR_RED, COLOR_RESET);
+        return false;
+    }
+    return true;
+}
+
+int pool_size(void) {
+    return worker_count;
+}
+
+int pool_worker_index(void) {
+    return worker_index;
+}
+
+void pool_submit(PoolFn fn, void* arg) {
+    PoolJob job = { fn, arg };
+    int target = worker_index >= 0 ? worker_index
+                                   : (int)(__atomic_fetch_add(&next_deque, 1, __ATOMIC_RELAXED) % (unsigned)worker_count);
+    pthread_mutex_lock(&pool_lock);
+    pending++;
+    pthread_mutex_unlock(&pool_lock);
+    __atomic_add_fetch(&queued, 1, __ATOMIC_ACQ_REL); // avant le push : jamais négatif
+    deque_push(&deques[target], job);
+    pthread_mutex_lock(&pool_lock);
+    pthread_cond_signal(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+}
+
+bool pool_run_one(void) {
+    PoolJob job;
+    if (!take_job(&job)) return false;
+    run_job(job);
+    return true;
+}
+
+void pool_wait_idle(void) {
+    if (worker_count == 0) return;
+    pthread_mutex_lock(&pool_lock);
+    while (pending > 0) pthread_cond_wait(&pool_idle, &pool_lock);
+    pthread_mutex_unlock(&pool_lock);
+}
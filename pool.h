@@ -0,0 +1,31 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+
+// ============================================================
+// POOL DE WORKERS À VOL DE TRAVAIL
+// N threads, chacun avec sa deque de jobs. Un worker prend ses propres jobs
+// par le bas (LIFO : le dernier soumis a ses données en cache) ; sans
+// travail, il vole par le haut (FIFO) la deque d'un autre. Les jobs soumis
+// hors des workers sont répartis en tourniquet. Chaque worker exécute
+// init(index) au démarrage (création de son isolat).
+// ============================================================
+
+typedef void (*PoolFn)(void* arg);
+
+// Démarre le pool (sans effet s'il tourne déjà) ; workers <= 0 : un par cœur
+bool pool_start(int workers, void (*init)(int index));
+int pool_size(void);           // 0 tant que le pool n'est pas démarré
+int pool_worker_index(void);   // index du worker courant, -1 hors du pool
+
+void pool_submit(PoolFn fn, void* arg);
+
+// Exécute dans le thread courant un job en attente (vol compris) : un
+// worker qui attend un résultat aide au lieu de bloquer. Faux si aucun job
+bool pool_run_one(void);
+
+// Attend que tous les jobs soumis soient terminés (fin du script)
+void pool_wait_idle(void);
+
+#endif
@@ -0,0 +1,192 @@
+// rstr.c - Chaînes comptées par référence pour SwiftFlow
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "common.h"
+#include "rstr.h"
+
+typedef struct {
+    int32_t refcount;  // < 0 : chaîne statique, jamais libérée
+    uint32_t hash;     // 0 = pas encore calculé
+    size_t len;
+    size_t cap;        // octets utilisables hors terminateur
+    char data[];
+} RStrHeader;
+
+#define RSTR_HEADER(s) ((RStrHeader*)((char*)(s) - offsetof(RStrHeader, data)))
+#define RSTR_SMALL_CAP 15      // un bloc de 40 octets, en-tête compris
+#define RSTR_FREE_MAX 4096     // blocs gardés en réserve au maximum
+#define RSTR_IMMORTAL (-1)
+
+// Liste libre des petits blocs (chaînes <= RSTR_SMALL_CAP), allouée au
+// premier bloc rendu plutôt qu'en TLS statique (payée par chaque thread)
+static ISOLATE RStrHeader** small_free = NULL;
+static ISOLATE int small_free_count = 0;
+
+// "" et les 256 chaînes d'un caractère
+static ISOLATE char* tiny_strings[257];
+
+// Octets occupés par les chaînes vivantes (statistiques du GC)
+static ISOLATE size_t live_bytes = 0;
+
+static void out_of_memory(size_t len) {
+    fprintf(stderr, "%s[FATAL]%s Out of memory (string of %zu bytes)\n", COLOR_RED, COLOR_RESET, len);
+    exit(1);
+}
+
+static char* rstr_alloc(size_t len, size_t cap) {
+    if (cap < len) cap = len;
+    if (cap < RSTR_SMALL_CAP) cap = RSTR_SMALL_CAP;
+    
+    RStrHeader* h;
+    if (cap == RSTR_SMALL_CAP && small_free_count > 0) {
+        h = small_free[--small_free_count];
+    } else {
+        h = malloc(sizeof(RStrHeader) + cap + 1);
+        if (!h) out_of_memory(len);
+    }
+    live_bytes += sizeof(RStrHeader) + cap + 1;
+    h->refcount = 1;
+    h->hash = 0;
+    h->len = len;
+    h->cap = cap;
+    h->data[len] = '\0';
+    return h->data;
+}
+
+static void rstr_free(RStrHeader* h) {
+    live_bytes -= sizeof(RStrHeader) + h->cap + 1;
+    if (h->cap == RSTR_SMALL_CAP && small_free_count < RSTR_FREE_MAX) {
+        if (!small_free) small_free = malloc(RSTR_FREE_MAX * sizeof(RStrHeader*));
+        if (small_free) {
+            small_free[small_free_count++] = h;
+            return;
+        }
+    }
+    free(h);
+}
+
+static char* rstr_tiny(const char* s, size_t len) {
+    int slot = len == 0 ? 256 : (unsigned char)s[0];
+    if (!tiny_strings[slot]) {
+        char* r = rstr_alloc(len, len);
+        if (len) r[0] = s[0];
+        RSTR_HEADER(r)->refcount = RSTR_IMMORTAL;
+        tiny_strings[slot] = r;
+    }
+    return tiny_strings[slot];
+}
+
+char* rstr_new(const char* s, size_t len) {
+    if (len <= 1 && (len == 0 || s)) return rstr_tiny(s, len);
+    char* r = rstr_alloc(len, len);
+    if (s && len) memcpy(r, s, len);
+    return r;
+}
+
+char* rstr_from(const char* s) {
+    return rstr_new(s, s ? strlen(s) : 0);
+}
+
+char* rstr_adopt(char* s) {
+    char* r = rstr_from(s);
+    free(s);
+    return r;
+}
+
+char* rstr_retain(char* s) {
+    if (s && RSTR_HEADER(s)->refcount > 0) RSTR_HEADER(s)->refcount++;
+    return s;
+}
+
+void rstr_release(char* s) {
+    if (!s) return;
+    RStrHeader* h = RSTR_HEADER(s);
+    if (h->refcount > 0 && --h->refcount == 0) rstr_free(h);
+}
+
+size_t rstr_len(const char* s) {
+    return s ? RSTR_HEADER(s)->len : 0;
+}
+
+bool rstr_unique(const char* s) {
+    return s && RSTR_HEADER(s)->refcount == 1;
+}
+
+uint32_t rstr_hash(const char* s) {
+    if (!s) return 0;
+    RStrHeader* h = RSTR_HEADER(s);
+    if (h->hash == 0) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < h->len; i++) {
+            hash ^= (unsigned char)h->data[i];
+            hash *= 16777619u;
+        }
+        h->hash = hash ? hash : 1;
+    }
+    return h->hash;
+}
+
+bool rstr_equal(const char* a, const char* b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+    RStrHeader* ha = RSTR_HEADER(a);
+    RStrHeader* hb = RSTR_HEADER(b);
+    if (ha->len != hb->len) return false;
+    if (ha->hash && hb->hash && ha->hash != hb->hash) return false;
+    return memcmp(a, b, ha->len) == 0;
+}
+
+char* rstr_append(char* s, const char* add, size_t n) {
+    if (!s) return rstr_new(add, n);
+    RStrHeader* h = RSTR_HEADER(s);
+    size_t len = h->len + n;
+
+    if (h->refcount == 1) {
+        // 'add' peut pointer dans le buffer lui-même (s = s + s) : on garde son décalage
+        bool self = add >= s && add <= s + h->len;
+        size_t self_off = self ? (size_t)(add - s) : 0;
+        if (len > h->cap) {
+            // Croissance géométrique : une boucle de concaténation reste linéaire
+            size_t cap = h->cap * 2;
+            if (cap < len) cap = len;
+            RStrHeader* grown = realloc(h, sizeof(RStrHeader) + cap + 1);
+            if (!grown) out_of_memory(len);
+            live_bytes += cap - grown->cap;
+            h = grown;
+            h->cap = cap;
+        }
+        if (n) memmove(h->data + h->len, self ? h->data + self_off : add, n);
+        h->len = len;
+        h->hash = 0;
+        h->data[len] = '\0';
+        return h->data;
+    }
+
+    // Partagée (ou statique) : copie avec de la marge pour les ajouts suivants
+    char* r = rstr_alloc(len, len + len / 2);
+    memcpy(r, s, h->len);
+    if (n) memcpy(r + h->len, add, n);
+    rstr_release(s);
+    return r;
+}
+
+char* rstr_assign(char* s, const char* src, size_t len) {
+    if (s && rstr_unique(s) && RSTR_HEADER(s)->cap >= len) {
+        RStrHeader* h = RSTR_HEADER(s);
+        memmove(h->data, src, len);
+        h->len = len;
+        h->hash = 0;
+        h->data[len] = '\0';
+        return s;
+    }
+    char* r = rstr_new(src, len);
+    rstr_release(s);
+    return r;
+}
+
+size_t rstr_live_bytes(void) {
+    return live_bytes;
+}
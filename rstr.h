@@ -0,0 +1,45 @@
+#ifndef RSTR_H
+#define RSTR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================
+// CHAÎNES COMPTÉES (valeurs string des variables)
+// Une rstr est un char* terminé par '\0' précédé d'un en-tête
+// (compteur de références, longueur, capacité) : elle se lit comme
+// une chaîne C ordinaire mais se partage au lieu d'être recopiée.
+// Ne jamais appeler free() dessus : utiliser rstr_release().
+// Les chaînes de 0 ou 1 caractère sont statiques (jamais allouées) et les
+// petites chaînes sont recyclées par une liste libre.
+// ============================================================
+
+char* rstr_new(const char* s, size_t len);
+char* rstr_from(const char* s);
+
+// Convertit une chaîne malloc() (résultat de evalString...) ; libère l'originale
+char* rstr_adopt(char* s);
+
+char* rstr_retain(char* s);
+void rstr_release(char* s);
+
+size_t rstr_len(const char* s);
+bool rstr_unique(const char* s);
+
+// Hash FNV-1a calculé au premier appel puis mis en cache dans l'en-tête
+uint32_t rstr_hash(const char* s);
+bool rstr_equal(const char* a, const char* b);
+
+// Ajout en place si la chaîne n'est pas partagée (capacité doublée au besoin),
+// sinon copie. Consomme la référence 's' et retourne la nouvelle.
+char* rstr_append(char* s, const char* add, size_t n);
+
+// Remplace le contenu en réutilisant le buffer quand c'est possible.
+// Consomme la référence 's' et retourne la nouvelle.
+char* rstr_assign(char* s, const char* src, size_t len);
+
+// Octets occupés par les chaînes vivantes
+size_t rstr_live_bytes(void);
+
+#endif
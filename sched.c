@@ -0,0 +1,458 @@
+// sched.c - Coroutines et boucle d'événements pour SwiftFlow (async / await)
+// Chaque tâche a sa propre pile (mmap + page de garde) ; les changements de
+// contexte passent par swapcontext(). Il n'y a pas de contexte ordonnanceur
+// dédié : la tâche qui se met en attente choisit elle-même la suivante et,
+// si aucune n'est prête, fait tourner poll() pour toutes les tâches en attente
+// et déclenche les minuteurs échus (tas binaire trié par échéance).
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "common.h"
+#include "sched.h"
+
+// ======================================================
+// [SECTION] TÂCHES
+// ======================================================
+// Même profondeur de récursion que les workers (pool.c) : l'espace est
+// réservé sans être engagé, seules les pages touchées occupent de la mémoire
+#define SCHED_STACK_SIZE (64 * 1024 * 1024)
+
+typedef enum { TASK_READY, TASK_RUNNING, TASK_WAITING, TASK_DEAD } TaskState;
+
+typedef struct Task {
+    int id;
+    TaskState state;
+    ucontext_t ctx;
+    void* stack;          // mapping complet, page de garde comprise
+    SchedEntry entry;
+    void* arg;
+    // Attente en cours
+    struct pollfd* fds;
+    int nfds;
+    double deadline;      // secondes (horloge monotone), < 0 : sans délai
+    int join;             // tâche attendue, 0 sinon
+    bool parked;          // suspendue jusqu'à sched_unpark
+    int result;           // valeur de retour de sched_poll
+    struct Task* next_ready;
+} Task;
+
+static ISOLATE Task main_task = { .id = 0, .state = TASK_RUNNING, .deadline = -1 };
+static ISOLATE Task* current = NULL;       // &main_task dès le premier appel
+static ISOLATE Task** tasks = NULL;      // tâches vivantes (hors principal)
+static ISOLATE int task_count = 0;
+static ISOLATE int task_cap = 0;
+static ISOLATE int next_task_id = 1;
+static ISOLATE Task* ready_head = NULL;
+static ISOLATE Task* ready_tail = NULL;
+static ISOLATE Task* dead_task = NULL;   // pile à libérer par le contexte suivant
+static ISOLATE struct pollfd* poll_set = NULL;
+static ISOLATE int poll_cap = 0;
+static ISOLATE size_t page_size = 0;
+static ISOLATE void (*hook_save)(int id) = NULL;
+static ISOLATE void (*hook_restore)(int id) = NULL;
+
+// Chaque isolat (thread) a son propre ordonnanceur ; son contexte principal
+// est le thread lui-même
+static void attach(void) {
+    if (!current) current = &main_task;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void push_ready(Task* t) {
+    t->state = TASK_READY;
+    t->next_ready = NULL;
+    if (ready_tail) ready_tail->next_ready = t;
+    else ready_head = t;
+    ready_tail = t;
+}
+
+static Task* pop_ready(void) {
+    Task* t = ready_head;
+    if (!t) return NULL;
+    ready_head = t->next_ready;
+    if (!ready_head) ready_tail = NULL;
+    return t;
+}
+
+static Task* find_task(int id) {
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i]->id == id) return tasks[i];
+    }
+    return NULL;
+}
+
+// ======================================================
+// [SECTION] MINUTEURS
+// ======================================================
+typedef struct {
+    int id;
+    double deadline;      // secondes (horloge monotone)
+    double interval;      // > 0 : périodique
+    SchedEntry fn;
+    void* arg;
+} Timer;
+
+static ISOLATE Timer* timers = NULL;     // tas binaire : timers[0] échoit le premier
+static ISOLATE int timer_count = 0;
+static ISOLATE int timer_cap = 0;
+static ISOLATE int next_timer_id = 1;
+
+static void timer_swap(int a, int b) {
+    Timer tmp = timers[a];
+    timers[a] = timers[b];
+    timers[b] = tmp;
+}
+
+static void timer_sift_up(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (timers[parent].deadline <= timers[i].deadline) break;
+        timer_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void timer_sift_down(int i) {
+    for (;;) {
+        int left = 2 * i + 1, right = left + 1, min = i;
+        if (left < timer_count && timers[left].deadline < timers[min].deadline) min = left;
+        if (right < timer_count && timers[right].deadline < timers[min].deadline) min = right;
+        if (min == i) break;
+        timer_swap(i, min);
+        i = min;
+    }
+}
+
+static void timer_push(Timer t) {
+    if (timer_count == timer_cap) {
+        timer_cap = timer_cap ? timer_cap * 2 : 16;
+        timers = realloc(timers, timer_cap * sizeof(Timer));
+        if (!timers) { fprintf(stderr, "%s[FATAL]%s Out of memory (timers)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    timers[timer_count] = t;
+    timer_sift_up(timer_count++);
+}
+
+static Timer timer_remove(int i) {
+    Timer t = timers[i];
+    timers[i] = timers[--timer_count];
+    if (i < timer_count) {
+        timer_sift_up(i);
+        timer_sift_down(i);
+    }
+    return t;
+}
+
+// Déclenche les minuteurs échus ; un périodique est replanifié avant son
+// rappel (qui peut donc l'annuler)
+static void fire_timers(double now) {
+    while (timer_count > 0 && timers[0].deadline <= now) {
+        Timer t = timer_remove(0);
+        if (t.interval > 0) {
+            Timer next = t;
+            next.deadline += t.interval;
+            if (next.deadline <= now) next.deadline = now + t.interval; // retard rattrapé sans rafale
+            timer_push(next);
+        }
+        t.fn(t.arg);
+    }
+}
+
+static void free_dead(void) {
+    if (!dead_task) return;
+    munmap(dead_task->stack, SCHED_STACK_SIZE + page_size);
+    free(dead_task);
+    dead_task = NULL;
+}
+
+// ======================================================
+// [SECTION] BOUCLE D'ÉVÉNEMENTS
+// ======================================================
+static void switch_to(Task* next) {
+    Task* prev = current;
+    next->state = TASK_RUNNING;
+    if (next == prev) return;
+    if (hook_save && prev->state != TASK_DEAD) hook_save(prev->id);
+    current = next;
+    swapcontext(&prev->ctx, &next->ctx);
+    // Reprise de prev
+    free_dead();
+    if (hook_restore) hook_restore(current->id);
+}
+
+// Un tour de poll() pour toutes les tâches en attente d'un fd ou d'un délai.
+// Faux si aucune ne peut être réveillée (toutes attendent une autre tâche).
+static bool wait_events(void) {
+    int total = 0;
+    double deadline = -1;
+    bool any = false;
+    for (int i = -1; i < task_count; i++) {
+        Task* t = i < 0 ? &main_task : tasks[i];
+        if (t->state != TASK_WAITING || t->join || t->parked) continue;
+        any = true;
+        total += t->nfds;
+        if (t->deadline >= 0 && (deadline < 0 || t->deadline < deadline)) deadline = t->deadline;
+    }
+    if (timer_count > 0) {
+        any = true;
+        if (deadline < 0 || timers[0].deadline < deadline) deadline = timers[0].deadline;
+    }
+    if (!any) return false;
+
+    if (total > poll_cap) {
+        poll_cap = total * 2;
+        poll_set = realloc(poll_set, poll_cap * sizeof(struct pollfd));
+        if (!poll_set) { fprintf(stderr, "%s[FATAL]%s Out of memory (scheduler)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    int n = 0;
+    for (int i = -1; i < task_count; i++) {
+        Task* t = i < 0 ? &main_task : tasks[i];
+        if (t->state != TASK_WAITING || t->join || t->parked) continue;
+        for (int k = 0; k < t->nfds; k++) poll_set[n++] = t->fds[k];
+    }
+
+    int timeout = -1;
+    if (deadline >= 0) {
+        double left = deadline - now_seconds();
+        timeout = left <= 0 ? 0 : (int)ceil(left * 1000.0);
+    }
+    if (poll(poll_set, (nfds_t)n, timeout) < 0 && errno != EINTR) {
+        fprintf(stderr, "%s[SCHED ERROR]%s poll failed: %s\n", COLOR_RED, COLOR_RESET, strerror(errno));
+    }
+
+    double now = now_seconds();
+    fire_timers(now);
+    n = 0;
+    for (int i = -1; i < task_count; i++) {
+        Task* t = i < 0 ? &main_task : tasks[i];
+        if (t->state != TASK_WAITING || t->join || t->parked) continue;
+        int ready = 0;
+        for (int k = 0; k < t->nfds; k++) {
+            t->fds[k].revents = poll_set[n++].revents;
+            if (t->fds[k].revents) ready++;
+        }
+        if (ready > 0 || (t->deadline >= 0 && now >= t->deadline)) {
+            t->result = ready;
+            push_ready(t);
+        }
+    }
+    return true;
+}
+
+// Passe la main à la prochaine tâche prête (éventuellement la courante)
+static void schedule(void) {
+    for (;;) {
+        Task* next = pop_ready();
+        if (next) {
+            switch_to(next);
+            return;
+        }
+        if (!wait_events()) {
+            fprintf(stderr, "%s[SCHED ERROR]%s Deadlock: every task is awaiting another task or a lock\n",
+                    COLOR_RED, COLOR_RESET);
+            exit(1);
+        }
+    }
+}
+
+static void trampoline(void) {
+    Task* self = current;
+    free_dead();
+    self->entry(self->arg);
+
+    // Fin de la tâche : réveil des tâches qui l'attendent, la pile est libérée
+    // par le contexte qui prend la suite
+    self->state = TASK_DEAD;
+    for (int i = -1; i < task_count; i++) {
+        Task* t = i < 0 ? &main_task : tasks[i];
+        if (t->state == TASK_WAITING && t->join == self->id) {
+            t->join = 0;
+            push_ready(t);
+        }
+    }
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i] == self) {
+            tasks[i] = tasks[--task_count];
+            break;
+        }
+    }
+    dead_task = self;
+    schedule();
+}
+
+// ======================================================
+// [SECTION] API
+// ======================================================
+void sched_set_hooks(void (*save)(int id), void (*restore)(int id)) {
+    hook_save = save;
+    hook_restore = restore;
+}
+
+int sched_spawn(SchedEntry entry, void* arg) {
+    attach();
+    if (!page_size) page_size = (size_t)sysconf(_SC_PAGESIZE);
+    Task* t = calloc(1, sizeof(Task));
+    if (!t) return 0;
+    // Page de garde sous la pile : un débordement fait une erreur franche
+    t->stack = mmap(NULL, SCHED_STACK_SIZE + page_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (t->stack == MAP_FAILED) {
+        free(t);
+        return 0;
+    }
+    mprotect(t->stack, page_size, PROT_NONE);
+
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = (char*)t->stack + page_size;
+    t->ctx.uc_stack.ss_size = SCHED_STACK_SIZE;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, trampoline, 0);
+
+    if (task_count == task_cap) {
+        task_cap = task_cap ? task_cap * 2 : 16;
+        tasks = realloc(tasks, task_cap * sizeof(Task*));
+        if (!tasks) { fprintf(stderr, "%s[FATAL]%s Out of memory (scheduler)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    t->id = next_task_id++;
+    t->entry = entry;
+    t->arg = arg;
+    t->deadline = -1;
+    tasks[task_count++] = t;
+    push_ready(t);
+    return t->id;
+}
+
+int sched_current(void) {
+    attach();
+    return current->id;
+}
+
+bool sched_alive(int id) {
+    return find_task(id) != NULL;
+}
+
+int sched_task_count(void) {
+    return task_count;
+}
+
+bool sched_active(void) {
+    return task_count > 0 || timer_count > 0;
+}
+
+int sched_poll(struct pollfd* fds, int nfds, int timeout_ms) {
+    attach();
+    // Seul contexte, aucun minuteur : attente bloquante ordinaire
+    if (!sched_active()) return poll(fds, (nfds_t)nfds, timeout_ms);
+
+    if (nfds > 0) {
+        int ready = poll(fds, (nfds_t)nfds, 0);
+        if (ready != 0 || timeout_ms == 0) return ready;
+    } else if (timeout_ms == 0) {
+        sched_yield();
+        return 0;
+    }
+    current->fds = fds;
+    current->nfds = nfds;
+    current->deadline = timeout_ms < 0 ? -1 : now_seconds() + timeout_ms / 1000.0;
+    current->result = 0;
+    current->state = TASK_WAITING;
+    schedule();
+    current->fds = NULL;
+    current->nfds = 0;
+    current->deadline = -1;
+    return current->result;
+}
+
+bool sched_wait_fd(int fd, short events) {
+    struct pollfd p = { fd, events, 0 };
+    return sched_poll(&p, 1, -1) > 0;
+}
+
+void sched_sleep(double seconds) {
+    attach();
+    if (seconds <= 0) {
+        sched_yield();
+        return;
+    }
+    if (!sched_active()) {
+        struct timespec ts = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+        while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {}
+        return;
+    }
+    current->deadline = now_seconds() + seconds;
+    current->state = TASK_WAITING;
+    schedule();
+    current->deadline = -1;
+}
+
+void sched_join(int id) {
+    attach();
+    if (id == current->id || !find_task(id)) return;
+    current->join = id;
+    current->state = TASK_WAITING;
+    schedule();
+}
+
+void sched_park(void) {
+    attach();
+    current->parked = true;
+    current->state = TASK_WAITING;
+    schedule();
+}
+
+void sched_unpark(int id) {
+    attach();
+    Task* t = id == 0 ? &main_task : find_task(id);
+    if (!t || !t->parked) return;
+    t->parked = false;
+    push_ready(t);
+}
+
+void sched_yield(void) {
+    attach();
+    if (!ready_head) return;
+    push_ready(current);
+    schedule();
+}
+
+void sched_drain(void) {
+    attach();
+    for (;;) {
+        if (task_count > 0) {
+            sched_join(tasks[0]->id);
+        } else if (timer_count > 0) {
+            // Rien d'autre à faire : attente du prochain minuteur
+            double left = timers[0].deadline - now_seconds();
+            sched_sleep(left > 0 ? left : 0);
+            if (left <= 0) fire_timers(now_seconds());
+        } else {
+            break;
+        }
+    }
+}
+
+int sched_timer_add(double delay, double interval, SchedEntry fn, void* arg) {
+    Timer t = { next_timer_id++, now_seconds() + (delay > 0 ? delay : 0), interval, fn, arg };
+    timer_push(t);
+    return t.id;
+}
+
+void* sched_timer_cancel(int id) {
+    for (int i = 0; i < timer_count; i++) {
+        if (timers[i].id == id) return timer_remove(i).arg;
+    }
+    return NULL;
+}
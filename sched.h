@@ -0,0 +1,52 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdbool.h>
+#include <poll.h>
+
+// ============================================================
+// COROUTINES ET BOUCLE D'ÉVÉNEMENTS
+// Tâches à pile propre (ucontext) ordonnancées sur un seul thread. Une tâche
+// qui attend une E/S, un délai ou la fin d'une autre tâche cède la main ; la
+// boucle poll() réveille celles dont l'attente est satisfaite. Le contexte
+// principal (id 0) attend de la même façon. Sans autre tâche, les attentes
+// se réduisent à l'appel bloquant habituel.
+// ============================================================
+
+typedef void (*SchedEntry)(void* arg);
+
+// État propre à chaque tâche (celui de l'interpréteur) : save(id) avant de
+// quitter une tâche, restore(id) quand elle reprend la main
+void sched_set_hooks(void (*save)(int id), void (*restore)(int id));
+
+// Nouvelle tâche, démarrée au prochain point d'attente. Retourne son id (> 0),
+// 0 en cas d'échec
+int sched_spawn(SchedEntry entry, void* arg);
+
+int sched_current(void);       // 0 : contexte principal
+bool sched_alive(int id);      // tâche créée et pas encore terminée
+int sched_task_count(void);    // tâches vivantes, hors contexte principal
+bool sched_active(void);       // tâches ou minuteurs en cours
+
+// Attentes coopératives : les autres tâches s'exécutent pendant ce temps
+int sched_poll(struct pollfd* fds, int nfds, int timeout_ms); // comme poll()
+bool sched_wait_fd(int fd, short events);
+void sched_sleep(double seconds);
+void sched_join(int id);
+void sched_yield(void);
+
+// Suspend la tâche courante jusqu'à sched_unpark(id) par une autre (verrous)
+void sched_park(void);
+void sched_unpark(int id);
+
+// Minuteur : fn(arg) est appelé par la boucle d'événements après 'delay'
+// secondes, puis toutes les 'interval' secondes si interval > 0. Le rappel
+// ne doit pas attendre (il peut lancer une tâche). Retourne l'id (> 0)
+int sched_timer_add(double delay, double interval, SchedEntry fn, void* arg);
+// Retire le minuteur ; retourne son arg, NULL s'il n'existe plus
+void* sched_timer_cancel(int id);
+
+// Exécute les tâches et minuteurs restants jusqu'à leur fin (fin du script)
+void sched_drain(void);
+
+#endif
@@ -8,6 +8,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "common.h"
 #include "stdlib.h"
 
@@ -37,6 +38,389 @@ double std_math_const(int type) {
     return 0.0;
 }
 
+// ======================================================
+// [SECTION] MATH VECTORIEL
+// ======================================================
+// Noyaux des tableaux typés. Sur x86-64, SSE2 est toujours disponible ;
+// AVX2 est détecté au premier appel (__builtin_cpu_supports). Ailleurs, ou
+// avec SWIFT_SIMD=scalar, les boucles scalaires sont utilisées. Les sommes
+// vectorielles additionnent dans un ordre différent de la boucle scalaire :
+// le dernier bit d'un résultat float64 peut varier d'un backend à l'autre.
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define VEC_X86 1
+#define VEC_AVX2 __attribute__((target("avx2")))
+#else
+#define VEC_X86 0
+#endif
+
+typedef enum { VEC_UNSET, VEC_SCALAR, VEC_SSE2, VEC_AVX2_LEVEL } VecLevel;
+static ISOLATE VecLevel vec_level = VEC_UNSET;
+
+static VecLevel vec_get_level(void) {
+    if (vec_level != VEC_UNSET) return vec_level;
+    const char* forced = getenv("SWIFT_SIMD");
+    vec_level = VEC_SCALAR;
+#if VEC_X86
+    if (!forced || strcmp(forced, "scalar") != 0) {
+        vec_level = VEC_SSE2;
+        __builtin_cpu_init();
+        if ((!forced || strcmp(forced, "avx2") == 0) && __builtin_cpu_supports("avx2")) {
+            vec_level = VEC_AVX2_LEVEL;
+        }
+    }
+#else
+    (void)forced;
+#endif
+    return vec_level;
+}
+
+const char* std_vec_backend(void) {
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: return "avx2";
+        case VEC_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+static double f64_apply(int op, double x, double y) {
+    switch (op) {
+        case TK_PLUS: return x + y;
+        case TK_MINUS: return x - y;
+        case TK_MULT: return x * y;
+        default: return x / y;
+    }
+}
+
+static int64_t i64_apply(int op, int64_t x, int64_t y) {
+    switch (op) {
+        case TK_PLUS: return (int64_t)((uint64_t)x + (uint64_t)y);
+        case TK_MINUS: return (int64_t)((uint64_t)x - (uint64_t)y);
+        default: return (int64_t)((uint64_t)x * (uint64_t)y);
+    }
+}
+
+// --- Boucles scalaires (et fins de tableaux) ---
+static double sum_f64_scalar(const double* a, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += a[i];
+    return s;
+}
+
+static double dot_f64_scalar(const double* a, const double* b, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; i++) s += a[i] * b[i];
+    return s;
+}
+
+static double minmax_f64_scalar(const double* a, size_t n, bool want_max) {
+    double m = a[0];
+    for (size_t i = 1; i < n; i++) {
+        if (want_max ? a[i] > m : a[i] < m) m = a[i];
+    }
+    return m;
+}
+
+static int64_t minmax_i64_scalar(const int64_t* a, size_t n, bool want_max) {
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) {
+        if (want_max ? a[i] > m : a[i] < m) m = a[i];
+    }
+    return m;
+}
+
+#if VEC_X86
+// --- SSE2 (2 x float64, 2 x int64) ---
+static double sum_f64_sse2(const double* a, size_t n) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(a + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(a + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + sum_f64_scalar(a + i, n - i);
+}
+
+static double dot_f64_sse2(const double* a, const double* b, size_t n) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + dot_f64_scalar(a + i, b + i, n - i);
+}
+
+static double minmax_f64_sse2(const double* a, size_t n, bool want_max) {
+    if (n < 2) return minmax_f64_scalar(a, n, want_max);
+    __m128d m = _mm_loadu_pd(a);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i);
+        m = want_max ? _mm_max_pd(m, x) : _mm_min_pd(m, x);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    double r = want_max ? (lanes[0] > lanes[1] ? lanes[0] : lanes[1])
+                        : (lanes[0] < lanes[1] ? lanes[0] : lanes[1]);
+    for (; i < n; i++) {
+        if (want_max ? a[i] > r : a[i] < r) r = a[i];
+    }
+    return r;
+}
+
+static void op_f64_sse2(int op, const double* a, const double* b, double s, double* out, size_t n) {
+    __m128d vs = _mm_set1_pd(s);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i);
+        __m128d y = b ? _mm_loadu_pd(b + i) : vs;
+        __m128d r;
+        switch (op) {
+            case TK_PLUS: r = _mm_add_pd(x, y); break;
+            case TK_MINUS: r = _mm_sub_pd(x, y); break;
+            case TK_MULT: r = _mm_mul_pd(x, y); break;
+            default: r = _mm_div_pd(x, y); break;
+        }
+        _mm_storeu_pd(out + i, r);
+    }
+    for (; i < n; i++) out[i] = f64_apply(op, a[i], b ? b[i] : s);
+}
+
+static int64_t sum_i64_sse2(const int64_t* a, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) acc = _mm_add_epi64(acc, _mm_loadu_si128((const __m128i*)(a + i)));
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    int64_t s = (int64_t)((uint64_t)lanes[0] + (uint64_t)lanes[1]);
+    for (; i < n; i++) s = (int64_t)((uint64_t)s + (uint64_t)a[i]);
+    return s;
+}
+
+// Pas de multiplication 64 bits avant AVX-512 : TK_MULT reste scalaire
+static void op_i64_sse2(int op, const int64_t* a, const int64_t* b, int64_t s, int64_t* out, size_t n) {
+    size_t i = 0;
+    if (op == TK_PLUS || op == TK_MINUS) {
+        __m128i vs = _mm_set1_epi64x(s);
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+            __m128i y = b ? _mm_loadu_si128((const __m128i*)(b + i)) : vs;
+            __m128i r = op == TK_PLUS ? _mm_add_epi64(x, y) : _mm_sub_epi64(x, y);
+            _mm_storeu_si128((__m128i*)(out + i), r);
+        }
+    }
+    for (; i < n; i++) out[i] = i64_apply(op, a[i], b ? b[i] : s);
+}
+
+// --- AVX2 (4 x float64, 4 x int64) ---
+VEC_AVX2 static double sum_f64_avx2(const double* a, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(a + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_f64_scalar(a + i, n - i);
+}
+
+VEC_AVX2 static double dot_f64_avx2(const double* a, const double* b, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dot_f64_scalar(a + i, b + i, n - i);
+}
+
+VEC_AVX2 static double minmax_f64_avx2(const double* a, size_t n, bool want_max) {
+    if (n < 4) return minmax_f64_scalar(a, n, want_max);
+    __m256d m = _mm256_loadu_pd(a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        m = want_max ? _mm256_max_pd(m, x) : _mm256_min_pd(m, x);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    double r = minmax_f64_scalar(lanes, 4, want_max);
+    for (; i < n; i++) {
+        if (want_max ? a[i] > r : a[i] < r) r = a[i];
+    }
+    return r;
+}
+
+VEC_AVX2 static void op_f64_avx2(int op, const double* a, const double* b, double s, double* out, size_t n) {
+    __m256d vs = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        __m256d y = b ? _mm256_loadu_pd(b + i) : vs;
+        __m256d r;
+        switch (op) {
+            case TK_PLUS: r = _mm256_add_pd(x, y); break;
+            case TK_MINUS: r = _mm256_sub_pd(x, y); break;
+            case TK_MULT: r = _mm256_mul_pd(x, y); break;
+            default: r = _mm256_div_pd(x, y); break;
+        }
+        _mm256_storeu_pd(out + i, r);
+    }
+    for (; i < n; i++) out[i] = f64_apply(op, a[i], b ? b[i] : s);
+}
+
+VEC_AVX2 static int64_t sum_i64_avx2(const int64_t* a, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i*)(a + i)));
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    uint64_t s = (uint64_t)lanes[0] + (uint64_t)lanes[1] + (uint64_t)lanes[2] + (uint64_t)lanes[3];
+    for (; i < n; i++) s += (uint64_t)a[i];
+    return (int64_t)s;
+}
+
+VEC_AVX2 static int64_t minmax_i64_avx2(const int64_t* a, size_t n, bool want_max) {
+    if (n < 4) return minmax_i64_scalar(a, n, want_max);
+    __m256i m = _mm256_loadu_si256((const __m256i*)a);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i x_gt = _mm256_cmpgt_epi64(x, m);
+        m = _mm256_blendv_epi8(want_max ? m : x, want_max ? x : m, x_gt);
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, m);
+    int64_t r = minmax_i64_scalar(lanes, 4, want_max);
+    for (; i < n; i++) {
+        if (want_max ? a[i] > r : a[i] < r) r = a[i];
+    }
+    return r;
+}
+
+VEC_AVX2 static void op_i64_avx2(int op, const int64_t* a, const int64_t* b, int64_t s, int64_t* out, size_t n) {
+    size_t i = 0;
+    if (op == TK_PLUS || op == TK_MINUS) {
+        __m256i vs = _mm256_set1_epi64x(s);
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i y = b ? _mm256_loadu_si256((const __m256i*)(b + i)) : vs;
+            __m256i r = op == TK_PLUS ? _mm256_add_epi64(x, y) : _mm256_sub_epi64(x, y);
+            _mm256_storeu_si256((__m256i*)(out + i), r);
+        }
+    }
+    for (; i < n; i++) out[i] = i64_apply(op, a[i], b ? b[i] : s);
+}
+#endif
+
+// --- Points d'entrée (dispatch) ---
+double std_vec_sum_f64(const double* a, size_t n) {
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: return sum_f64_avx2(a, n);
+        case VEC_SSE2: return sum_f64_sse2(a, n);
+        default: break;
+    }
+#endif
+    return sum_f64_scalar(a, n);
+}
+
+double std_vec_dot_f64(const double* a, const double* b, size_t n) {
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: return dot_f64_avx2(a, b, n);
+        case VEC_SSE2: return dot_f64_sse2(a, b, n);
+        default: break;
+    }
+#endif
+    return dot_f64_scalar(a, b, n);
+}
+
+static double minmax_f64(const double* a, size_t n, bool want_max) {
+    if (n == 0) return 0.0;
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: return minmax_f64_avx2(a, n, want_max);
+        case VEC_SSE2: return minmax_f64_sse2(a, n, want_max);
+        default: break;
+    }
+#endif
+    return minmax_f64_scalar(a, n, want_max);
+}
+
+double std_vec_min_f64(const double* a, size_t n) { return minmax_f64(a, n, false); }
+double std_vec_max_f64(const double* a, size_t n) { return minmax_f64(a, n, true); }
+
+static void op_f64(int op, const double* a, const double* b, double s, double* out, size_t n) {
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: op_f64_avx2(op, a, b, s, out, n); return;
+        case VEC_SSE2: op_f64_sse2(op, a, b, s, out, n); return;
+        default: break;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) out[i] = f64_apply(op, a[i], b ? b[i] : s);
+}
+
+void std_vec_op_f64(int op, const double* a, const double* b, double* out, size_t n) {
+    op_f64(op, a, b, 0.0, out, n);
+}
+
+void std_vec_op_scalar_f64(int op, const double* a, double s, double* out, size_t n) {
+    op_f64(op, a, NULL, s, out, n);
+}
+
+int64_t std_vec_sum_i64(const int64_t* a, size_t n) {
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: return sum_i64_avx2(a, n);
+        case VEC_SSE2: return sum_i64_sse2(a, n);
+        default: break;
+    }
+#endif
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) s += (uint64_t)a[i];
+    return (int64_t)s;
+}
+
+static int64_t minmax_i64(const int64_t* a, size_t n, bool want_max) {
+    if (n == 0) return 0;
+#if VEC_X86
+    if (vec_get_level() == VEC_AVX2_LEVEL) return minmax_i64_avx2(a, n, want_max);
+#endif
+    return minmax_i64_scalar(a, n, want_max); // SSE2 n'a pas de comparaison 64 bits
+}
+
+int64_t std_vec_min_i64(const int64_t* a, size_t n) { return minmax_i64(a, n, false); }
+int64_t std_vec_max_i64(const int64_t* a, size_t n) { return minmax_i64(a, n, true); }
+
+static void op_i64(int op, const int64_t* a, const int64_t* b, int64_t s, int64_t* out, size_t n) {
+#if VEC_X86
+    switch (vec_get_level()) {
+        case VEC_AVX2_LEVEL: op_i64_avx2(op, a, b, s, out, n); return;
+        case VEC_SSE2: op_i64_sse2(op, a, b, s, out, n); return;
+        default: break;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) out[i] = i64_apply(op, a[i], b ? b[i] : s);
+}
+
+void std_vec_op_i64(int op, const int64_t* a, const int64_t* b, int64_t* out, size_t n) {
+    op_i64(op, a, b, 0, out, n);
+}
+
+void std_vec_op_scalar_i64(int op, const int64_t* a, int64_t s, int64_t* out, size_t n) {
+    op_i64(op, a, NULL, s, out, n);
+}
+
 // ======================================================
 // [SECTION] STRING MODULE
 // ======================================================
@@ -130,6 +514,20 @@ double std_time_now(void) {
     return (double)time(NULL);
 }
 
+// Horloge monotone (nanosecondes) : mesure de durées, insensible aux réglages de l'heure
+double std_time_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Même horloge en secondes (fractionnaires)
+double std_time_perf(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
 void std_time_sleep(double seconds) {
     usleep((useconds_t)(seconds * 1000000));
 }
@@ -13,6 +13,22 @@ char* std_crypto_b64dec(const char* data);
 double std_math_const(int type);
 double std_math_calc(int op_type, double val1, double val2);
 
+// Math vectoriel (tableaux typés float64 / int64). Noyaux SSE2 ou AVX2
+// choisis à l'exécution ; SWIFT_SIMD=avx2|sse2|scalar force le choix.
+// op : TK_PLUS, TK_MINUS, TK_MULT, TK_DIV (TK_DIV : float64 uniquement)
+const char* std_vec_backend(void);
+double std_vec_sum_f64(const double* a, size_t n);
+double std_vec_min_f64(const double* a, size_t n);
+double std_vec_max_f64(const double* a, size_t n);
+double std_vec_dot_f64(const double* a, const double* b, size_t n);
+void std_vec_op_f64(int op, const double* a, const double* b, double* out, size_t n);
+void std_vec_op_scalar_f64(int op, const double* a, double s, double* out, size_t n);
+int64_t std_vec_sum_i64(const int64_t* a, size_t n);
+int64_t std_vec_min_i64(const int64_t* a, size_t n);
+int64_t std_vec_max_i64(const int64_t* a, size_t n);
+void std_vec_op_i64(int op, const int64_t* a, const int64_t* b, int64_t* out, size_t n);
+void std_vec_op_scalar_i64(int op, const int64_t* a, int64_t s, int64_t* out, size_t n);
+
 // String
 char* std_str_upper(const char* s);
 char* std_str_lower(const char* s);
@@ -21,6 +37,8 @@ char* std_str_sub(const char* s, int start, int len);
 
 // Time
 double std_time_now(void);
+double std_time_now_ns(void);
+double std_time_perf(void);
 void std_time_sleep(double seconds);
 
 // Encoding
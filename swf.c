@@ -7,6 +7,12 @@
 #include "json.h" // on déclare le prototype ici
 #include "net.h"
 #include "io.h"
+#include "aio.h"
+#include "sched.h"
+#include "pool.h"
+#include "chan.h"
+#include "rstr.h"
+#include "intern.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
@@ -21,15 +27,20 @@
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <fcntl.h>  
+#include <poll.h>
+#include <signal.h>
 #include "common.h"
 
 // ======================================================
 // [SECTION] GLOBAL STATE
 // ======================================================
-static char current_working_dir[PATH_MAX];
+static ISOLATE char current_working_dir[PATH_MAX];
 extern ASTNode** parse(const char* source, int* count);
+extern void parser_set_quiet(bool enabled);
+extern int parser_parallel_index(ASTNode* node);
+extern ASTNode* parser_parallel_node(int index);
 static char* generateLambdaName();
-static const char* current_exec_filename = "main";
+static ISOLATE const char* current_exec_filename = "main";
 
 void runtime_error(ASTNode* node, const char* fmt, ...) {
     va_list args;
@@ -69,6 +80,7 @@ void io_listdir(ASTNode* node);
 // ======================================================
 typedef struct {
     char name[100];
+    int sym;          // Symbole interné de name : les recherches comparent des entiers
     TokenKind type;
     int size_bytes;
     union {
@@ -84,12 +96,21 @@ typedef struct {
     int scope_level;
     char* module;
     bool is_exported;
-    bool is_locked;
 } Variable;
 
-static Variable vars[1000];
-static int var_count = 0;
-static int scope_level = 0;
+// Zone du programme principal, puis une zone par tâche async (voir
+// [SECTION] TÂCHES ASYNC) : une tâche suspendue garde ses variables locales
+// pendant que les autres s'exécutent. Une zone n'occupe de mémoire que pour
+// les pages réellement utilisées (voir [SECTION] STOCKAGE DE L'ISOLAT) : elle
+// est dimensionnée pour une récursion profonde dans une tâche, comme sa pile
+#define MAIN_VARS 1000
+#define MAX_TASKS 256
+#define TASK_VARS 4096
+static ISOLATE Variable* vars = NULL; // MAIN_VARS + MAX_TASKS * TASK_VARS (IsolateStorage)
+static ISOLATE int var_count = 0;
+static ISOLATE int var_floor = 0;          // début de la zone courante
+static ISOLATE int var_limit = MAIN_VARS;  // fin de la zone courante
+static ISOLATE int scope_level = 0;
 // ======================================================
 // [SECTION] EXPORT SYSTEM
 // ======================================================
@@ -100,8 +121,8 @@ typedef struct {
     char* module;
 } ExportEntry;
 
-static ExportEntry exports[100];
-static int export_count = 0;
+static ISOLATE ExportEntry exports[100];
+static ISOLATE int export_count = 0;
 
 static void registerExport(const char* symbol, const char* alias) {
     if (export_count < 100) {
@@ -120,6 +141,7 @@ static void registerExport(const char* symbol, const char* alias) {
 // ======================================================
 typedef struct {
     char name[100];
+    int sym;
     ASTNode* params;
     ASTNode* body;
     int param_count;
@@ -128,11 +150,13 @@ typedef struct {
     double return_value;
     char* return_string;
     bool has_returned;
+    bool is_async;       // 'async func' : un appel lance une tâche
 } Function;
 
-static Function functions[200];
-static int func_count = 0;
-static Function* current_function = NULL;
+#define MAX_FUNCTIONS 200
+static ISOLATE Function* functions = NULL; // MAX_FUNCTIONS (IsolateStorage)
+static ISOLATE int func_count = 0;
+static ISOLATE Function* current_function = NULL;
 
 // ======================================================
 // [SECTION] CLASS SYSTEM
@@ -143,8 +167,9 @@ typedef struct {
     ASTNode* members;
 } Class;
 
-static Class classes[100];
-static int class_count = 0;
+#define MAX_CLASSES 100
+static ISOLATE Class* classes = NULL; // MAX_CLASSES (IsolateStorage)
+static ISOLATE int class_count = 0;
 
 // ======================================================
 // [SECTION] IMPORT SYSTEM (ADVANCED)
@@ -153,32 +178,685 @@ static int class_count = 0;
 // [SECTION] OOP RUNTIME
 // ======================================================
 
+// Les objets sont référencés par leur identifiant "inst_N" (valeur string),
+// N étant la clé de la table des objets vivants. Leurs propriétés vivent dans
+// des slots ; la forme (Shape) partagée par les objets construits de la même
+// façon associe chaque nom de propriété à son numéro de slot.
+#define OBJ_INLINE_SLOTS 8
+
+typedef struct Shape {
+    int class_sym;
+    int count;                 // nombre de propriétés (= slots utilisés)
+    int* names;                // symbole de la propriété de chaque slot
+    struct Shape* parent;
+    struct Shape** children;   // transitions : ajout d'une propriété
+    int child_count;
+} Shape;
+
+typedef struct SlotChunk {
+    Variable slots[OBJ_INLINE_SLOTS];
+    struct SlotChunk* next;
+} SlotChunk;
+
+// En-tête commun des valeurs du tas (objets, listes, maps, tableaux typés)
+// gérées par le GC
+typedef enum { HEAP_OBJECT, HEAP_LIST, HEAP_MAP, HEAP_ARRAY, HEAP_TASK, HEAP_FUTURE, HEAP_CHAN, HEAP_PROC } HeapKind;
+
 typedef struct {
-    char id[64];      // ex: "inst_1"
+    int id;
+    HeapKind kind;
+    unsigned gc_epoch;   // cycle du GC où la valeur a été marquée (ou créée)
+    size_t bytes;
+} HeapHeader;
+
+// Préfixe de l'identifiant de chaque sorte : "inst_N", "list_N", "map_N", "arr_N",
+// "task_N", "future_N", "chan_N", "proc_N"
+static const char* heap_prefix[] = { "inst_", "list_", "map_", "arr_", "task_", "future_", "chan_", "proc_" };
+
+typedef struct {
+    HeapHeader gc;
+    int class_sym;
     char class_name[64]; // ex: "Zarch"
-} InstanceRegistry;
+    Shape* shape;
+    Variable slots[OBJ_INLINE_SLOTS]; // premiers slots dans l'objet lui-même
+    SlotChunk* more;                  // suivants, par blocs (adresses stables)
+} Object;
+
+// Valeur typée calculée avant d'être rangée dans une variable ou une liste
+typedef struct {
+    bool is_string;
+    bool is_int;   // booléens et entiers déclarés (var x: int), rangés dans int_val
+    char* str;     // rstr possédée
+    double num;
+} EvalValue;
+
+// Liste : valeurs contiguës, capacité doublée à chaque agrandissement
+typedef struct {
+    HeapHeader gc;
+    EvalValue* items;
+    int count;
+    int cap;
+} List;
+
+// Map : entrées rangées dans l'ordre d'insertion, retrouvées par un index
+// à adressage ouvert (Robin Hood) qui ne contient que leur numéro et le hash
+typedef struct {
+    EvalValue key;
+    EvalValue value;
+    uint32_t hash;
+    bool deleted;
+} MapEntry;
+
+#define MAP_EMPTY UINT32_MAX
+
+// Tableau typé float64[] / int64[] : nombres contigus, sans étiquette de type
+typedef struct {
+    HeapHeader gc;
+    bool is_int;
+    int count;
+    int cap;
+    union {
+        double* f64;
+        int64_t* i64;
+        void* raw;
+    } data;
+} TypedArray;
+
+// Tâche lancée par l'appel d'une fonction async ; 'await' attend sa fin
+typedef struct {
+    HeapHeader gc;
+    int sched_id;
+    bool done;
+    EvalValue result;  // valeur retournée par la fonction
+} AsyncTask;
+
+// Valeur copiée d'un isolat à un autre (arguments et résultat de spawn) :
+// autonome, sans rstr ni référence au tas de l'isolat d'origine
+typedef enum { XFER_NUM, XFER_BOOL, XFER_STR, XFER_LIST, XFER_MAP, XFER_F64, XFER_I64, XFER_CHAN } TransferKind;
+
+typedef struct Transfer {
+    TransferKind kind;
+    double num;
+    char* data;               // chaîne, ou contenu d'un tableau typé
+    size_t len;               // octets
+    struct Transfer* items;   // liste ; map : clé, valeur, clé, valeur...
+    int count;
+    Channel* chan;            // canal partagé (référence détenue)
+} Transfer;
+
+// Job soumis au pool, partagé entre l'isolat demandeur et le worker : le
+// dernier des deux qui le lâche le libère. JOB_CALL : spawn(f, args...) ;
+// JOB_MAP : tranche de list.pmap(f) ; JOB_LOOP : tranche d'un parallel for
+typedef enum { JOB_CALL, JOB_MAP, JOB_LOOP } JobKind;
+
+typedef struct {
+    int refs;
+    int done;                 // lu et écrit par __atomic
+    JobKind kind;
+    char func_name[100];      // CALL, MAP
+    Transfer* args;           // CALL : arguments ; LOOP : variables capturées,
+    int arg_count;            //   prêtées par le demandeur jusqu'à la fin du job
+    const char** names;       // LOOP : noms des variables capturées (prêtés)
+    int loop_index;           // LOOP : boucle (parser_parallel_node) et sa position
+    int loop_line;
+    int loop_column;
+    bool is_range;            // LOOP : tours [from, to) de l'intervalle, sinon items
+    double start;
+    long from;
+    long to;
+    Transfer items;           // MAP, LOOP sur liste : éléments de la tranche
+    Transfer result;
+    int notify_fd;            // tube de l'isolat demandeur, un octet à la fin
+} Future;
+
+typedef struct {
+    HeapHeader gc;
+    Future* future;
+} FutureRef;
+
+// Canal (chan.c) vu depuis un isolat ; le même canal peut avoir une
+// référence dans plusieurs isolats
+typedef struct {
+    HeapHeader gc;
+    Channel* chan;
+} ChanRef;
+
+// Processus enfant lancé par sys.spawn (sys.c)
+typedef struct {
+    HeapHeader gc;
+    SysProc* proc;
+} ProcRef;
+
+static void releaseFuture(Future* future);
 
-static InstanceRegistry instances[200];
-static int instance_count = 0;
-static char* current_this = NULL; // Pour stocker "inst_X" lors d'un appel de méthode
+typedef struct {
+    uint32_t entry;   // numéro dans entries, MAP_EMPTY si libre
+    uint32_t hash;
+} MapSlot;
+
+typedef struct {
+    HeapHeader gc;
+    MapEntry* entries;
+    int entry_count;  // entrées utilisées, supprimées comprises
+    int entry_cap;
+    int count;        // clés présentes
+    MapSlot* slots;
+    uint32_t slot_mask;
+} Map;
+
+// Valeurs du tas indexées par N, adressage ouvert. Les identifiants ne sont
+// jamais réutilisés : une référence vers une valeur collectée ne retrouve
+// plus rien au lieu de désigner une autre valeur.
+#define HEAP_TOMBSTONE ((HeapHeader*)1)
+static ISOLATE HeapHeader** heap_table = NULL;
+static ISOLATE size_t heap_table_size = 0;
+static ISOLATE size_t heap_live = 0;
+static ISOLATE size_t heap_used = 0;   // vivantes + pierres tombales
+static ISOLATE int next_heap_id = 0;
+
+// [GC] Compteurs et seuil de déclenchement (octets alloués sur le tas)
+#define GC_MIN_THRESHOLD (1 << 20)
+#define GC_SWEEP_STEP 256         // entrées de la table balayées par point sûr
+typedef struct {
+    size_t collections;
+    size_t freed_objects;
+    size_t object_bytes;
+    double pause_last_us;
+    double pause_max_us;
+    double pause_total_us;
+} GcStats;
+static ISOLATE GcStats gc_stats;
+static ISOLATE size_t gc_threshold = GC_MIN_THRESHOLD;
+static ISOLATE unsigned gc_epoch = 1;
+static ISOLATE bool gc_pending = false;
+static ISOLATE size_t gc_sweep_pos = 0;
+static ISOLATE bool gc_sweeping = false;
+
+static void gcAccount(size_t bytes) {
+    gc_stats.object_bytes += bytes;
+    if (gc_stats.object_bytes >= gc_threshold) gc_pending = true;
+}
+
+static ISOLATE Shape* root_shapes[100];
+static ISOLATE int root_shape_count = 0;
+
+static ISOLATE char* current_this = NULL; // Pour stocker "inst_X" lors d'un appel de méthode
+static ISOLATE Object* current_this_obj = NULL;
+
+static Shape* newShape(int class_sym, Shape* parent, int added) {
+    Shape* shape = calloc(1, sizeof(Shape));
+    if (!shape) { fprintf(stderr, "%s[FATAL]%s Out of memory (shape)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    shape->class_sym = class_sym;
+    shape->parent = parent;
+    shape->count = parent ? parent->count + 1 : 0;
+    if (shape->count > 0) {
+        shape->names = malloc(shape->count * sizeof(int));
+        if (parent->count) memcpy(shape->names, parent->names, parent->count * sizeof(int));
+        shape->names[shape->count - 1] = added;
+    }
+    return shape;
+}
+
+// Forme vide d'une classe
+static Shape* rootShape(int class_sym) {
+    for (int i = 0; i < root_shape_count; i++) {
+        if (root_shapes[i]->class_sym == class_sym) return root_shapes[i];
+    }
+    Shape* shape = newShape(class_sym, NULL, 0);
+    if (root_shape_count < 100) root_shapes[root_shape_count++] = shape;
+    return shape;
+}
 
-// Enregistre une instance
-static void registerInstance(const char* id, const char* class_name) {
-    if (instance_count < 200) {
-        strcpy(instances[instance_count].id, id);
-        strcpy(instances[instance_count].class_name, class_name);
-        instance_count++;
+static int shapeSlot(Shape* shape, int name) {
+    for (int i = 0; i < shape->count; i++) {
+        if (shape->names[i] == name) return i;
+    }
+    return -1;
+}
+
+// Transition vers la forme avec une propriété de plus (partagée entre objets)
+static Shape* shapeAdd(Shape* shape, int name) {
+    for (int i = 0; i < shape->child_count; i++) {
+        Shape* child = shape->children[i];
+        if (child->names[child->count - 1] == name) return child;
+    }
+    Shape* child = newShape(shape->class_sym, shape, name);
+    Shape** grown = realloc(shape->children, (shape->child_count + 1) * sizeof(Shape*));
+    if (!grown) { fprintf(stderr, "%s[FATAL]%s Out of memory (shape)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    shape->children = grown;
+    shape->children[shape->child_count++] = child;
+    return child;
+}
+
+static Variable* objectSlot(Object* obj, int index) {
+    if (index < OBJ_INLINE_SLOTS) return &obj->slots[index];
+    index -= OBJ_INLINE_SLOTS;
+    SlotChunk** chunk = &obj->more;
+    while (true) {
+        if (!*chunk) {
+            *chunk = calloc(1, sizeof(SlotChunk));
+            if (!*chunk) { fprintf(stderr, "%s[FATAL]%s Out of memory (object)\n", COLOR_RED, COLOR_RESET); exit(1); }
+            obj->gc.bytes += sizeof(SlotChunk);
+            gcAccount(sizeof(SlotChunk));
+        }
+        if (index < OBJ_INLINE_SLOTS) return &(*chunk)->slots[index];
+        index -= OBJ_INLINE_SLOTS;
+        chunk = &(*chunk)->next;
     }
 }
 
-// Trouve la classe d'une instance
-static char* findClassOf(const char* id) {
-    for(int i=0; i<instance_count; i++) {
-        if(strcmp(instances[i].id, id) == 0) return instances[i].class_name;
+static size_t heapHash(int id, size_t size) {
+    return ((uint32_t)id * 2654435761u) & (size - 1);
+}
+
+// Attribue un identifiant à une nouvelle valeur du tas et l'enregistre
+static void heapInsert(HeapHeader* h, HeapKind kind, size_t bytes) {
+    if ((heap_used + 1) * 2 >= heap_table_size) {
+        // Reconstruction sans les pierres tombales
+        size_t size = 256;
+        while (size < (heap_live + 1) * 4) size *= 2;
+        HeapHeader** table = calloc(size, sizeof(HeapHeader*));
+        if (!table) { fprintf(stderr, "%s[FATAL]%s Out of memory (heap)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        for (size_t i = 0; i < heap_table_size; i++) {
+            HeapHeader* e = heap_table[i];
+            if (!e || e == HEAP_TOMBSTONE) continue;
+            size_t slot = heapHash(e->id, size);
+            while (table[slot]) slot = (slot + 1) & (size - 1);
+            table[slot] = e;
+        }
+        free(heap_table);
+        heap_table = table;
+        heap_table_size = size;
+        heap_used = heap_live;
+        gc_sweep_pos = 0; // un balayage en cours reprend au début
+    }
+    h->id = ++next_heap_id;
+    h->kind = kind;
+    h->gc_epoch = gc_epoch; // créée pendant un balayage : survit
+    h->bytes = bytes;
+    
+    size_t slot = heapHash(h->id, heap_table_size);
+    while (heap_table[slot] && heap_table[slot] != HEAP_TOMBSTONE) slot = (slot + 1) & (heap_table_size - 1);
+    if (!heap_table[slot]) heap_used++;
+    heap_table[slot] = h;
+    heap_live++;
+    gcAccount(bytes);
+}
+
+// "inst_N" / "list_N" / "map_N" / "arr_N" -> valeur N
+static HeapHeader* heapFromId(const char* id) {
+    if (!id || !heap_table) return NULL;
+    int kind = -1;
+    size_t plen = 0;
+    for (int k = 0; k < (int)(sizeof(heap_prefix) / sizeof(heap_prefix[0])); k++) {
+        plen = strlen(heap_prefix[k]);
+        if (strncmp(id, heap_prefix[k], plen) == 0) { kind = k; break; }
+    }
+    if (kind < 0) return NULL;
+    char* end;
+    long n = strtol(id + plen, &end, 10);
+    if (*end != '\0' || n <= 0 || n > next_heap_id) return NULL;
+    size_t slot = heapHash((int)n, heap_table_size);
+    while (heap_table[slot]) {
+        HeapHeader* h = heap_table[slot];
+        if (h != HEAP_TOMBSTONE && h->id == n) return h->kind == (HeapKind)kind ? h : NULL;
+        slot = (slot + 1) & (heap_table_size - 1);
     }
     return NULL;
 }
 
+// Identifiant "inst_N" / "list_N" / "map_N" / "arr_N" en rstr
+static char* heapIdStr(HeapHeader* h) {
+    char id[32];
+    int len = snprintf(id, sizeof(id), "%s%d", heap_prefix[h->kind], h->id);
+    return rstr_new(id, (size_t)len);
+}
+
+// Crée un objet ; son identifiant "inst_N" est écrit dans id
+static Object* newObject(const char* class_name, char* id, size_t id_size) {
+    Object* obj = calloc(1, sizeof(Object));
+    if (!obj) { fprintf(stderr, "%s[FATAL]%s Out of memory (object)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    strncpy(obj->class_name, class_name ? class_name : "", 63);
+    obj->class_sym = intern(obj->class_name);
+    obj->shape = rootShape(obj->class_sym);
+    heapInsert(&obj->gc, HEAP_OBJECT, sizeof(Object));
+    
+    snprintf(id, id_size, "inst_%d", obj->gc.id);
+    return obj;
+}
+
+static Object* objectFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_OBJECT ? (Object*)h : NULL;
+}
+
+// ======================================================
+// [SECTION] CONTEXTES DES TÂCHES
+// ======================================================
+// État de l'interpréteur propre à chaque coroutine (sched.c). Le contexte 0
+// est le programme principal ; le contexte t > 0 possède la zone de variables
+// [MAIN_VARS + (t - 1) * TASK_VARS, + TASK_VARS). Les globales ci-dessus
+// décrivent toujours le contexte en cours : elles sont rangées dans la table
+// quand une tâche cède la main, et rechargées quand elle la reprend.
+typedef struct {
+    int sched_id;        // id sched.c (0 : principal ; slot de tâche libre)
+    int var_count;
+    int scope_level;
+    Function* function;
+    char* this_id;
+    Object* this_obj;
+    HeapHeader** roots;  // racines temporaires du GC (pile propre)
+    int root_count;
+    int root_cap;
+    AsyncTask* task;     // NULL pour le contexte principal
+    Function* entry;     // fonction lancée et ses arguments, jusqu'au démarrage
+    EvalValue* args;
+    int arg_count;
+} TaskContext;
+
+static ISOLATE TaskContext* task_contexts = NULL; // MAX_TASKS + 1 (IsolateStorage)
+static ISOLATE int current_context = 0;
+
+// ======================================================
+// [SECTION] STOCKAGE DE L'ISOLAT
+// ======================================================
+// Les grandes tables de l'isolat ne sont pas en __thread : la TLS statique
+// est allouée et mise à zéro pour chaque thread du processus, y compris ceux
+// qui n'exécutent jamais de script (io.walk, aio). Elles sont allouées d'un
+// bloc quand le thread exécute du script pour la première fois. Un bloc de
+// cette taille vient directement de mmap (déjà à zéro) : les pages ne sont
+// matérialisées qu'à l'usage, et les adresses ne bougent plus (les Variable*
+// restent valides quand une tâche entame sa zone).
+typedef struct {
+    Variable vars[MAIN_VARS + MAX_TASKS * TASK_VARS];
+    Function functions[MAX_FUNCTIONS];
+    Class classes[MAX_CLASSES];
+    TaskContext task_contexts[MAX_TASKS + 1];
+} IsolateStorage;
+
+static void initIsolateStorage(void) {
+    if (vars) return; // REPL : un run() par ligne
+    IsolateStorage* storage = calloc(1, sizeof(IsolateStorage));
+    if (!storage) { fprintf(stderr, "%s[FATAL]%s Out of memory (isolate)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    vars = storage->vars;
+    functions = storage->functions;
+    classes = storage->classes;
+    task_contexts = storage->task_contexts;
+}
+
+static ISOLATE HeapHeader** gc_roots = NULL;
+static ISOLATE int gc_root_count = 0;
+static ISOLATE int gc_root_cap = 0;
+
+static int contextVarBase(int t) {
+    return t == 0 ? 0 : MAIN_VARS + (t - 1) * TASK_VARS;
+}
+
+static void saveTaskContext(int sched_id) {
+    (void)sched_id; // toujours le contexte en cours
+    TaskContext* ctx = &task_contexts[current_context];
+    ctx->var_count = var_count;
+    ctx->scope_level = scope_level;
+    ctx->function = current_function;
+    ctx->this_id = current_this;
+    ctx->this_obj = current_this_obj;
+    ctx->roots = gc_roots;
+    ctx->root_count = gc_root_count;
+    ctx->root_cap = gc_root_cap;
+}
+
+static void loadTaskContext(int t) {
+    TaskContext* ctx = &task_contexts[t];
+    current_context = t;
+    var_floor = contextVarBase(t);
+    var_limit = t == 0 ? MAIN_VARS : var_floor + TASK_VARS;
+    var_count = ctx->var_count;
+    scope_level = ctx->scope_level;
+    current_function = ctx->function;
+    current_this = ctx->this_id;
+    current_this_obj = ctx->this_obj;
+    gc_roots = ctx->roots;
+    gc_root_count = ctx->root_count;
+    gc_root_cap = ctx->root_cap;
+}
+
+static void restoreTaskContext(int sched_id) {
+    for (int t = 0; t <= MAX_TASKS; t++) {
+        if (task_contexts[t].sched_id == sched_id) {
+            loadTaskContext(t);
+            return;
+        }
+    }
+}
+
+// ======================================================
+// [SECTION] GARBAGE COLLECTOR
+// ======================================================
+// Mark & sweep traçant sur les valeurs du tas (objets, listes, maps, tableaux
+// typés). Racines :
+// variables (globales, locales des frames, exports de modules), valeurs de
+// retour des fonctions, pile des 'this' et racines temporaires (arguments en
+// cours d'évaluation, objet, liste ou map dont on écrit un élément). Une
+// valeur string "inst_N" / "list_N" / "map_N" est une référence. Le marquage a lieu à un point
+// sûr (début d'instruction) ; le balayage est ensuite réparti par tranches
+// sur les points sûrs suivants. Les chaînes sont comptées par référence
+// (rstr) et libérées dès leur dernier usage : le GC ne fait que les compter
+// dans la taille du tas.
+static ISOLATE HeapHeader** gc_work = NULL;   // pile de marquage
+static ISOLATE int gc_work_count = 0;
+static ISOLATE int gc_work_cap = 0;
+static ISOLATE size_t gc_marked_bytes = 0;
+
+static void gcPushRoot(HeapHeader* h) {
+    if (gc_root_count == gc_root_cap) {
+        gc_root_cap = gc_root_cap ? gc_root_cap * 2 : 64;
+        gc_roots = realloc(gc_roots, gc_root_cap * sizeof(HeapHeader*));
+        if (!gc_roots) { fprintf(stderr, "%s[FATAL]%s Out of memory (gc)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    gc_roots[gc_root_count++] = h;
+}
+
+static void gcPopRoots(int count) {
+    gc_root_count -= count;
+}
+
+static void gcMarkHeader(HeapHeader* h) {
+    if (!h || h->gc_epoch == gc_epoch) return;
+    h->gc_epoch = gc_epoch;
+    gc_marked_bytes += h->bytes;
+    if (gc_work_count == gc_work_cap) {
+        gc_work_cap = gc_work_cap ? gc_work_cap * 2 : 256;
+        gc_work = realloc(gc_work, gc_work_cap * sizeof(HeapHeader*));
+        if (!gc_work) { fprintf(stderr, "%s[FATAL]%s Out of memory (gc)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    gc_work[gc_work_count++] = h;
+}
+
+// Valeur string pouvant référencer une valeur du tas
+static void gcMarkValue(const char* value) {
+    if (value && (value[0] == 'i' || value[0] == 'l' || value[0] == 'm' || value[0] == 'a' ||
+                  value[0] == 't' || value[0] == 'f' || value[0] == 'c' || value[0] == 'p')) {
+        gcMarkHeader(heapFromId(value));
+    }
+}
+
+static void gcMark(void) {
+    gc_epoch++;
+    gc_marked_bytes = 0;
+    
+    // Chaque contexte (programme principal, tâches async suspendues) a ses
+    // variables, son 'this' et ses racines temporaires
+    saveTaskContext(0);
+    for (int t = 0; t <= MAX_TASKS; t++) {
+        TaskContext* ctx = &task_contexts[t];
+        if (t > 0 && ctx->sched_id <= 0) continue;
+        for (int i = contextVarBase(t); i < ctx->var_count; i++) {
+            if (vars[i].is_string) gcMarkValue(vars[i].value.str_val);
+        }
+        if (ctx->this_obj) gcMarkHeader(&ctx->this_obj->gc);
+        for (int i = 0; i < ctx->root_count; i++) gcMarkHeader(ctx->roots[i]);
+        if (ctx->task) gcMarkHeader(&ctx->task->gc);
+    }
+    for (int i = 0; i < func_count; i++) gcMarkValue(functions[i].return_string);
+    
+    while (gc_work_count > 0) {
+        HeapHeader* h = gc_work[--gc_work_count];
+        if (h->kind == HEAP_OBJECT) {
+            Object* obj = (Object*)h;
+            for (int i = 0; i < obj->shape->count; i++) {
+                Variable* slot = objectSlot(obj, i);
+                if (slot->is_string) gcMarkValue(slot->value.str_val);
+            }
+        } else if (h->kind == HEAP_LIST) {
+            List* list = (List*)h;
+            for (int i = 0; i < list->count; i++) {
+                if (list->items[i].is_string) gcMarkValue(list->items[i].str);
+            }
+        } else if (h->kind == HEAP_MAP) {
+            Map* map = (Map*)h;
+            for (int i = 0; i < map->entry_count; i++) {
+                MapEntry* e = &map->entries[i];
+                if (e->deleted) continue;
+                if (e->key.is_string) gcMarkValue(e->key.str);
+                if (e->value.is_string) gcMarkValue(e->value.str);
+            }
+        } else if (h->kind == HEAP_TASK) {
+            AsyncTask* task = (AsyncTask*)h;
+            if (task->result.is_string) gcMarkValue(task->result.str);
+        }
+    }
+}
+
+static void freeHeapValue(HeapHeader* h) {
+    if (h->kind == HEAP_OBJECT) {
+        Object* obj = (Object*)h;
+        for (int i = 0; i < obj->shape->count; i++) {
+            Variable* slot = objectSlot(obj, i);
+            if (slot->is_string) rstr_release(slot->value.str_val);
+        }
+        SlotChunk* chunk = obj->more;
+        while (chunk) {
+            SlotChunk* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    } else if (h->kind == HEAP_LIST) {
+        List* list = (List*)h;
+        for (int i = 0; i < list->count; i++) {
+            if (list->items[i].is_string) rstr_release(list->items[i].str);
+        }
+        free(list->items);
+    } else if (h->kind == HEAP_MAP) {
+        Map* map = (Map*)h;
+        for (int i = 0; i < map->entry_count; i++) {
+            MapEntry* e = &map->entries[i];
+            if (e->deleted) continue;
+            rstr_release(e->key.str);
+            rstr_release(e->value.str);
+        }
+        free(map->entries);
+        free(map->slots);
+    } else if (h->kind == HEAP_TASK) {
+        rstr_release(((AsyncTask*)h)->result.str);
+    } else if (h->kind == HEAP_FUTURE) {
+        releaseFuture(((FutureRef*)h)->future);
+    } else if (h->kind == HEAP_CHAN) {
+        chan_release(((ChanRef*)h)->chan);
+    } else if (h->kind == HEAP_PROC) {
+        sys_proc_release(((ProcRef*)h)->proc);
+    } else {
+        free(((TypedArray*)h)->data.raw); // que des nombres : rien à tracer
+    }
+    gc_stats.object_bytes -= h->bytes;
+    free(h);
+}
+
+// Balaye au plus 'budget' entrées de la table ; retourne le nombre de valeurs libérées
+static size_t gcSweep(size_t budget) {
+    size_t freed = 0;
+    while (budget-- > 0 && gc_sweep_pos < heap_table_size) {
+        HeapHeader* h = heap_table[gc_sweep_pos];
+        if (h && h != HEAP_TOMBSTONE && h->gc_epoch != gc_epoch) {
+            heap_table[gc_sweep_pos] = HEAP_TOMBSTONE;
+            heap_live--;
+            freeHeapValue(h);
+            freed++;
+        }
+        gc_sweep_pos++;
+    }
+    if (gc_sweep_pos >= heap_table_size) gc_sweeping = false;
+    gc_stats.freed_objects += freed;
+    return freed;
+}
+
+static double gcNowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void gcRecordPause(double start) {
+    double pause = gcNowUs() - start;
+    gc_stats.pause_last_us = pause;
+    gc_stats.pause_total_us += pause;
+    if (pause > gc_stats.pause_max_us) gc_stats.pause_max_us = pause;
+}
+
+// Démarre un cycle : termine le balayage précédent puis marque
+static void gcStartCycle(void) {
+    if (gc_sweeping) gcSweep((size_t)-1);
+    gcMark();
+    gc_stats.collections++;
+    gc_sweep_pos = 0;
+    gc_sweeping = true;
+    gc_pending = false;
+    gc_threshold = gc_marked_bytes * 2;
+    if (gc_threshold < GC_MIN_THRESHOLD) gc_threshold = GC_MIN_THRESHOLD;
+}
+
+// Point sûr : appelé entre deux instructions
+static void gcSafepoint(void) {
+    double start = gcNowUs();
+    if (gc_pending) gcStartCycle();
+    else gcSweep(GC_SWEEP_STEP);
+    gcRecordPause(start);
+}
+
+// gc.collect() : cycle complet immédiat
+static size_t gcCollect(void) {
+    double start = gcNowUs();
+    size_t freed_before = gc_stats.freed_objects;
+    gcStartCycle();
+    gcSweep((size_t)-1);
+    gcRecordPause(start);
+    return gc_stats.freed_objects - freed_before;
+}
+
+static double gcStat(const char* name) {
+    if (strcmp(name, "collections") == 0) return (double)gc_stats.collections;
+    if (strcmp(name, "heap_bytes") == 0) return (double)(gc_stats.object_bytes + rstr_live_bytes());
+    if (strcmp(name, "object_bytes") == 0) return (double)gc_stats.object_bytes;
+    if (strcmp(name, "string_bytes") == 0) return (double)rstr_live_bytes();
+    if (strcmp(name, "objects") == 0) return (double)heap_live;
+    if (strcmp(name, "freed") == 0) return (double)gc_stats.freed_objects;
+    if (strcmp(name, "threshold") == 0) return (double)gc_threshold;
+    if (strcmp(name, "pause_last_us") == 0) return gc_stats.pause_last_us;
+    if (strcmp(name, "pause_max_us") == 0) return gc_stats.pause_max_us;
+    if (strcmp(name, "pause_total_us") == 0) return gc_stats.pause_total_us;
+    return 0.0;
+}
+
+// SWIFT_GC_STATS=1 : résumé sur stderr en fin d'exécution
+static void gcPrintStats(void) {
+    const char* env = getenv("SWIFT_GC_STATS");
+    if (!env || strcmp(env, "1") != 0) return;
+    fprintf(stderr, "%s[GC]%s collections=%zu freed=%zu objects=%zu heap=%zu bytes "
+            "pause last=%.0fus max=%.0fus total=%.0fus\n",
+            COLOR_CYAN, COLOR_RESET, gc_stats.collections, gc_stats.freed_objects,
+            heap_live, gc_stats.object_bytes + rstr_live_bytes(),
+            gc_stats.pause_last_us, gc_stats.pause_max_us, gc_stats.pause_total_us);
+}
+
 typedef enum {
     MODULE_STATUS_NOT_LOADED,
     MODULE_STATUS_LOADING,   // Pour détecter les cycles
@@ -193,8 +871,8 @@ typedef struct {
     int export_end_index;    // Où finissent les exports
 } ModuleCache;
 
-static ModuleCache module_registry[200];
-static int registry_count = 0;
+static ISOLATE ModuleCache module_registry[200];
+static ISOLATE int registry_count = 0;
 // ======================================================
 // [SECTION] FILE I/O SYSTEM
 // ======================================================
@@ -205,8 +883,8 @@ typedef struct {
     bool is_open;
 } FileHandle;
 
-static FileHandle open_files[50];
-static int file_count = 0;
+static ISOLATE FileHandle open_files[50];
+static ISOLATE int file_count = 0;
 
 // ======================================================
 // [SECTION] FUNCTION DECLARATIONS
@@ -214,6 +892,10 @@ static int file_count = 0;
 static void execute(ASTNode* node);
 static double evalFloat(ASTNode* node);
 static char* evalString(ASTNode* node);
+static char* evalStr(ASTNode* node);
+static Function* callFunction(ASTNode* node);
+static void releaseScopeVars(int mark, int level);
+static void executeCompoundAssign(Variable* var, ASTNode* node);
 static bool evalBool(ASTNode* node);
 static char* weldInput(const char* prompt);
 static void initWorkingDir(const char* filename);
@@ -224,6 +906,62 @@ static void showHelp();
 static void executeRead(ASTNode* node);
 static void executeWrite(ASTNode* node);
 static void executeAppend(ASTNode* node);
+static void executeForIn(ASTNode* node);
+static void executeParallelFor(ASTNode* node);
+static void optimizeProgram(ASTNode** nodes, int count);
+static AsyncTask* taskFromId(const char* id);
+static char* awaitTask(AsyncTask* task, double* num);
+static Function* spawnTask(Function* func, ASTNode* args, ASTNode* node);
+static Function* resolveCallable(ASTNode* arg);
+static Function* callIsolateBuiltin(ASTNode* node, ASTNode* args);
+static ChanRef* chanFromId(const char* id);
+static Function* callChanMethod(ASTNode* node, ChanRef* ref);
+static void executeForInChan(ASTNode* node, ChanRef* ref);
+static FutureRef* futureFromId(const char* id);
+static char* awaitFuture(FutureRef* ref, double* num);
+static char* evalSysSpawn(ASTNode* node);
+static char* evalSysRunAll(ASTNode* node);
+static ProcRef* procFromId(const char* id);
+static Function* callProcMethod(ASTNode* node, ProcRef* ref);
+static void executeForInProc(ASTNode* node, ProcRef* ref);
+static char* awaitProc(ProcRef* ref);
+
+// ======================================================
+// [SECTION] AIGUILLAGE DES NŒUDS
+// ======================================================
+// execute() et evalFloat() ne traitent en ligne que les nœuds chauds (listes
+// EXEC_HOT et EVAL_HOT) ; le reste (IO, réseau, dbvar, import, déclarations)
+// part dans une fonction froide hors ligne, ce qui garde le cadre de pile et
+// le code du chemin chaud petits. Avec GCC/Clang, l'aiguillage est une table
+// de labels (goto *table[type]) ; -DSWIFT_SWITCH_DISPATCH (make
+// DISPATCH=switch) force le switch portable, à comportement identique.
+#define NODE_TYPE_COUNT (NODE_EMPTY + 1)
+
+#if defined(__GNUC__)
+#define COLD __attribute__((noinline, cold))
+#else
+#define COLD
+#endif
+
+#if defined(__GNUC__) && !defined(SWIFT_SWITCH_DISPATCH)
+#define THREADED_DISPATCH 1
+#define DISPATCH_ENTRY(type, label) [type] = &&label,
+// Toutes les cases vont au label froid, puis les nœuds chauds l'écrasent
+#define DISPATCH(HOT, node, cold) do { \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Woverride-init\"") \
+    static const void* const dispatch_table[NODE_TYPE_COUNT] = { \
+        [0 ... NODE_TYPE_COUNT - 1] = &&cold, HOT(DISPATCH_ENTRY) \
+    }; \
+    _Pragma("GCC diagnostic pop") \
+    goto *dispatch_table[(node)->type]; \
+} while (0)
+#else
+#define DISPATCH_CASE(type, label) case type: goto label;
+#define DISPATCH(HOT, node, cold) do { \
+    switch ((node)->type) { HOT(DISPATCH_CASE) default: goto cold; } \
+} while (0)
+#endif
 
 // ======================================================
 // [SECTION] HELPER FUNCTIONS
@@ -277,25 +1015,49 @@ static const char* getTypeName(TokenKind type) {
     }
 }
 
-static int findVar(const char* name) {
-    for (int i = var_count - 1; i >= 0; i--) {
-        if (strcmp(vars[i].name, name) == 0 && vars[i].scope_level <= scope_level) {
+static int findVarSym(int sym) {
+    for (int i = var_count - 1; i >= var_floor; i--) {
+        if (vars[i].sym == sym && vars[i].scope_level <= scope_level) {
             return i;
         }
     }
+    // Dans une tâche async : les globales du programme principal restent visibles
+    if (var_floor > 0) {
+        for (int i = task_contexts[0].var_count - 1; i >= 0; i--) {
+            if (vars[i].sym == sym && vars[i].scope_level == 0) return i;
+        }
+    }
     return -1;
 }
 
+static int findVar(const char* name) {
+    return findVarSym(intern(name));
+}
+
+static void setVarName(Variable* var, const char* name) {
+    strncpy(var->name, name, 99);
+    var->name[99] = '\0';
+    var->sym = intern(name);
+}
+
+// Symbole du nom porté par un noeud (identifiant, appel...), interné au besoin
+static int nodeSym(ASTNode* node) {
+    if (!node->sym && node->data.name) node->sym = intern(node->data.name);
+    return node->sym;
+}
+
 static void registerFunction(const char* name, ASTNode* params, ASTNode* body, int param_count) {
-    if (func_count < 200) {
+    if (func_count < MAX_FUNCTIONS) {
         
         Function* func = &functions[func_count];
         strncpy(func->name, name, 99);
         func->name[99] = '\0';
+        func->sym = intern(name);
         func->params = params;
         func->body = body;
         func->param_count = param_count;
         func->has_returned = false;
+        func->is_async = false;
         func->return_value = 0;
         func->return_string = NULL;
         func->return_scope_level = -1;
@@ -323,22 +1085,39 @@ static void registerFunction(const char* name, ASTNode* params, ASTNode* body, i
     }
 }
 
-static Function* findFunction(const char* name) {
-        
-    // Chercher exact
+static Function* findFunctionSym(int sym) {
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
-            
-            return &functions[i];
-        }
+        if (functions[i].sym == sym) return &functions[i];
     }
-    
-    printf("%s%s %s  <== NOT FOUND function\n", COLOR_RED, COLOR_RESET, name);
     return NULL;
 }
 
+// Une lambda devient une fonction nommée (__lambda_N) à sa première
+// évaluation ; la fonction est mise en cache sur le noeud. Son corps est un
+// 'return <expression>' synthétisé.
+static Function* lambdaFunction(ASTNode* node) {
+    if (node->ic_target) return node->ic_target;
+    if (func_count >= MAX_FUNCTIONS) runtime_error(node, "Too many functions (lambda)");
+    
+    ASTNode* body = calloc(1, sizeof(ASTNode));
+    if (!body) { fprintf(stderr, "%s[FATAL]%s Out of memory (lambda)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    body->type = NODE_RETURN;
+    body->left = node->right;
+    body->line = node->line;
+    body->column = node->column;
+    
+    int param_count = 0;
+    for (ASTNode* param = node->left; param; param = param->right) param_count++;
+    char* name = generateLambdaName();
+    registerFunction(name, node->left, body, param_count);
+    free(name);
+    node->ic_target = &functions[func_count - 1];
+    return node->ic_target;
+}
+
+
 static void registerClass(const char* name, char* parent, ASTNode* members) {
-    if (class_count < 100) {
+    if (class_count < MAX_CLASSES) {
         Class* cls = &classes[class_count];
         strncpy(cls->name, name, 99);
         cls->name[99] = '\0';
@@ -549,6 +1328,7 @@ static bool loadAndExecuteModule(const char* import_path, const char* from_modul
         strncpy(current_working_dir, old_dir, PATH_MAX);
         return false;
     }
+    optimizeProgram(nodes, node_count);
 
     // 7. Enregistrer le début des exports pour ce module
     cache->export_start_index = export_count;
@@ -633,6 +1413,7 @@ static void showHelp() {
     printf("%s║    %s--help%s          Show this help message                     ║%s\n", COLOR_CYAN, COLOR_BRIGHT_WHITE, COLOR_CYAN, COLOR_RESET);
     printf("%s║    %s-h%s              Alias for --help                          ║%s\n", COLOR_CYAN, COLOR_BRIGHT_WHITE, COLOR_CYAN, COLOR_RESET);
     printf("%s║    %s-v%s              Alias for --version                       ║%s\n", COLOR_CYAN, COLOR_BRIGHT_WHITE, COLOR_CYAN, COLOR_RESET);
+    printf("%s║    %s--dump-ast%s <f>  Print the optimized AST of <f>            ║%s\n", COLOR_CYAN, COLOR_BRIGHT_WHITE, COLOR_CYAN, COLOR_RESET);
     printf("%s╠════════════════════════════════════════════════════════════════╣%s\n", COLOR_CYAN, COLOR_RESET);
     printf("%s║  Commands (in REPL):                                            ║%s\n", COLOR_CYAN, COLOR_RESET);
     printf("%s║    %sexit%s           Exit REPL                                ║%s\n", COLOR_CYAN, COLOR_BRIGHT_WHITE, COLOR_CYAN, COLOR_RESET);
@@ -652,1344 +1433,3555 @@ static void showHelp() {
 }
 
 // ======================================================
-// [SECTION] EXPRESSION EVALUATION
+// [SECTION] OPTIONS DES PRIMITIVES NATIVES
 // ======================================================
-static double evalFloat(ASTNode* node) {
-    if (!node) return 0.0;
+// Propriété désignée par obj.prop. Pour un objet : son slot, trouvé via le
+// cache en ligne du noeud (forme identique -> slot connu, sans recherche).
+// Pour les autres enregistrements (entrées io.walk) : la variable
+// "<objet>_<propriété>". create : ajoute la propriété si elle manque.
+static Variable* resolveMember(ASTNode* node, bool create, Object** owner) {
+    Object* obj = NULL;
+    int obj_sym = 0;
+    if (node->left->type == NODE_THIS) {
+        obj = current_this_obj;
+        if (!obj) return NULL;
+    } else {
+        char* id = evalStr(node->left);
+        obj = objectFromId(id);
+        if (!obj) obj_sym = intern_hashed(id, rstr_len(id), rstr_hash(id));
+        rstr_release(id);
+    }
+    int name = nodeSym(node->right);
+    if (owner) *owner = obj;
     
-    switch (node->type) {
-
-    case NODE_MATH_FUNC: {
-        if (node->op_type == TK_MATH_PI || node->op_type == TK_MATH_E) {
-            return std_math_const(node->op_type);
+    if (obj) {
+        Shape* shape = obj->shape;
+        if (node->ic_shape == shape) {
+            // ic_target : forme après ajout de la propriété (site d'écriture)
+            if (!node->ic_target) return objectSlot(obj, node->ic_slot);
+            if (create) {
+                obj->shape = node->ic_target;
+                return objectSlot(obj, node->ic_slot);
+            }
         }
-        double v1 = node->left ? evalFloat(node->left) : 0;
-        double v2 = node->right ? evalFloat(node->right) : 0;
-        return std_math_calc(node->op_type, v1, v2);
-    }
-    case NODE_TIME_NOW:
-        return std_time_now();
-    case NODE_TIME_SLEEP:
-        std_time_sleep(evalFloat(node->left));
-        return 0.0;
-        
-    case NODE_PATH_EXISTS: {
-        char* path = evalString(node->left);
-        // Utilise la fonction booléenne de io.c
-        bool res = (access(path, F_OK) == 0); 
-        if (path) free(path);
-        return res ? 1.0 : 0.0;
-    }   
-    case NODE_AWAIT: {
-        if (node->left) {
-            return evalFloat(node->left);
+        int slot = shapeSlot(shape, name);
+        if (slot >= 0) {
+            node->ic_shape = shape;
+            node->ic_target = NULL;
+            node->ic_slot = slot;
+            return objectSlot(obj, slot);
         }
-        return 0.0;
+        if (!create) return NULL;
+        obj->shape = shapeAdd(shape, name);
+        node->ic_shape = shape;
+        node->ic_target = obj->shape;
+        node->ic_slot = obj->shape->count - 1;
+        return objectSlot(obj, node->ic_slot);
     }
-        case NODE_STD_LEN: {
-            // Retourne la longueur d'une string ou d'un tableau (simplifié string ici)
-            char* val = evalString(node->left);
-            int len = val ? strlen(val) : 0;
-            if (val) free(val);
-            return (double)len;
-        }
-        case NODE_STD_TO_INT: {
-            char* val = evalString(node->left);
-            double res = val ? atof(val) : 0;
-            if (val) free(val);
-            return res;
+    
+    int sym = intern_member(obj_sym, name);
+    int idx = findVarSym(sym);
+    if (idx < 0 && create && var_count < var_limit) {
+        idx = var_count++;
+        memset(&vars[idx], 0, sizeof(Variable));
+        setVarName(&vars[idx], symbol_name(sym));
+        vars[idx].type = TK_VAR;
+        vars[idx].scope_level = 0; // attachée à l'enregistrement, pas au bloc
+    }
+    return idx >= 0 ? &vars[idx] : NULL;
+}
+
+// Variable lue par un identifiant ou un accès membre
+static Variable* lookupVar(ASTNode* node) {
+    if (node->type == NODE_MEMBER_ACCESS) return resolveMember(node, false, NULL);
+    int idx = findVarSym(nodeSym(node));
+    return idx >= 0 ? &vars[idx] : NULL;
+}
+
+static double varNumber(Variable* var) {
+    if (var->is_float) return var->value.float_val;
+    if (var->is_string) return var->value.str_val ? strtod(var->value.str_val, NULL) : 0.0;
+    return (double)var->value.int_val;
+}
+
+// Copie du type de la variable (nouvelle référence) ; une chaîne est
+// partagée, pas recopiée
+static EvalValue varValue(Variable* var) {
+    EvalValue v = { false, false, NULL, 0.0 };
+    if (var->is_string) {
+        v.is_string = true;
+        v.str = var->value.str_val ? rstr_retain(var->value.str_val) : rstr_new("", 0);
+    } else if (var->is_float) {
+        v.num = var->value.float_val;
+    } else {
+        v.is_int = true;
+        v.num = (double)var->value.int_val;
+    }
+    return v;
+}
+
+static List* listFromId(const char* id);
+static Map* mapFromId(const char* id);
+static MapEntry* mapFind(Map* map, EvalValue key);
+static EvalValue evalIndex(ASTNode* node);
+static EvalValue evalValue(ASTNode* expr);
+
+// Opérations math.* qui produisent un tableau (ou un texte : math.simd)
+static bool isVectorOp(int op) {
+    return op == TK_MATH_F64 || op == TK_MATH_I64 || op == TK_MATH_VADD || op == TK_MATH_VSUB ||
+           op == TK_MATH_VMUL || op == TK_MATH_VDIV || op == TK_MATH_SIMD;
+}
+
+static bool isVectorReduce(int op) {
+    return op == TK_MATH_SUM || op == TK_MATH_MIN || op == TK_MATH_MAX ||
+           op == TK_MATH_MEAN || op == TK_MATH_DOT;
+}
+
+// l[i] / m[k] sans effet de bord (variable indexée par une constante ou une
+// variable) : on regarde si l'élément est une chaîne
+static bool isIndexString(ASTNode* node) {
+    if (node->left->type != NODE_IDENT || !node->right) return false;
+    Variable* container = lookupVar(node->left);
+    if (container && container->is_string && heapFromId(container->value.str_val) &&
+        heapFromId(container->value.str_val)->kind == HEAP_ARRAY) return false; // que des nombres
+    if (node->left->type != NODE_IDENT || !node->right) return false;
+    if (node->right->type != NODE_INT && node->right->type != NODE_IDENT &&
+        node->right->type != NODE_STRING) return false;
+    Variable* var = lookupVar(node->left);
+    if (!var || !var->is_string) return false;
+    Map* map = mapFromId(var->value.str_val);
+    if (map) {
+        EvalValue key = evalValue(node->right);
+        MapEntry* e = mapFind(map, key);
+        rstr_release(key.str);
+        return e && e->value.is_string;
+    }
+    List* list = listFromId(var->value.str_val);
+    if (!list) return true; // chaine[i]
+    if (node->right->type == NODE_STRING) return false;
+    Variable* index_var = node->right->type == NODE_IDENT ? lookupVar(node->right) : NULL;
+    if (node->right->type == NODE_IDENT && !index_var) return false;
+    long i = index_var ? (long)varNumber(index_var) : (long)node->right->data.int_val;
+    if (i < 0) i += list->count;
+    return i >= 0 && i < list->count && list->items[i].is_string;
+}
+
+// Vrai si l'expression produit une chaîne (comparaisons == / != textuelles)
+static bool isStringExpr(ASTNode* node) {
+    if (!node) return false;
+    switch (node->type) {
+        case NODE_STRING:
+            return true;
+        case NODE_IDENT: {
+            int idx = findVarSym(nodeSym(node));
+            return idx >= 0 && vars[idx].is_string;
         }
-        case NODE_SYS_EXEC: {
-            char* cmd = evalString(node->left);
-            // sys_exec_int est une nouvelle fonction dans sys.c qui retourne le int
-            // ou on adapte sys_exec pour retourner int
-            int res = system(cmd); 
-            if (cmd) free(cmd);
-            return (double)res;
+        case NODE_MEMBER_ACCESS: {
+            Variable* var = resolveMember(node, false, NULL);
+            return var && var->is_string;
         }
-        case NODE_NET_SOCKET:
-            return (double)net_socket_create();
-            
-        case NODE_NET_LISTEN: {
-            int port = (int)evalFloat(node->left); // Évaluation de la variable port
-            return (double)net_start_listen(port);
+        case NODE_BINARY:
+            return node->op_type == TK_CONCAT ||
+                   (node->op_type == TK_PLUS && (isStringExpr(node->left) || isStringExpr(node->right)));
+        case NODE_ADD_LOCAL_CONST:
+            return node->op_type == TK_PLUS && isStringExpr(node->left);
+        case NODE_MATH_FUNC:
+            return isVectorOp(node->op_type);
+        case NODE_FILE_READ:
+        case NODE_LAMBDA:
+        case NODE_LIST:
+        case NODE_MAP:
+        case NODE_STD_SPLIT:
+        case NODE_NET_RECV:
+        case NODE_HTTP_GET:
+        case NODE_HTTP_POST:
+        case NODE_SYS_SPAWN:
+        case NODE_SYS_RUN_ALL:
+            return true;
+        case NODE_ARRAY_ACCESS:
+            return node->op_type == TK_COLON || isIndexString(node);
+        case NODE_IO_FUNC:
+            return node->op_type == TK_IO_ASYNC_BACKEND;
+        default:
+            return false;
+    }
+}
+
+// Les entiers (octets copiés, tailles...) s'affichent sans notation exponentielle
+static int formatNumber(char* buf, size_t size, double val) {
+    if (val == (int64_t)val && fabs(val) < 1e18) return snprintf(buf, size, "%lld", (long long)val);
+    return snprintf(buf, size, "%.15g", val);
+}
+
+static char* numberToString(double val) {
+    char* r = malloc(32);
+    formatNumber(r, 32, val);
+    return r;
+}
+
+// Même conversion, directement en rstr (sans passer par malloc)
+static char* numberToRstr(double val) {
+    char buf[32];
+    int len = formatNumber(buf, sizeof(buf), val);
+    return rstr_new(buf, (size_t)len);
+}
+
+// await <expr> : si l'expression désigne une tâche async ("task_N") ou une
+// opération io.*_async en cours, on attend son résultat (valeur retournée,
+// contenu lu ou octets écrits) en laissant tourner les autres tâches, sinon
+// on rend sa valeur.
+// Retourne une chaîne allouée, ou NULL avec *num rempli pour un résultat numérique.
+static char* evalAwait(ASTNode* node, double* num) {
+    *num = 0.0;
+    ASTNode* target = node->left;
+    if (!target) return NULL;
+    
+    bool may_be_handle = target->type == NODE_IO_FUNC ||
+                         (target->type == NODE_IDENT && !isStringExpr(target));
+    if (!may_be_handle) {
+        if (isStringExpr(target) || target->type == NODE_FUNC_CALL) {
+            char* value = evalString(target);
+            AsyncTask* task = value && value[0] == 't' ? taskFromId(value) : NULL;
+            FutureRef* future = value && value[0] == 'f' ? futureFromId(value) : NULL;
+            ProcRef* proc = value && value[0] == 'p' ? procFromId(value) : NULL;
+            if (!task && !future && !proc) return value;
+            free(value);
+            if (proc) return awaitProc(proc);
+            return task ? awaitTask(task, num) : awaitFuture(future, num);
         }
-            
-        case NODE_NET_ACCEPT: {
-            int server_fd = (int)evalFloat(node->left); // Évaluation de la variable server
-            return (double)net_accept_client(server_fd);
+        *num = evalFloat(target);
+        return NULL;
+    }
+    
+    double value = evalFloat(target);
+    int handle = (int)value;
+    if ((double)handle == value && aio_is_pending(handle)) {
+        // Attente coopérative de la fin de l'opération, puis récupération
+        // (le fd est relu à chaque tour : io_uring peut basculer sur le pool)
+        while (!aio_ready(handle)) {
+            int event_fd = aio_event_fd();
+            if (event_fd < 0) break;
+            sched_wait_fd(event_fd, POLLIN);
         }
-        case NODE_INT:
-            return (double)node->data.int_val;
-            
-        case NODE_FLOAT:
-            return node->data.float_val;
-            
-        case NODE_BOOL:
-            return node->data.bool_val ? 1.0 : 0.0;
-            
-        case NODE_NULL:
-        case NODE_UNDEFINED:
-        case NODE_NAN:
-            return NAN;
-            
-        case NODE_INF:
-            return INFINITY;
-            
-        case NODE_STRING: {
-            char* endptr;
-            double val = strtod(node->data.str_val, &endptr);
-            if (endptr != node->data.str_val) {
-                return val;
-            }
-            return 0.0;
-        }
-            
-        case NODE_IDENT: {
-            int idx = findVar(node->data.name);
-            if (idx >= 0) {
-                if (vars[idx].is_float) {
-                    return vars[idx].value.float_val;
-                } else if (vars[idx].is_string) {
-                    char* endptr;
-                    double val = strtod(vars[idx].value.str_val, &endptr);
-                    if (endptr != vars[idx].value.str_val) {
-                        return val;
-                    }
-                    return 0.0;
-                } else {
-                    return (double)vars[idx].value.int_val;
-                }
-            }
-            printf("%s[EXEC ERROR]%s Undefined variable: %s\n", COLOR_RED, COLOR_RESET, node->data.name);
-            return 0.0;
-        }
-            
-        case NODE_BINARY: {
-            double left = evalFloat(node->left);
-            double right = evalFloat(node->right);
-            
-            switch (node->op_type) {
-                case TK_PLUS: return left + right;
-                case TK_MINUS: return left - right;
-                case TK_MULT: return left * right;
-                case TK_DIV: 
-                    if (right == 0.0) {
-                        printf("%s[EXEC WARNING]%s Division by zero\n", COLOR_YELLOW, COLOR_RESET);
-                        return INFINITY;
-                    }
-                    return left / right;
-                case TK_MOD: 
-                    if (right == 0.0) {
-                        printf("%s[EXEC WARNING]%s Modulo by zero\n", COLOR_YELLOW, COLOR_RESET);
-                        return 0.0;
-                    }
-                    return fmod(left, right);
-                case TK_POW: return pow(left, right);
-                case TK_CONCAT: {
-                    char* left_str = evalString(node->left);
-                    char* right_str = evalString(node->right);
-                    char* combined = malloc(strlen(left_str) + strlen(right_str) + 1);
-                    strcpy(combined, left_str);
-                    strcat(combined, right_str);
-                    
-                    char* endptr;
-                    double val = strtod(combined, &endptr);
-                    
-                    free(left_str);
-                    free(right_str);
-                    free(combined);
-                    
-                    if (endptr != combined) return val;
-                    return 0.0;
-                }
-                case TK_EQ: return left == right ? 1.0 : 0.0;
-                case TK_NEQ: return left != right ? 1.0 : 0.0;
-                case TK_GT: return left > right ? 1.0 : 0.0;
-                case TK_LT: return left < right ? 1.0 : 0.0;
-                case TK_GTE: return left >= right ? 1.0 : 0.0;
-                case TK_LTE: return left <= right ? 1.0 : 0.0;
-                case TK_AND: return (left != 0.0 && right != 0.0) ? 1.0 : 0.0;
-                case TK_OR: return (left != 0.0 || right != 0.0) ? 1.0 : 0.0;
-                default: return 0.0;
-            }
-        }
-            
-        case NODE_UNARY: {
-            double operand = evalFloat(node->left);
-            switch (node->op_type) {
-                case TK_MINUS: return -operand;
-                case TK_NOT: return operand == 0.0 ? 1.0 : 0.0;
-                default: return operand;
-            }
-        }
-            
-        case NODE_TERNARY: {
-            double condition = evalFloat(node->left);
-            if (condition != 0.0) {
-                return evalFloat(node->right);
-            } else {
-                return evalFloat(node->third);
-            }
-        }
-        
-    case NODE_STR_FUNC: {
-        if (node->op_type == TK_STR_CONTAINS) {
-            char* h = evalString(node->left);
-            char* n = evalString(node->right);
-            int res = std_str_contains(h, n);
-            free(h); free(n);
-            return (double)res;
-        }
-        return 0.0;
+        long long result = 0;
+        char* content = aio_await(handle, &result);
+        if (content) return content;
+        *num = (double)result;
+        return NULL;
     }
-        case NODE_FUNC_CALL: {
-            Function* func = findFunction(node->data.name);
-            if (func) {
-                Function* prev_func = current_function;
-                current_function = func;
-                
-                int old_scope = scope_level;
-                scope_level++;
-                
-                if (node->left && func->param_names) {
-                    ASTNode* arg = node->left;
-                    int param_idx = 0;
-                    
-                    while (arg && param_idx < func->param_count) {
-                        if (func->param_names[param_idx]) {
-                            if (var_count < 1000) {
-                                Variable* var = &vars[var_count];
-                                strncpy(var->name, func->param_names[param_idx], 99);
-                                var->name[99] = '\0';
-                                var->type = TK_VAR;
-                                var->size_bytes = 8;
-                                var->scope_level = scope_level;
-                                var->is_constant = false;
-                                var->is_initialized = true;
-                                
-                                double arg_val = evalFloat(arg);
-                                var->is_float = true;
-                                var->is_string = false;
-                                var->value.float_val = arg_val;
-                                
-                                var_count++;
-                            }
-                        }
-                        arg = arg->right;
-                        param_idx++;
-                    }
-                }
-                
-                func->has_returned = false;
-                func->return_value = 0;
-                if (func->return_string) {
-                    free(func->return_string);
-                    func->return_string = NULL;
-                }
-                
-                if (func->body) {
-                    execute(func->body);
-                }
-                
-                scope_level = old_scope;
-                current_function = prev_func;
-                
-                if (func->return_string) {
-                    char* endptr;
-                    double val = strtod(func->return_string, &endptr);
-                    if (endptr != func->return_string) {
-                        return val;
-                    }
-                }
-                return func->return_value;
-            }
-            
-            printf("%s[EXEC ERROR]%s Function not found: %s\n", COLOR_RED, COLOR_RESET, node->data.name);
-            return 0.0;
+    *num = value;
+    return NULL;
+}
+
+// Cherche la valeur associée à key dans un littéral map passé en options
+// (ex: io.writer(path, {buffer: 1<<20})). Retourne le noeud valeur ou NULL.
+static ASTNode* findOption(ASTNode* options, const char* key) {
+    if (!options || options->type != NODE_MAP) return NULL;
+    for (ASTNode* entry = options->left; entry; entry = entry->next) {
+        if (entry->right && entry->right->type == NODE_STRING &&
+            strcmp(entry->right->data.str_val, key) == 0) {
+            return entry->left;
         }
-            
-        default:
-            return 0.0;
     }
+    return NULL;
 }
 
-static char* evalString(ASTNode* node) {
-    if (!node) return str_copy("");
+// ======================================================
+// [SECTION] VALEURS STRING PARTAGÉES
+// ======================================================
+// Les variables string contiennent des rstr (rstr.h) : une lecture retient
+// la chaîne au lieu de la copier, et 's = s + x' / 's += x' ajoutent en
+// place dans le buffer de la variable quand il n'est pas partagé.
+
+// '+' textuel : au moins un des opérandes est une chaîne
+static bool isConcat(ASTNode* node) {
+    return node && node->type == NODE_BINARY &&
+           (node->op_type == TK_CONCAT ||
+            (node->op_type == TK_PLUS && (isStringExpr(node->left) || isStringExpr(node->right))));
+}
+
+#define CONCAT_MAX_PARTS 64
+
+// Concatène toute une chaîne a + b + c ... (arbre penché à gauche) dans un
+// seul buffer. self_idx >= 0 : l'opérande de gauche est cette variable, son
+// buffer est repris et complété en place (s = s + ...).
+static char* evalConcat(ASTNode* node, Variable* self) {
+    ASTNode* parts[CONCAT_MAX_PARTS];
+    int count = 0;
+    ASTNode* leftmost = node;
+    while (isConcat(leftmost) && count < CONCAT_MAX_PARTS) {
+        parts[count++] = leftmost->right;
+        leftmost = leftmost->left;
+    }
     
-    switch (node->type) {
+    char* base = NULL;
+    char* pieces[CONCAT_MAX_PARTS];
+    if (!self) base = evalStr(leftmost);
+    for (int i = count - 1; i >= 0; i--) pieces[i] = evalStr(parts[i]);
     
-    // --- MODULE CRYPTO (Le correctif est ici) ---
-    case NODE_CRYPTO_FUNC: {
-        char* data = evalString(node->left);
-        char* res = NULL;
-        
-        if (node->op_type == TK_CRYPTO_SHA256) res = std_crypto_sha256(data);
-        else if (node->op_type == TK_CRYPTO_MD5) res = std_crypto_md5(data);
-        else if (node->op_type == TK_CRYPTO_B64ENC) res = std_crypto_b64enc(data);
-        else if (node->op_type == TK_CRYPTO_B64DEC) res = std_crypto_b64dec(data);
-        
-        if (data) free(data);
-        return res ? res : str_copy("");
+    if (self) {
+        // La référence de la variable est transférée au résultat
+        base = self->value.str_val;
+        self->value.str_val = NULL;
+        if (!base) base = rstr_new("", 0);
+    }
+    
+    for (int i = count - 1; i >= 0; i--) {
+        base = rstr_append(base, pieces[i], rstr_len(pieces[i]));
+        rstr_release(pieces[i]);
     }
+    return base;
+}
 
-    // --- MODULE PATH (Le correctif est ici) ---
-    case NODE_PATH_FUNC: {
-        char* p1 = evalString(node->left);
-        char* res = NULL;
-        
-        if (node->op_type == TK_PATH_BASENAME) res = std_path_basename(p1);
-        else if (node->op_type == TK_PATH_DIRNAME) res = std_path_dirname(p1);
-        else if (node->op_type == TK_PATH_ABS) res = std_path_abs(p1);
-        else if (node->op_type == TK_PATH_JOIN) {
-            char* p2 = evalString(node->right);
-            res = std_path_join(p1, p2);
-            free(p2);
-        }
-        
-        free(p1);
-        return res ? res : str_copy("");
+// s = s + ... (ou this.s = this.s + ...) : la cible est l'opérande le plus à gauche
+static bool isSelfConcat(ASTNode* expr, Variable* target) {
+    if (!isConcat(expr) || !target->is_string) return false;
+    ASTNode* leftmost = expr;
+    while (isConcat(leftmost)) leftmost = leftmost->left;
+    if (leftmost->type == NODE_IDENT) {
+        int idx = findVarSym(nodeSym(leftmost));
+        return idx >= 0 && &vars[idx] == target;
+    }
+    // Objet sans effet de bord uniquement : l'accès est réévalué
+    if (leftmost->type == NODE_MEMBER_ACCESS &&
+        (leftmost->left->type == NODE_THIS || leftmost->left->type == NODE_IDENT)) {
+        return resolveMember(leftmost, false, NULL) == target;
     }
+    return false;
+}
 
-    // --- MODULE ENV ---
-    case NODE_ENV_FUNC: {
-        if (node->op_type == TK_ENV_GET) {
-            char* key = evalString(node->left);
-            char* val = std_env_get(key);
-            free(key);
-            return val ? val : str_copy("");
-        }
-        if (node->op_type == TK_ENV_OS) {
-            return std_env_os();
-        }
-        return str_copy("");
+// Le type du résultat d'un appel (a.name()) n'est connu qu'après l'appel :
+// un '+' qui en contient un se décide sur les valeurs obtenues
+static bool hasCallOperand(ASTNode* node) {
+    if (!node) return false;
+    if (node->type == NODE_METHOD_CALL || node->type == NODE_FUNC_CALL) return true;
+    return node->type == NODE_BINARY && node->op_type == TK_PLUS &&
+           (hasCallOperand(node->left) || hasCallOperand(node->right));
+}
+
+static bool isDynamicPlus(ASTNode* node) {
+    return node && node->type == NODE_BINARY && node->op_type == TK_PLUS &&
+           hasCallOperand(node) && !isConcat(node);
+}
+
+// Addition si les deux valeurs sont des nombres, concaténation sinon
+static EvalValue evalDynamicPlus(ASTNode* node) {
+    EvalValue left = evalValue(node->left);
+    EvalValue right = evalValue(node->right);
+    if (!left.is_string && !right.is_string) {
+        EvalValue sum = { false, false, NULL, left.num + right.num };
+        return sum;
     }
+    char* base = left.is_string ? left.str : numberToRstr(left.num);
+    char* piece = right.is_string ? right.str : numberToRstr(right.num);
+    base = rstr_append(base, piece, rstr_len(piece));
+    rstr_release(piece);
+    EvalValue joined = { true, false, base, 0.0 };
+    return joined;
+}
 
-    // --- MODULE STR ---
-    case NODE_STR_FUNC: {
-        char* s = evalString(node->left);
-        char* res = NULL;
-        
-        if (node->op_type == TK_STR_UPPER) res = std_str_upper(s);
-        else if (node->op_type == TK_STR_LOWER) res = std_str_lower(s);
-        else if (node->op_type == TK_STR_TRIM) res = std_str_trim(s);
-        else if (node->op_type == TK_STR_SUB) {
-            int start = (int)evalFloat(node->right);
-            int len = (int)evalFloat(node->third);
-            res = std_str_sub(s, start, len);
+static EvalValue evalValue(ASTNode* expr) {
+    EvalValue v = { false, false, NULL, 0.0 };
+    if (!expr) return v;
+    
+    switch (expr->type) {
+        case NODE_STRING:
+            v.is_string = true;
+            v.str = rstr_from(expr->data.str_val);
+            return v;
+        case NODE_BOOL:
+            v.is_int = true;
+            v.num = expr->data.bool_val ? 1 : 0;
+            return v;
+        case NODE_AWAIT: {
+            char* content = evalAwait(expr, &v.num);
+            if (content) {
+                v.is_string = true;
+                v.str = rstr_adopt(content);
+            }
+            return v;
         }
-        else if (node->op_type == TK_STR_REPLACE) {
-            char* search = evalString(node->right);
-            char* replace = evalString(node->third);
-            res = std_str_replace(s, search, replace);
-            free(search); free(replace);
+        case NODE_IDENT:
+        case NODE_MEMBER_ACCESS: {
+            Variable* var = lookupVar(expr);
+            if (!var) break;
+            return varValue(var);
         }
-        
-        if (s) free(s);
-        return res ? res : str_copy("");
+        case NODE_ARRAY_ACCESS:
+            return evalIndex(expr);
+        case NODE_METHOD_CALL:
+        case NODE_FUNC_CALL: {
+            // Un seul appel ; return_string n'existe que pour un résultat textuel
+            Function* func = callFunction(expr);
+            if (func && func->return_string) {
+                v.is_string = true;
+                v.str = rstr_retain(func->return_string);
+            } else {
+                v.num = func ? func->return_value : 0.0;
+            }
+            return v;
+        }
+        default:
+            break;
     }
 
-    // --- MODULE MATH (Conversion en string pour affichage) ---
-    case NODE_MATH_FUNC: {
-        double val = evalFloat(node);
-        char buf[64];
-        sprintf(buf, "%g", val);
-        return str_copy(buf);
+    if (isDynamicPlus(expr)) return evalDynamicPlus(expr);
+    if (expr->type == NODE_NEW || isStringExpr(expr)) {
+        v.is_string = true;
+        v.str = evalStr(expr);
+        return v;
     }
+    v.num = evalFloat(expr);
+    return v;
+}
 
-    // --- INSTANCIATION ---
-    case NODE_NEW: {
-        static int instance_id = 0;
-        char instance_name[64];
-        sprintf(instance_name, "inst_%d", ++instance_id);
-        registerInstance(instance_name, node->data.name);
-        return str_copy(instance_name);
+// Range une valeur (référence consommée) dans une variable ou un slot existant
+static void storeValue(Variable* var, EvalValue v) {
+    char* old = var->is_string ? var->value.str_val : NULL;
+    
+    var->is_initialized = true;
+    if (v.is_string) {
+        var->is_string = true;
+        var->is_float = false;
+        var->value.str_val = v.str;
+        var->size_bytes = (int)rstr_len(v.str) + 1;
+    } else if (v.is_int) {
+        var->is_string = false;
+        var->is_float = false;
+        var->value.int_val = (int64_t)v.num;
+    } else {
+        var->is_string = false;
+        var->is_float = true;
+        var->value.float_val = v.num;
     }
+    rstr_release(old);
+}
 
-    // --- ACCÈS MEMBRE ---
-    case NODE_MEMBER_ACCESS: {
-        char* obj_name = NULL;
-        if (node->left->type == NODE_THIS) {
-            if (current_this) obj_name = str_copy(current_this);
-            else return str_copy("");
-        } else {
-            obj_name = evalString(node->left);
-        }
-        
-        char* prop_name = node->right->data.name;
-        if (!obj_name) return str_copy("");
+static void setVarString(Variable* var, char* str) {
+    EvalValue v = { true, false, str, 0.0 };
+    storeValue(var, v);
+}
+
+static void setVarNumber(Variable* var, double num) {
+    EvalValue v = { false, false, NULL, num };
+    storeValue(var, v);
+}
+
+// ======================================================
+// [SECTION] MAPS
+// ======================================================
+// Une map est référencée par "map_N". Clés : chaînes ou nombres (1 et "1"
+// sont deux clés distinctes). L'index Robin Hood garde la distance de sondage
+// de chaque slot petite : une recherche qui croise un slot plus proche de
+// son origine que la clé cherchée s'arrête (clé absente). La suppression
+// décale les slots suivants vers l'arrière, sans pierres tombales.
+static Map* mapFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_MAP ? (Map*)h : NULL;
+}
+
+static uint32_t valueHash(EvalValue key) {
+    if (key.is_string) return rstr_hash(key.str);
+    double d = key.num == 0.0 ? 0.0 : key.num; // -0 == 0
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    return (uint32_t)bits;
+}
+
+static bool valuesEqual(EvalValue a, EvalValue b) {
+    if (a.is_string != b.is_string) return false;
+    if (a.is_string) return rstr_equal(a.str, b.str);
+    return a.num == b.num;
+}
+
+static void mapAccount(Map* map, size_t before) {
+    size_t after = sizeof(Map) + (size_t)map->entry_cap * sizeof(MapEntry) +
+                   (map->slots ? (size_t)(map->slot_mask + 1) * sizeof(MapSlot) : 0);
+    if (after > before) gcAccount(after - before);
+    else gc_stats.object_bytes -= before - after;
+    map->gc.bytes = after;
+}
+
+static Map* newMap(void) {
+    Map* map = calloc(1, sizeof(Map));
+    if (!map) { fprintf(stderr, "%s[FATAL]%s Out of memory (map)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    heapInsert(&map->gc, HEAP_MAP, sizeof(Map));
+    return map;
+}
+
+// Slot de l'index contenant la clé, -1 si absente
+static long mapFindSlot(Map* map, EvalValue key, uint32_t hash) {
+    if (!map->slots) return -1;
+    uint32_t mask = map->slot_mask;
+    uint32_t i = hash & mask;
+    for (uint32_t dist = 0; ; dist++, i = (i + 1) & mask) {
+        MapSlot* slot = &map->slots[i];
+        if (slot->entry == MAP_EMPTY) return -1;
+        if (((i - (slot->hash & mask)) & mask) < dist) return -1;
+        if (slot->hash == hash && valuesEqual(map->entries[slot->entry].key, key)) return (long)i;
+    }
+}
 
-        char full_name[256];
-        snprintf(full_name, 256, "%s_%s", obj_name, prop_name);
-        free(obj_name);
+static MapEntry* mapFind(Map* map, EvalValue key) {
+    long slot = mapFindSlot(map, key, valueHash(key));
+    return slot >= 0 ? &map->entries[map->slots[slot].entry] : NULL;
+}
 
-        int idx = findVar(full_name);
-        if (idx >= 0 && vars[idx].is_string) {
-            return str_copy(vars[idx].value.str_val);
+static void mapIndexInsert(Map* map, uint32_t entry, uint32_t hash) {
+    uint32_t mask = map->slot_mask;
+    MapSlot moving = { entry, hash };
+    uint32_t i = hash & mask;
+    for (uint32_t dist = 0; ; dist++, i = (i + 1) & mask) {
+        MapSlot* slot = &map->slots[i];
+        if (slot->entry == MAP_EMPTY) {
+            *slot = moving;
+            return;
         }
-        // Fallback: si c'est un nombre, le convertir en string
-        if (idx >= 0 && vars[idx].is_float) {
-            char buf[64];
-            sprintf(buf, "%g", vars[idx].value.float_val);
-            return str_copy(buf);
+        // Robin Hood : le slot le plus proche de son origine cède sa place
+        uint32_t slot_dist = (i - (slot->hash & mask)) & mask;
+        if (slot_dist < dist) {
+            MapSlot tmp = *slot;
+            *slot = moving;
+            moving = tmp;
+            dist = slot_dist;
         }
-        return str_copy("");
     }
+}
 
-    // --- IO ---
-    case NODE_FILE_READ: {
-        char* path = evalString(node->left);
-        char* content = io_read_string(path); 
-        if (path) free(path);
-        return content ? content : str_copy("");
-    }
-    case NODE_WELD: {
-        char* prompt = NULL;
-        if (node->left) prompt = evalString(node->left);
-        char* input = weldInput(prompt);
-        if (prompt) free(prompt);
-        return input ? input : str_copy("");
+// Reconstruit l'index (et compacte les entrées supprimées)
+static void mapRebuild(Map* map, uint32_t slot_count) {
+    size_t before = map->gc.bytes;
+    int kept = 0;
+    for (int i = 0; i < map->entry_count; i++) {
+        if (map->entries[i].deleted) continue;
+        if (kept != i) map->entries[kept] = map->entries[i];
+        kept++;
     }
+    map->entry_count = kept;
+    
+    free(map->slots);
+    map->slots = malloc(slot_count * sizeof(MapSlot));
+    if (!map->slots) { fprintf(stderr, "%s[FATAL]%s Out of memory (map)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    for (uint32_t i = 0; i < slot_count; i++) map->slots[i].entry = MAP_EMPTY;
+    map->slot_mask = slot_count - 1;
+    for (int i = 0; i < map->entry_count; i++) mapIndexInsert(map, (uint32_t)i, map->entries[i].hash);
+    mapAccount(map, before);
+}
 
-    // --- HTTP / SYS / JSON / NET / STD ---
-    case NODE_HTTP_GET: {
-        char* url = evalString(node->left);
-        char* res = http_get(url);
-        free(url); return res ? res : str_copy("");
-    }
-    case NODE_HTTP_POST: {
-        char* url = evalString(node->left);
-        char* data = evalString(node->right);
-        char* res = http_post(url, data);
-        free(url); free(data); return res ? res : str_copy("");
+// Ajoute ou remplace (références consommées)
+static void mapSet(Map* map, EvalValue key, EvalValue value) {
+    uint32_t hash = valueHash(key);
+    long found = mapFindSlot(map, key, hash);
+    if (found >= 0) {
+        MapEntry* e = &map->entries[map->slots[found].entry];
+        rstr_release(e->value.str);
+        e->value = value;
+        rstr_release(key.str);
+        return;
     }
-    case NODE_HTTP_DOWNLOAD: {
-        char* url = evalString(node->left);
-        char* out = evalString(node->right);
-        char* res = http_download(url, out);
-        free(url); free(out); return res ? res : str_copy("failed");
+    
+    uint32_t slot_count = map->slots ? map->slot_mask + 1 : 0;
+    if ((uint64_t)(map->count + 1) * 4 > (uint64_t)slot_count * 3) {
+        uint32_t size = 8;
+        while ((uint64_t)(map->count + 1) * 4 > (uint64_t)size * 3) size *= 2;
+        mapRebuild(map, size);
+    } else if (map->entry_count == map->entry_cap && map->entry_count > map->count * 2) {
+        mapRebuild(map, slot_count); // beaucoup de suppressions : on compacte
     }
-    case NODE_SYS_ARGV: {
-        int idx = (int)evalFloat(node->left);
-        char* arg = sys_get_argv(idx); 
-        return arg ? str_copy(arg) : NULL;
+    if (map->entry_count == map->entry_cap) {
+        size_t before = map->gc.bytes;
+        int cap = map->entry_cap ? map->entry_cap * 2 : 8;
+        MapEntry* entries = realloc(map->entries, cap * sizeof(MapEntry));
+        if (!entries) { fprintf(stderr, "%s[FATAL]%s Out of memory (map)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        map->entries = entries;
+        map->entry_cap = cap;
+        mapAccount(map, before);
     }
-    case NODE_JSON_GET: {
-        char* json = evalString(node->left);
-        char* key = evalString(node->right);
-        char* res = json_extract(json, key);
-        free(json); free(key); return res ? res : NULL;
+    
+    uint32_t index = (uint32_t)map->entry_count++;
+    MapEntry* e = &map->entries[index];
+    e->key = key;
+    e->value = value;
+    e->hash = hash;
+    e->deleted = false;
+    mapIndexInsert(map, index, hash);
+    map->count++;
+}
+
+static bool mapRemove(Map* map, EvalValue key) {
+    long found = mapFindSlot(map, key, valueHash(key));
+    if (found < 0) return false;
+    
+    MapEntry* e = &map->entries[map->slots[found].entry];
+    rstr_release(e->key.str);
+    rstr_release(e->value.str);
+    e->deleted = true;
+    map->count--;
+    
+    // Décalage arrière des slots qui suivent
+    uint32_t mask = map->slot_mask;
+    uint32_t i = (uint32_t)found;
+    while (true) {
+        uint32_t next = (i + 1) & mask;
+        MapSlot* slot = &map->slots[next];
+        if (slot->entry == MAP_EMPTY || ((next - (slot->hash & mask)) & mask) == 0) break;
+        map->slots[i] = *slot;
+        i = next;
     }
-    case NODE_NET_RECV: {
-        int fd = (int)evalFloat(node->left);
-        int size = 1024;
-        if (node->right) size = (int)evalFloat(node->right);
-        char* res = net_recv_data(fd, size);
-        return res ? res : str_copy("");
-    }
-    case NODE_STD_TO_STR: {
-        double val = evalFloat(node->left);
-        char* buf = malloc(64);
-        if (val == (int64_t)val) sprintf(buf, "%lld", (int64_t)val);
-        else sprintf(buf, "%g", val);
-        return buf;
-    }
-    case NODE_STD_SPLIT: {
-        char* str = evalString(node->left);
-        char* delim = evalString(node->right);
-        char* token = strtok(str, delim);
-        char* res = token ? str_copy(token) : str_copy("");
-        free(str); free(delim); return res;
+    map->slots[i].entry = MAP_EMPTY;
+    return true;
+}
+
+// { cle: valeur, ... } : une clé identifiant est une chaîne
+static char* evalMapLiteral(ASTNode* node) {
+    Map* map = newMap();
+    gcPushRoot(&map->gc);
+    for (ASTNode* entry = node->left; entry; entry = entry->next) {
+        EvalValue key = evalValue(entry->right);
+        mapSet(map, key, evalValue(entry->left));
     }
+    gcPopRoots(1);
+    return heapIdStr(&map->gc);
+}
 
-    // --- TYPES DE BASE ---
-    case NODE_STRING: return str_copy(node->data.str_val);
-    case NODE_BOOL: return str_copy(node->data.bool_val ? "true" : "false");
-    case NODE_NULL: return str_copy("null");
-    case NODE_UNDEFINED: return str_copy("undefined");
-    case NODE_INT: {
-        char* r = malloc(32); sprintf(r, "%lld", node->data.int_val); return r;
+// ======================================================
+// [SECTION] TABLEAUX TYPÉS
+// ======================================================
+// math.float64(src) / math.int64(src) : src est une liste, un autre tableau
+// ou une longueur (tableau de zéros). Les opérations groupées (math.sum,
+// math.dot, math.add...) passent par les noyaux SIMD de stdlib.c.
+static TypedArray* arrayFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_ARRAY ? (TypedArray*)h : NULL;
+}
+
+static TypedArray* newArray(bool is_int, int count) {
+    int cap = count < 4 ? 4 : count;
+    TypedArray* arr = calloc(1, sizeof(TypedArray));
+    void* data = calloc((size_t)cap, 8); // float64 et int64 : 8 octets
+    if (!arr || !data) { fprintf(stderr, "%s[FATAL]%s Out of memory (array)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    arr->is_int = is_int;
+    arr->count = count;
+    arr->cap = cap;
+    arr->data.raw = data;
+    heapInsert(&arr->gc, HEAP_ARRAY, sizeof(TypedArray) + (size_t)cap * 8);
+    return arr;
+}
+
+static double arrayGet(TypedArray* arr, int i) {
+    return arr->is_int ? (double)arr->data.i64[i] : arr->data.f64[i];
+}
+
+static void arraySet(TypedArray* arr, int i, double v) {
+    if (arr->is_int) arr->data.i64[i] = (int64_t)v;
+    else arr->data.f64[i] = v;
+}
+
+static void arrayPush(TypedArray* arr, double v) {
+    if (arr->count == arr->cap) {
+        int cap = arr->cap * 2;
+        void* data = realloc(arr->data.raw, (size_t)cap * 8);
+        if (!data) { fprintf(stderr, "%s[FATAL]%s Out of memory (array)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        arr->data.raw = data;
+        arr->gc.bytes += (size_t)(cap - arr->cap) * 8;
+        gcAccount((size_t)(cap - arr->cap) * 8);
+        arr->cap = cap;
     }
-    case NODE_FLOAT: {
-        char* r = malloc(32);
-        double val = node->data.float_val;
-        if (isnan(val)) strcpy(r, "nan");
-        else if (isinf(val)) strcpy(r, val > 0 ? "inf" : "-inf");
-        else sprintf(r, "%g", val);
-        return r;
+    arraySet(arr, arr->count++, v);
+}
+
+static int arrayIndex(TypedArray* arr, double index, ASTNode* node) {
+    long i = (long)index;
+    if (i < 0) i += arr->count;
+    if (i < 0 || i >= arr->count) {
+        runtime_error(node, "Array index %ld out of range (length %d)", (long)index, arr->count);
     }
-    case NODE_IDENT: {
-        int idx = findVar(node->data.name);
-        if (idx >= 0) {
-            if (vars[idx].is_string && vars[idx].value.str_val) return str_copy(vars[idx].value.str_val);
-            if (vars[idx].is_float) {
-                char* r = malloc(32); sprintf(r, "%g", vars[idx].value.float_val); return r;
-            }
-            char* r = malloc(32); sprintf(r, "%lld", vars[idx].value.int_val); return r;
-        }
-        return str_copy("undefined");
+    return (int)i;
+}
+
+static TypedArray* arraySlice(TypedArray* arr, long start, long end) {
+    TypedArray* slice = newArray(arr->is_int, (int)(end - start));
+    memcpy(slice->data.raw, (char*)arr->data.raw + start * 8, (size_t)(end - start) * 8);
+    return slice;
+}
+
+// Copie convertie d'une liste ou d'un tableau
+static TypedArray* arrayFrom(bool is_int, List* list, TypedArray* src) {
+    int count = list ? list->count : src->count;
+    TypedArray* arr = newArray(is_int, count);
+    for (int i = 0; i < count; i++) {
+        double v;
+        if (list) v = list->items[i].is_string ? strtod(list->items[i].str, NULL) : list->items[i].num;
+        else v = arrayGet(src, i);
+        arraySet(arr, i, v);
     }
-    case NODE_BINARY: {
-        if (node->op_type == TK_CONCAT) {
-            char* l = evalString(node->left);
-            char* r = evalString(node->right);
-            char* res = malloc(strlen(l) + strlen(r) + 1);
-            strcpy(res, l); strcat(res, r);
-            free(l); free(r); return res;
-        }
-        // Conversion implicite number -> string
-        double val = evalFloat(node);
-        char* r = malloc(32); sprintf(r, "%g", val); return r;
+    return arr;
+}
+
+static char* appendArray(char* out, TypedArray* arr) {
+    out = rstr_append(out, arr->is_int ? "int64[" : "float64[", arr->is_int ? 6 : 8);
+    for (int i = 0; i < arr->count; i++) {
+        if (i > 0) out = rstr_append(out, ", ", 2);
+        char buf[32];
+        int len = formatNumber(buf, sizeof(buf), arrayGet(arr, i));
+        out = rstr_append(out, buf, (size_t)len);
     }
+    return rstr_append(out, "]", 1);
+}
 
-    // --- APPEL DE FONCTION / METHODE ---
-    case NODE_FUNC_CALL: {
-        char* func_name = node->data.name;
-        char* prev_this = current_this; 
-        
-        char* dot = strchr(func_name, '.');
-        char real_func_name[256];
-        bool is_method = false;
+// ======================================================
+// [SECTION] LISTES
+// ======================================================
+// Une liste est référencée par son identifiant "list_N" (valeur string),
+// comme un objet. Ses éléments sont des EvalValue contiguës : accès et ajout
+// en O(1) amorti, capacité doublée quand elle est pleine.
+static ISOLATE Function native_result; // résultat des méthodes natives (list.pop()...)
 
-        if (dot) {
-            int len = dot - func_name;
-            char var_name[128];
-            strncpy(var_name, func_name, len);
-            var_name[len] = '\0';
-            char* method = dot + 1;
-            
-            int idx = findVar(var_name);
-            if (idx >= 0 && vars[idx].is_string) {
-                char* inst_id = vars[idx].value.str_val;
-                char* cls = findClassOf(inst_id);
-                if (cls) {
-                    snprintf(real_func_name, 256, "%s_%s", cls, method);
-                    func_name = real_func_name;
-                    current_this = inst_id;
-                    is_method = true;
-                }
-            }
-        }
+static List* listFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_LIST ? (List*)h : NULL;
+}
 
-        Function* func = findFunction(func_name);
-        
-        if (func) {
-            Function* prev_func = current_function;
-            current_function = func;
-            int old_scope = scope_level;
-            scope_level++;
-            
-            if (node->left && func->param_names) {
-                ASTNode* arg = node->left;
-                int param_idx = 0;
-                while (arg && param_idx < func->param_count) {
-                    if (func->param_names[param_idx]) {
-                        if (var_count < 1000) {
-                            Variable* var = &vars[var_count];
-                            strncpy(var->name, func->param_names[param_idx], 99);
-                            var->type = TK_VAR;
-                            var->scope_level = scope_level;
-                            var->is_initialized = true;
-                            
-                            if (arg->type == NODE_STRING) {
-                                var->is_string = true;
-                                var->value.str_val = evalString(arg);
-                            } else {
-                                var->is_float = true;
-                                var->value.float_val = evalFloat(arg);
-                            }
-                            var_count++;
-                        }
-                    }
-                    arg = arg->right;
-                    param_idx++;
-                }
-            }
-            
-            func->has_returned = false;
-            if (func->body) execute(func->body);
-            
-            scope_level = old_scope;
-            current_function = prev_func;
-            if (is_method) current_this = prev_this;
-            
-            if (func->return_string) return str_copy(func->return_string);
-            
-            char buf[64]; sprintf(buf, "%g", func->return_value); return str_copy(buf);
-        }
-        
-        if (is_method) current_this = prev_this;
-        return str_copy("");
-    }
+static List* newList(int cap) {
+    if (cap < 4) cap = 4;
+    List* list = calloc(1, sizeof(List));
+    EvalValue* items = malloc(cap * sizeof(EvalValue));
+    if (!list || !items) { fprintf(stderr, "%s[FATAL]%s Out of memory (list)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    list->items = items;
+    list->cap = cap;
+    heapInsert(&list->gc, HEAP_LIST, sizeof(List) + cap * sizeof(EvalValue));
+    return list;
+}
 
-    // --- ASYNC / AWAIT / LAMBDA ---
-    case NODE_AWAIT: if (node->left) return evalString(node->left); else return str_copy("");
-    case NODE_LAMBDA: {
-        char* n = generateLambdaName();
-        // (Logique simplifiée pour lambda)
-        return n; 
+static void listReserve(List* list, int needed) {
+    if (needed <= list->cap) return;
+    int cap = list->cap;
+    while (cap < needed) cap *= 2;
+    EvalValue* items = realloc(list->items, cap * sizeof(EvalValue));
+    if (!items) { fprintf(stderr, "%s[FATAL]%s Out of memory (list)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    size_t grown = (size_t)(cap - list->cap) * sizeof(EvalValue);
+    list->items = items;
+    list->cap = cap;
+    list->gc.bytes += grown;
+    gcAccount(grown);
+}
+
+// Ajoute une valeur (référence consommée)
+static void listPush(List* list, EvalValue v) {
+    listReserve(list, list->count + 1);
+    list->items[list->count++] = v;
+}
+
+static EvalValue copyValue(EvalValue v) {
+    if (v.is_string) rstr_retain(v.str);
+    return v;
+}
+
+// Index négatif : depuis la fin (l[-1] = dernier élément)
+static int listIndex(List* list, double index, ASTNode* node) {
+    long i = (long)index;
+    if (i < 0) i += list->count;
+    if (i < 0 || i >= list->count) {
+        runtime_error(node, "List index %ld out of range (length %d)", (long)index, list->count);
     }
+    return (int)i;
+}
 
-    default: return str_copy("");
-    } // Fin Switch
+// Bornes d'une tranche [start:end] ramenées dans [0, len]
+static void sliceBounds(ASTNode* start_node, ASTNode* end_node, long len, long* start, long* end) {
+    *start = start_node ? (long)evalFloat(start_node) : 0;
+    *end = end_node ? (long)evalFloat(end_node) : len;
+    if (*start < 0) *start += len;
+    if (*end < 0) *end += len;
+    if (*start < 0) *start = 0;
+    if (*end > len) *end = len;
+    if (*end < *start) *end = *start;
+}
+
+static List* listSlice(List* list, long start, long end) {
+    List* slice = newList((int)(end - start));
+    for (long i = start; i < end; i++) listPush(slice, copyValue(list->items[i]));
+    return slice;
+}
+
+static EvalValue listValue(List* list) {
+    EvalValue v = { true, false, heapIdStr(&list->gc), 0.0 };
+    return v;
 }
+
+// [a, b, ...] : les éléments sont évalués dans l'ordre
+static char* evalListLiteral(ASTNode* node) {
+    int count = 0;
+    for (ASTNode* item = node->left; item; item = item->next) count++;
+    List* list = newList(count);
+    gcPushRoot(&list->gc);
+    for (ASTNode* item = node->left; item; item = item->next) listPush(list, evalValue(item));
+    gcPopRoots(1);
+    return heapIdStr(&list->gc);
+}
+
+// liste[i], liste[a:b], tableau[i], tableau[a:b], map[cle], chaine[i], chaine[a:b]
+static EvalValue evalIndex(ASTNode* node) {
+    EvalValue v = { false, false, NULL, 0.0 };
+    char* container = evalStr(node->left);
+    List* list = listFromId(container);
+    bool is_slice = node->op_type == TK_COLON;
     
-static bool evalBool(ASTNode* node) {
-    if (!node) return false;
+    TypedArray* arr = list ? NULL : arrayFromId(container);
+    if (arr) {
+        rstr_release(container);
+        gcPushRoot(&arr->gc);
+        if (is_slice) {
+            long start, end;
+            sliceBounds(node->right, node->third, arr->count, &start, &end);
+            v.is_string = true;
+            v.str = heapIdStr(&arraySlice(arr, start, end)->gc);
+        } else {
+            v.num = arrayGet(arr, arrayIndex(arr, evalFloat(node->right), node));
+        }
+        gcPopRoots(1);
+        return v;
+    }
     
-    switch (node->type) {
-        case NODE_BOOL:
-            return node->data.bool_val;
-            
-        case NODE_INT:
-            return node->data.int_val != 0;
-            
-        case NODE_FLOAT:
-            return fabs(node->data.float_val) > 1e-10;
-            
-        case NODE_STRING:
-            return node->data.str_val && strlen(node->data.str_val) > 0;
-            
-        case NODE_NULL:
-        case NODE_UNDEFINED:
-        case NODE_NAN:
-            return false;
-            
-        case NODE_INF:
-            return true;
-            
-        default:
-            return evalFloat(node) != 0.0;
+    Map* map = list ? NULL : mapFromId(container);
+    if (map) {
+        rstr_release(container);
+        if (is_slice) runtime_error(node, "Cannot slice a map");
+        gcPushRoot(&map->gc);
+        EvalValue key = evalValue(node->right);
+        MapEntry* e = mapFind(map, key);
+        if (!e) {
+            char* text = key.is_string ? rstr_retain(key.str) : numberToRstr(key.num);
+            runtime_error(node, "Key '%s' not found in map", text);
+        }
+        rstr_release(key.str);
+        v = copyValue(e->value);
+        gcPopRoots(1);
+        return v;
+    }
+    
+    if (list) {
+        rstr_release(container);
+        gcPushRoot(&list->gc); // la liste peut n'être référencée que par cette expression
+        if (is_slice) {
+            long start, end;
+            sliceBounds(node->right, node->third, list->count, &start, &end);
+            v = listValue(listSlice(list, start, end));
+        } else {
+            v = copyValue(list->items[listIndex(list, evalFloat(node->right), node)]);
+        }
+        gcPopRoots(1);
+        return v;
+    }
+    
+    long len = (long)rstr_len(container);
+    v.is_string = true;
+    if (is_slice) {
+        long start, end;
+        sliceBounds(node->right, node->third, len, &start, &end);
+        v.str = rstr_new(container + start, (size_t)(end - start));
+    } else {
+        long i = (long)evalFloat(node->right);
+        if (i < 0) i += len;
+        if (i < 0 || i >= len) {
+            rstr_release(container);
+            runtime_error(node, "String index out of range (length %ld)", len);
+        }
+        v.str = rstr_new(container + i, 1);
     }
+    rstr_release(container);
+    return v;
 }
 
-// ======================================================
-// [SECTION] FILE I/O FUNCTIONS
-// ======================================================
-static void executeRead(ASTNode* node) {
-    if (!node->left) {
-        printf("%s[READ ERROR]%s Missing filename\n", COLOR_RED, COLOR_RESET);
-        return;
+// map[cle] = v : la clé est créée si elle manque
+static void executeMapAssign(ASTNode* node, Map* map) {
+    gcPushRoot(&map->gc);
+    EvalValue key = evalValue(node->left->right);
+    if (key.is_string) {
+        HeapHeader* h = heapFromId(key.str);
+        if (h) gcPushRoot(h); else gcPushRoot(NULL);
+    } else {
+        gcPushRoot(NULL);
     }
     
-    char* filename = evalString(node->left);
-    if (!filename) {
-        printf("%s[READ ERROR]%s Invalid filename\n", COLOR_RED, COLOR_RESET);
-        return;
+    EvalValue value;
+    if (node->type == NODE_COMPOUND_ASSIGN) {
+        MapEntry* e = mapFind(map, key);
+        if (!e) runtime_error(node, "Key not found in map");
+        Variable current;
+        memset(&current, 0, sizeof(Variable));
+        storeValue(&current, copyValue(e->value));
+        executeCompoundAssign(&current, node);
+        value.is_string = current.is_string;
+        value.is_int = !current.is_string && !current.is_float;
+        value.str = current.is_string ? current.value.str_val : NULL;
+        value.num = current.is_string ? 0.0 : varNumber(&current);
+    } else {
+        value = evalValue(node->right);
     }
-    
-    // Check if file exists
-    if (access(filename, F_OK) != 0) {
-        printf("%s[READ ERROR]%s File not found: %s\n", COLOR_RED, COLOR_RESET, filename);
-        free(filename);
+    mapSet(map, key, value);
+    gcPopRoots(2);
+}
+
+// tableau[i] = v, tableau[i] += v : l'élément reste un nombre
+static void executeArrayAssign(ASTNode* node, TypedArray* arr) {
+    gcPushRoot(&arr->gc);
+    double index = evalFloat(node->left->right);
+    double value;
+    if (node->type == NODE_COMPOUND_ASSIGN) {
+        Variable current;
+        memset(&current, 0, sizeof(Variable));
+        setVarNumber(&current, arrayGet(arr, arrayIndex(arr, index, node)));
+        executeCompoundAssign(&current, node);
+        value = varNumber(&current);
+        if (current.is_string) rstr_release(current.value.str_val);
+    } else {
+        value = evalFloat(node->right);
+    }
+    arraySet(arr, arrayIndex(arr, index, node), value);
+    gcPopRoots(1);
+}
+
+// liste[i] = v, liste[i] += v, tableau[i] = v, map[cle] = v
+static void executeIndexAssign(ASTNode* node) {
+    ASTNode* target = node->left;
+    char* id = evalStr(target->left);
+    List* list = listFromId(id);
+    Map* map = list ? NULL : mapFromId(id);
+    TypedArray* arr = list || map ? NULL : arrayFromId(id);
+    rstr_release(id);
+    if (target->op_type == TK_COLON) runtime_error(node, "Cannot assign to a slice");
+    if (map) {
+        executeMapAssign(node, map);
         return;
     }
-    
-    FILE* f = fopen(filename, "r");
-    if (!f) {
-        printf("%s[READ ERROR]%s Cannot open file: %s\n", COLOR_RED, COLOR_RESET, filename);
-        free(filename);
+    if (arr) {
+        executeArrayAssign(node, arr);
         return;
     }
+    if (!list) runtime_error(node, "Index assignment requires a list, a map or an array");
     
-    // Read file content
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    char* content = malloc(size + 1);
-    if (!content) {
-        printf("%s[READ ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
-        fclose(f);
-        free(filename);
-        return;
+    gcPushRoot(&list->gc);
+    double index = evalFloat(target->right);
+    EvalValue value;
+    if (node->type == NODE_COMPOUND_ASSIGN) {
+        Variable current;
+        memset(&current, 0, sizeof(Variable));
+        storeValue(&current, copyValue(list->items[listIndex(list, index, node)]));
+        executeCompoundAssign(&current, node);
+        value.is_string = current.is_string;
+        value.is_int = !current.is_string && !current.is_float;
+        value.str = current.is_string ? current.value.str_val : NULL;
+        value.num = current.is_string ? 0.0 : varNumber(&current);
+    } else {
+        value = evalValue(node->right);
     }
     
-    fread(content, 1, size, f);
-    content[size] = '\0';
-    fclose(f);
+    // La valeur peut avoir modifié la liste : l'index est revérifié
+    EvalValue* slot = &list->items[listIndex(list, index, node)];
+    if (slot->is_string) rstr_release(slot->str);
+    *slot = value;
+    gcPopRoots(1);
+}
+
+// Texte d'une valeur pour print : une liste ou une map est affichée avec ses éléments
+static char* appendDisplay(char* out, EvalValue v, int depth);
+
+static char* appendMap(char* out, Map* map, int depth) {
+    out = rstr_append(out, "{", 1);
+    bool first = true;
+    for (int i = 0; i < map->entry_count; i++) {
+        MapEntry* e = &map->entries[i];
+        if (e->deleted) continue;
+        if (!first) out = rstr_append(out, ", ", 2);
+        first = false;
+        out = appendDisplay(out, e->key, depth + 1);
+        out = rstr_append(out, ": ", 2);
+        out = appendDisplay(out, e->value, depth + 1);
+    }
+    return rstr_append(out, "}", 1);
+}
+
+static char* appendList(char* out, List* list, int depth) {
+    out = rstr_append(out, "[", 1);
+    for (int i = 0; i < list->count; i++) {
+        if (i > 0) out = rstr_append(out, ", ", 2);
+        out = appendDisplay(out, list->items[i], depth + 1);
+    }
+    return rstr_append(out, "]", 1);
+}
+
+static char* appendDisplay(char* out, EvalValue v, int depth) {
+    if (!v.is_string) {
+        char buf[32];
+        int len = formatNumber(buf, sizeof(buf), v.num);
+        return rstr_append(out, buf, (size_t)len);
+    }
+    List* list = depth < 16 ? listFromId(v.str) : NULL;
+    if (list) return appendList(out, list, depth);
+    Map* map = depth < 16 ? mapFromId(v.str) : NULL;
+    if (map) return appendMap(out, map, depth);
+    TypedArray* arr = arrayFromId(v.str);
+    if (arr) return appendArray(out, arr);
+    if (depth == 0) return rstr_append(out, v.str, rstr_len(v.str));
+    out = rstr_append(out, "\"", 1);
+    out = rstr_append(out, v.str, rstr_len(v.str));
+    return rstr_append(out, "\"", 1);
+}
+
+// Chaîne à afficher (référence consommée)
+static char* displayStr(char* str) {
+    HeapHeader* h = heapFromId(str);
+    if (!h || h->kind == HEAP_OBJECT || h->kind == HEAP_TASK || h->kind == HEAP_FUTURE ||
+        h->kind == HEAP_CHAN || h->kind == HEAP_PROC) return str;
+    rstr_release(str);
+    if (h->kind == HEAP_MAP) return appendMap(rstr_new("", 0), (Map*)h, 0);
+    if (h->kind == HEAP_ARRAY) return appendArray(rstr_new("", 0), (TypedArray*)h);
+    return appendList(rstr_new("", 0), (List*)h, 0);
+}
+
+// std.split(s, sep) : liste des champs (sep vide : blancs consécutifs)
+static char* evalSplit(ASTNode* node) {
+    char* str = evalStr(node->left);
+    char* sep = evalStr(node->right);
+    size_t sep_len = rstr_len(sep);
+    const char* p = str;
+    const char* end = str + rstr_len(str);
+    List* list = newList(8);
     
-    // Store in variable if specified
-    if (node->right) {
-        char* var_name = evalString(node->right);
-        if (var_name) {
-            int idx = findVar(var_name);
-            if (idx == -1 && var_count < 1000) {
-                Variable* var = &vars[var_count];
-                strncpy(var->name, var_name, 99);
-                var->name[99] = '\0';
-                var->type = TK_VAR;
-                var->size_bytes = strlen(content) + 1;
-                var->scope_level = scope_level;
-                var->is_constant = false;
-                var->is_initialized = true;
-                var->is_string = true;
-                var->is_float = false;
-                var->value.str_val = str_copy(content);
-                var_count++;
-                printf("%s[READ]%s Stored file content in variable '%s'\n", COLOR_GREEN, COLOR_RESET, var_name);
-            } else if (idx >= 0) {
-                if (vars[idx].value.str_val) free(vars[idx].value.str_val);
-                vars[idx].value.str_val = str_copy(content);
-                vars[idx].is_string = true;
-                vars[idx].is_initialized = true;
-                printf("%s[READ]%s Updated variable '%s' with file content\n", COLOR_GREEN, COLOR_RESET, var_name);
+    if (sep_len == 0) {
+        while (p < end) {
+            while (p < end && isspace((unsigned char)*p)) p++;
+            const char* field = p;
+            while (p < end && !isspace((unsigned char)*p)) p++;
+            if (p > field) {
+                EvalValue v = { true, false, rstr_new(field, (size_t)(p - field)), 0.0 };
+                listPush(list, v);
             }
-            free(var_name);
         }
     } else {
-        // Store in default variable
-        int idx = findVar("__file_content__");
-        if (idx == -1 && var_count < 1000) {
-            Variable* var = &vars[var_count];
-            strcpy(var->name, "__file_content__");
-            var->type = TK_VAR;
-            var->size_bytes = strlen(content) + 1;
-            var->scope_level = scope_level;
-            var->is_constant = false;
-            var->is_initialized = true;
-            var->is_string = true;
-            var->is_float = false;
-            var->value.str_val = str_copy(content);
-            var_count++;
-        } else if (idx >= 0) {
-            if (vars[idx].value.str_val) free(vars[idx].value.str_val);
-            vars[idx].value.str_val = str_copy(content);
-            vars[idx].is_initialized = true;
+        while (true) {
+            const char* hit = p;
+            while (hit + sep_len <= end && memcmp(hit, sep, sep_len) != 0) hit++;
+            if (hit + sep_len > end) hit = end;
+            EvalValue v = { true, false, rstr_new(p, (size_t)(hit - p)), 0.0 };
+            listPush(list, v);
+            if (hit == end) break;
+            p = hit + sep_len;
         }
+    }
+    rstr_release(str);
+    rstr_release(sep);
+    return heapIdStr(&list->gc);
+}
 
+// x in liste / cle in map / sous-chaine in chaine
+static bool evalMembership(ASTNode* node) {
+    EvalValue needle = evalValue(node->left);
+    char* container = evalStr(node->right);
+    bool found = false;
+    List* list = listFromId(container);
+    Map* map = list ? NULL : mapFromId(container);
+    TypedArray* arr = list || map ? NULL : arrayFromId(container);
+    if (map) {
+        found = mapFind(map, needle) != NULL;
+    } else if (arr) {
+        double x = needle.is_string ? strtod(needle.str, NULL) : needle.num;
+        for (int i = 0; i < arr->count && !found; i++) found = arrayGet(arr, i) == x;
+    } else if (list) {
+        for (int i = 0; i < list->count && !found; i++) found = valuesEqual(list->items[i], needle);
+    } else {
+        char* text = needle.is_string ? rstr_retain(needle.str) : numberToRstr(needle.num);
+        found = strstr(container, text) != NULL;
+        rstr_release(text);
     }
-    
-    free(content);
-    free(filename);
+    rstr_release(needle.str);
+    rstr_release(container);
+    return found;
 }
 
-static void executeWrite(ASTNode* node) {
-    if (!node->left || !node->right) {
-        printf("%s[WRITE ERROR]%s Missing filename or data\n", COLOR_RED, COLOR_RESET);
-        return;
+static void setNativeResult(EvalValue v) {
+    rstr_release(native_result.return_string);
+    native_result.return_string = v.is_string ? v.str : NULL;
+    native_result.return_value = v.is_string ? strtod(v.str, NULL) : v.num;
+}
+
+static bool callListAlgorithm(ASTNode* node, List* list, EvalValue* result);
+static EvalValue parallelMap(ASTNode* node, List* list);
+
+// list.push(x...), list.pop(), list.slice(a, b), list.join(sep), list.len(),
+// list.pmap(f) ([SECTION] BOUCLES PARALLÈLES) et les algorithmes de
+// [SECTION] TRI ET RECHERCHE
+static Function* callListMethod(ASTNode* node, List* list) {
+    const char* name = node->data.name;
+    ASTNode* args = node->right;
+    EvalValue result = { false, false, NULL, 0.0 };
+    
+    gcPushRoot(&list->gc);
+    if (strcmp(name, "push") == 0) {
+        for (ASTNode* arg = args; arg; arg = arg->next) listPush(list, evalValue(arg));
+        result.num = list->count;
+    } else if (strcmp(name, "pop") == 0) {
+        if (list->count == 0) runtime_error(node, "pop() on an empty list");
+        result = list->items[--list->count];
+    } else if (strcmp(name, "slice") == 0) {
+        long start, end;
+        sliceBounds(args, args ? args->next : NULL, list->count, &start, &end);
+        result = listValue(listSlice(list, start, end));
+    } else if (strcmp(name, "join") == 0) {
+        char* sep = args ? evalStr(args) : rstr_new("", 0);
+        char* out = rstr_new("", 0);
+        for (int i = 0; i < list->count; i++) {
+            if (i > 0) out = rstr_append(out, sep, rstr_len(sep));
+            out = appendDisplay(out, list->items[i], 0);
+        }
+        rstr_release(sep);
+        result.is_string = true;
+        result.str = out;
+    } else if (strcmp(name, "len") == 0) {
+        result.num = list->count;
+    } else if (strcmp(name, "pmap") == 0) {
+        result = parallelMap(node, list);
+    } else if (!callListAlgorithm(node, list, &result)) {
+        runtime_error(node, "Unknown list method '%s'", name);
     }
+    gcPopRoots(1);
     
-    char* filename = evalString(node->left);
-    char* data = evalString(node->right);
+    setNativeResult(result);
+    return &native_result;
+}
+
+// map.has(k), map.get(k, defaut), map.set(k, v), map.remove(k), map.keys(),
+// map.values(), map.len()
+static Function* callMapMethod(ASTNode* node, Map* map) {
+    const char* name = node->data.name;
+    ASTNode* args = node->right;
+    EvalValue result = { false, false, NULL, 0.0 };
     
-    if (!filename || !data) {
-        if (filename) free(filename);
-        if (data) free(data);
-        return;
+    gcPushRoot(&map->gc);
+    if (strcmp(name, "has") == 0 || strcmp(name, "remove") == 0) {
+        EvalValue key = evalValue(args);
+        result.is_int = true;
+        result.num = name[0] == 'h' ? mapFind(map, key) != NULL : mapRemove(map, key);
+        rstr_release(key.str);
+    } else if (strcmp(name, "get") == 0) {
+        EvalValue key = evalValue(args);
+        MapEntry* e = mapFind(map, key);
+        rstr_release(key.str);
+        if (e) result = copyValue(e->value);
+        else if (args && args->next) result = evalValue(args->next);
+    } else if (strcmp(name, "set") == 0) {
+        if (!args || !args->next) runtime_error(node, "map.set(key, value) expects two arguments");
+        EvalValue key = evalValue(args);
+        mapSet(map, key, evalValue(args->next));
+    } else if (strcmp(name, "keys") == 0 || strcmp(name, "values") == 0) {
+        bool keys = name[0] == 'k';
+        List* list = newList(map->count);
+        for (int i = 0; i < map->entry_count; i++) {
+            MapEntry* e = &map->entries[i];
+            if (!e->deleted) listPush(list, copyValue(keys ? e->key : e->value));
+        }
+        result = listValue(list);
+    } else if (strcmp(name, "len") == 0) {
+        result.num = map->count;
+    } else {
+        runtime_error(node, "Unknown map method '%s'", name);
     }
+    gcPopRoots(1);
     
-    char* mode = "w"; // Default write mode
-    if (node->third) {
-        char* mode_str = evalString(node->third);
-        if (mode_str && (strcmp(mode_str, "a") == 0 || strcmp(mode_str, "append") == 0)) {
-            mode = "a";
+    setNativeResult(result);
+    return &native_result;
+}
+
+// tableau.push(x...), tableau.len(), tableau.to_list()
+static Function* callArrayMethod(ASTNode* node, TypedArray* arr) {
+    const char* name = node->data.name;
+    EvalValue result = { false, false, NULL, 0.0 };
+    
+    gcPushRoot(&arr->gc);
+    if (strcmp(name, "push") == 0) {
+        for (ASTNode* arg = node->right; arg; arg = arg->next) arrayPush(arr, evalFloat(arg));
+        result.num = arr->count;
+    } else if (strcmp(name, "len") == 0) {
+        result.num = arr->count;
+    } else if (strcmp(name, "to_list") == 0) {
+        List* list = newList(arr->count);
+        for (int i = 0; i < arr->count; i++) {
+            EvalValue v = { false, false, NULL, arrayGet(arr, i) };
+            listPush(list, v);
         }
-        free(mode_str);
+        result = listValue(list);
+    } else {
+        runtime_error(node, "Unknown array method '%s'", name);
     }
+    gcPopRoots(1);
     
-    FILE* f = fopen(filename, mode);
-    if (!f) {
-        printf("%sWRITE ERROR%s Cannot open file for writing: %s\n", COLOR_RED, COLOR_RESET, filename);
-        free(filename);
-        free(data);
-        return;
+    setNativeResult(result);
+    return &native_result;
+}
+
+// Opérande d'une opération groupée : tableau typé, ou liste convertie en
+// float64 (racine temporaire ajoutée, à retirer par l'appelant)
+static TypedArray* vectorFromValue(const char* id, ASTNode* node, int* rooted) {
+    TypedArray* arr = arrayFromId(id);
+    if (!arr) {
+        List* list = listFromId(id);
+        if (list) arr = arrayFrom(false, list, NULL);
     }
+    if (!arr) runtime_error(node, "Expected a float64/int64 array or a list");
+    gcPushRoot(&arr->gc);
+    (*rooted)++;
+    return arr;
+}
+
+static TypedArray* vectorOperand(ASTNode* node, int* rooted) {
+    char* id = evalStr(node);
+    TypedArray* arr = vectorFromValue(id, node, rooted);
+    rstr_release(id);
+    return arr;
+}
+
+// math.sum / min / max / mean / dot
+static double evalVectorReduce(ASTNode* node) {
+    int rooted = 0;
+    TypedArray* a = vectorOperand(node->left, &rooted);
+    size_t n = (size_t)a->count;
+    double result = 0.0;
     
-    size_t written = fwrite(data, 1, strlen(data), f);
-    fclose(f);
+    if (node->op_type == TK_MATH_DOT) {
+        TypedArray* b = vectorOperand(node->right, &rooted);
+        if (b->count != a->count) runtime_error(node, "math.dot: length mismatch (%d vs %d)", a->count, b->count);
+        if (a->is_int || b->is_int) {
+            // Produit scalaire d'entiers : calculé en float64
+            TypedArray* fa = a->is_int ? arrayFrom(false, NULL, a) : a;
+            gcPushRoot(&fa->gc);
+            TypedArray* fb = b->is_int ? arrayFrom(false, NULL, b) : b;
+            gcPushRoot(&fb->gc);
+            rooted += 2;
+            result = std_vec_dot_f64(fa->data.f64, fb->data.f64, n);
+        } else {
+            result = std_vec_dot_f64(a->data.f64, b->data.f64, n);
+        }
+    } else if (node->op_type == TK_MATH_SUM || node->op_type == TK_MATH_MEAN) {
+        result = a->is_int ? (double)std_vec_sum_i64(a->data.i64, n) : std_vec_sum_f64(a->data.f64, n);
+        if (node->op_type == TK_MATH_MEAN) {
+            if (n == 0) runtime_error(node, "math.mean of an empty array");
+            result /= (double)n;
+        }
+    } else {
+        if (n == 0) runtime_error(node, "math.%s of an empty array", node->op_type == TK_MATH_MIN ? "min" : "max");
+        if (node->op_type == TK_MATH_MIN) {
+            result = a->is_int ? (double)std_vec_min_i64(a->data.i64, n) : std_vec_min_f64(a->data.f64, n);
+        } else {
+            result = a->is_int ? (double)std_vec_max_i64(a->data.i64, n) : std_vec_max_f64(a->data.f64, n);
+        }
+    }
+    gcPopRoots(rooted);
+    return result;
+}
+
+// math.float64 / int64 / add / sub / mul / div : nouveau tableau (rstr "arr_N")
+static char* evalVectorOp(ASTNode* node) {
+    int op = node->op_type;
+    if (op == TK_MATH_SIMD) return rstr_from(std_vec_backend());
     
-    const char* mode_desc = (mode[0] == 'a') ? "appended to" : "written to";
-        
-    free(filename);
-    free(data);
+    if (op == TK_MATH_F64 || op == TK_MATH_I64) {
+        bool is_int = op == TK_MATH_I64;
+        EvalValue src = evalValue(node->left);
+        TypedArray* arr = NULL;
+        if (src.is_string) {
+            List* list = listFromId(src.str);
+            TypedArray* other = list ? NULL : arrayFromId(src.str);
+            if (!list && !other) runtime_error(node, "math.%s expects a list, an array or a length", is_int ? "int64" : "float64");
+            arr = arrayFrom(is_int, list, other);
+        } else {
+            if (src.num < 0 || src.num > INT_MAX) runtime_error(node, "Invalid array length");
+            arr = newArray(is_int, (int)src.num);
+        }
+        rstr_release(src.str);
+        return heapIdStr(&arr->gc);
+    }
+    
+    int rooted = 0;
+    TypedArray* a = vectorOperand(node->left, &rooted);
+    TypedArray* b = NULL;
+    double scalar = 0.0;
+    EvalValue right = evalValue(node->right);
+    if (right.is_string && (arrayFromId(right.str) || listFromId(right.str))) {
+        b = vectorFromValue(right.str, node->right, &rooted);
+        rstr_release(right.str);
+    } else {
+        scalar = right.is_string ? strtod(right.str, NULL) : right.num;
+        rstr_release(right.str);
+    }
+    if (b && b->count != a->count) {
+        runtime_error(node, "Element-wise operation: length mismatch (%d vs %d)", a->count, b->count);
+    }
+    
+    int vop = op == TK_MATH_VADD ? TK_PLUS : op == TK_MATH_VSUB ? TK_MINUS :
+              op == TK_MATH_VMUL ? TK_MULT : TK_DIV;
+    bool int_result = a->is_int && (b ? b->is_int : scalar == (int64_t)scalar) && vop != TK_DIV;
+    size_t n = (size_t)a->count;
+    TypedArray* out = newArray(int_result, a->count);
+    
+    if (int_result) {
+        if (b) std_vec_op_i64(vop, a->data.i64, b->data.i64, out->data.i64, n);
+        else std_vec_op_scalar_i64(vop, a->data.i64, (int64_t)scalar, out->data.i64, n);
+    } else {
+        gcPushRoot(&out->gc);
+        rooted++;
+        TypedArray* fa = a->is_int ? arrayFrom(false, NULL, a) : a;
+        gcPushRoot(&fa->gc);
+        TypedArray* fb = b && b->is_int ? arrayFrom(false, NULL, b) : b;
+        gcPushRoot(fb ? &fb->gc : NULL);
+        rooted += 2;
+        if (fb) std_vec_op_f64(vop, fa->data.f64, fb->data.f64, out->data.f64, n);
+        else std_vec_op_scalar_f64(vop, fa->data.f64, scalar, out->data.f64, n);
+    }
+    gcPopRoots(rooted);
+    return heapIdStr(&out->gc);
 }
 
-static void executeAppend(ASTNode* node) {
-    if (!node->left || !node->right) {
-        printf("%s[APPEND ERROR]%s Missing filename or data\n", COLOR_RED, COLOR_RESET);
-        return;
+// Crée les paramètres de func (références consommées)
+// site : noeud signalé si la zone de variables est pleine
+static void bindValues(Function* func, EvalValue* values, int count, int param_scope, ASTNode* site) {
+    for (int i = 0; i < count; i++) {
+        if (i >= func->param_count || !func->param_names[i]) {
+            rstr_release(values[i].str);
+            continue;
+        }
+        if (var_count >= var_limit) {
+            runtime_error(site, "Too many variables (parameter '%s' of %s)", func->param_names[i], func->name);
+        }
+        int idx = var_count++;
+        memset(&vars[idx], 0, sizeof(Variable));
+        setVarName(&vars[idx], func->param_names[i]);
+        vars[idx].type = TK_VAR;
+        vars[idx].size_bytes = 8;
+        vars[idx].scope_level = param_scope;
+        storeValue(&vars[idx], values[i]);
     }
+}
+
+// Évalue tous les arguments dans la portée de l'appelant, puis crée les
+// paramètres : un appel imbriqué dans un argument ne peut plus réutiliser
+// le slot d'un paramètre en cours de création.
+static void bindArguments(Function* func, ASTNode* args, int caller_scope) {
+    if (!func->param_names || func->param_count <= 0) return;
     
-    char* filename = evalString(node->left);
-    char* data = evalString(node->right);
+    int param_scope = scope_level;
+    EvalValue values[func->param_count];
+    int count = 0;
     
-    if (!filename || !data) {
-        if (filename) free(filename);
-        if (data) free(data);
-        return;
+    // Les objets déjà évalués restent des racines pendant l'évaluation des
+    // arguments suivants (qui peuvent atteindre un point sûr du GC)
+    int rooted = 0;
+    scope_level = caller_scope;
+    for (ASTNode* arg = args; arg && count < func->param_count; arg = arg->next) {
+        values[count] = evalValue(arg);
+        if (values[count].is_string) {
+            HeapHeader* h = heapFromId(values[count].str);
+            if (h) { gcPushRoot(h); rooted++; }
+        }
+        count++;
     }
+    scope_level = param_scope;
+    gcPopRoots(rooted);
     
-    FILE* f = fopen(filename, "a");
-    if (!f) {
-        printf("%s[APPEND ERROR]%s Cannot open file for appending: %s\n", COLOR_RED, COLOR_RESET, filename);
-        free(filename);
-        free(data);
-        return;
+    bindValues(func, values, count, param_scope, args);
+}
+
+// Exécute le corps de func dans la frame ouverte par l'appelant, puis la
+// referme (paramètres et variables locales retirés)
+static void runFunctionBody(Function* func, int old_scope, int var_mark, Function* prev_func) {
+    func->has_returned = false;
+    func->return_value = 0;
+    rstr_release(func->return_string);
+    func->return_string = NULL;
+    if (func->body) execute(func->body);
+    func->has_returned = false; // l'activation appelante (récursion) continue
+    
+    io_release_appends(old_scope + 1); // Handles d'append ouverts pendant l'appel
+    scope_level = old_scope;
+    releaseScopeVars(var_mark, old_scope); // Paramètres : la frame est dépilée
+    current_function = prev_func;
+}
+
+// Appel depuis le code natif (clé de tri, group_by...) avec des valeurs déjà
+// évaluées (références consommées). Résultat dans return_string / return_value.
+static void callFunctionValues(Function* func, EvalValue* values, int count) {
+    Function* prev_func = current_function;
+    current_function = func;
+    int old_scope = scope_level;
+    int var_mark = var_count;
+    scope_level++;
+    bindValues(func, values, count, scope_level, func->params);
+    runFunctionBody(func, old_scope, var_mark, prev_func);
+}
+
+// Appel d'une fonction ou d'une méthode (obj.methode(...)).
+// Retourne la fonction exécutée (résultat dans return_string / return_value)
+// ou NULL si elle n'existe pas.
+static Function* callFunction(ASTNode* node) {
+    ASTNode* args = node->left;
+    char* inst_id = NULL; // rstr gardée pendant l'appel (this)
+    Object* obj = NULL;
+    Function* func = NULL;
+    
+    if (node->type == NODE_METHOD_CALL) {
+        inst_id = evalStr(node->left);
+        obj = objectFromId(inst_id);
+        if (!obj) {
+            List* list = listFromId(inst_id);
+            Map* map = list ? NULL : mapFromId(inst_id);
+            TypedArray* arr = list || map ? NULL : arrayFromId(inst_id);
+            ChanRef* chan = list || map || arr ? NULL : chanFromId(inst_id);
+            ProcRef* proc = list || map || arr || chan ? NULL : procFromId(inst_id);
+            rstr_release(inst_id);
+            if (list) return callListMethod(node, list);
+            if (map) return callMapMethod(node, map);
+            if (arr) return callArrayMethod(node, arr);
+            if (chan) return callChanMethod(node, chan);
+            if (proc) return callProcMethod(node, proc);
+            runtime_error(node, "Object instance has no class");
+            return NULL;
+        }
+        args = node->right;
+        // Cache en ligne : même classe qu'au dernier appel -> même fonction
+        if (node->ic_target && node->ic_slot == obj->class_sym) {
+            func = node->ic_target;
+        } else {
+            func = findFunctionSym(intern_member(obj->class_sym, nodeSym(node)));
+            if (!func) {
+                runtime_error(node, "Method '%s' not found in class '%s'", node->data.name, obj->class_name);
+            }
+            node->ic_target = func;
+            node->ic_slot = obj->class_sym;
+        }
+    } else {
+        int func_sym = nodeSym(node);
+        char* dot = strchr(node->data.name, '.');
+        if (dot) {
+            // Ancienne forme "obj.methode" portée par un seul nom
+            int idx = findVarSym(intern_len(node->data.name, dot - node->data.name));
+            if (idx >= 0 && vars[idx].is_string) obj = objectFromId(vars[idx].value.str_val);
+            if (obj) {
+                inst_id = rstr_retain(vars[idx].value.str_val);
+                func_sym = intern_member(obj->class_sym, intern(dot + 1));
+            }
+        }
+        func = findFunctionSym(func_sym);
+        // Fonctions natives (spawn, chan, select), masquées par une fonction du script de même nom
+        if (!func && !obj) {
+            Function* native = callIsolateBuiltin(node, args);
+            if (native) return native;
+        }
     }
     
-    size_t written = fwrite(data, 1, strlen(data), f);
-    fclose(f);
+    char* prev_this = current_this;
+    Object* prev_this_obj = current_this_obj;
+    if (obj) {
+        current_this = inst_id;
+        current_this_obj = obj;
+    }
+    gcPushRoot(prev_this_obj ? &prev_this_obj->gc : NULL); // 'this' de l'appelant, masqué pendant l'appel
     
+    if (func && func->is_async) {
+        Function* result = spawnTask(func, args, node);
+        gcPopRoots(1);
+        current_this = prev_this;
+        current_this_obj = prev_this_obj;
+        rstr_release(inst_id);
+        return result;
+    }
+    if (func) {
+        Function* prev_func = current_function;
+        current_function = func;
+        int old_scope = scope_level;
+        int var_mark = var_count;
+        scope_level++;
         
-    free(filename);
-    free(data);
+        bindArguments(func, args, old_scope);
+        runFunctionBody(func, old_scope, var_mark, prev_func);
+    }
+    
+    gcPopRoots(1);
+    current_this = prev_this;
+    current_this_obj = prev_this_obj;
+    rstr_release(inst_id);
+    return func;
 }
 
 // ======================================================
-// [SECTION] WELD FUNCTION
+// [SECTION] TÂCHES ASYNC
 // ======================================================
-static char* weldInput(const char* prompt) {
-    if (prompt) {
-        printf("%s", prompt);
-        fflush(stdout);
+// L'appel d'une fonction 'async func' évalue ses arguments, puis lance le
+// corps dans une coroutine (sched.c) et rend aussitôt "task_N". La tâche
+// s'exécute dès que le code courant attend (await, time.sleep, E/S réseau ou
+// http) ; 'await task_N' suspend l'appelant jusqu'à sa fin et rend la valeur
+// retournée. Tout tourne sur un seul thread : entre deux points d'attente,
+// une tâche n'est jamais interrompue.
+
+static AsyncTask* taskFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_TASK ? (AsyncTask*)h : NULL;
+}
+
+static void taskEntry(void* arg) {
+    int t = (int)(intptr_t)arg;
+    loadTaskContext(t);
+    TaskContext* ctx = &task_contexts[t];
+    Function* func = ctx->entry;
+    EvalValue* args = ctx->args;
+    ctx->args = NULL;
+    callFunctionValues(func, args, ctx->arg_count);
+    free(args);
+    
+    AsyncTask* task = ctx->task;
+    if (func->return_string) {
+        task->result.is_string = true;
+        task->result.str = rstr_retain(func->return_string);
+    } else {
+        task->result.num = func->return_value;
     }
+    task->done = true;
     
-    char* input = malloc(1024);
-    if (input) {
-        if (fgets(input, 1024, stdin)) {
-            input[strcspn(input, "\n")] = 0;
-        } else {
-            strcpy(input, "");
+    // Slot rendu : la zone de variables est vide au retour de la fonction
+    free(gc_roots);
+    gc_roots = NULL;
+    gc_root_count = gc_root_cap = 0;
+    saveTaskContext(ctx->sched_id);
+    ctx->sched_id = 0;
+    ctx->task = NULL;
+}
+
+// Lance func(values...) dans un contexte neuf (portée 0 de sa propre zone).
+// roots : valeurs du tas parmi les arguments, racines de la tâche jusqu'à
+// sa fin (elle peut ne démarrer qu'après plusieurs points sûrs). Ne touche
+// pas au contexte courant : utilisable depuis un rappel de minuteur.
+static AsyncTask* startTask(Function* func, EvalValue* values, int count,
+                            HeapHeader** roots, int rooted, ASTNode* node) {
+    int t = 1;
+    while (t <= MAX_TASKS && task_contexts[t].sched_id > 0) t++;
+    if (t > MAX_TASKS) runtime_error(node, "Too many running async tasks (max %d)", MAX_TASKS);
+    
+    AsyncTask* task = calloc(1, sizeof(AsyncTask));
+    if (!task) { fprintf(stderr, "%s[FATAL]%s Out of memory (task)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    heapInsert(&task->gc, HEAP_TASK, sizeof(AsyncTask));
+    
+    TaskContext* ctx = &task_contexts[t];
+    memset(ctx, 0, sizeof(TaskContext));
+    ctx->var_count = contextVarBase(t);
+    ctx->roots = roots;
+    ctx->root_count = ctx->root_cap = rooted;
+    ctx->task = task;
+    ctx->entry = func;
+    ctx->args = values;
+    ctx->arg_count = count;
+    ctx->sched_id = sched_spawn(taskEntry, (void*)(intptr_t)t);
+    if (ctx->sched_id <= 0) runtime_error(node, "Cannot start async task '%s'", func->name);
+    task->sched_id = ctx->sched_id;
+    return task;
+}
+
+static Function* spawnTask(Function* func, ASTNode* args, ASTNode* node) {
+    int count = 0;
+    for (ASTNode* arg = args; arg; arg = arg->next) count++;
+    EvalValue* values = calloc(count ? count : 1, sizeof(EvalValue));
+    if (!values) { fprintf(stderr, "%s[FATAL]%s Out of memory (task)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    
+    HeapHeader** roots = NULL;
+    int rooted = 0;
+    count = 0;
+    for (ASTNode* arg = args; arg; arg = arg->next) {
+        EvalValue v = evalValue(arg);
+        HeapHeader* h = v.is_string ? heapFromId(v.str) : NULL;
+        if (h) {
+            gcPushRoot(h);
+            roots = realloc(roots, (rooted + 1) * sizeof(HeapHeader*));
+            if (!roots) { fprintf(stderr, "%s[FATAL]%s Out of memory (task)\n", COLOR_RED, COLOR_RESET); exit(1); }
+            roots[rooted++] = h;
         }
+        values[count++] = v;
     }
-    return input;
+    
+    AsyncTask* task = startTask(func, values, count, roots, rooted, node);
+    gcPopRoots(rooted);
+    
+    EvalValue id = { true, false, heapIdStr(&task->gc), 0.0 };
+    setNativeResult(id);
+    return &native_result;
 }
-// Helper pour enregistrer une constante (utilisé par ENUM)
-static void registerGlobalConstant(const char* name, int value) {
-    if (var_count < 1000) {
-        Variable* var = &vars[var_count];
-        strncpy(var->name, name, 99);
-        var->type = TK_CONST;
-        var->size_bytes = 8;
-        var->scope_level = 0; // Toujours global
-        var->is_constant = true;
-        var->is_initialized = true;
-        var->is_float = false;
-        var->is_string = false;
-        var->value.int_val = value;
-        var_count++;
-        
-    }
+
+// Attend la fin de la tâche ; résultat comme evalAwait (chaîne allouée ou *num)
+static char* awaitTask(AsyncTask* task, double* num) {
+    gcPushRoot(&task->gc);
+    while (!task->done) sched_join(task->sched_id);
+    gcPopRoots(1);
+    if (task->result.is_string) return str_copy(task->result.str);
+    *num = task->result.num;
+    return NULL;
 }
 
-// Helper pour générer un nom unique pour les lambdas
-static char* generateLambdaName() {
-    static int lambda_id = 0;
-    char* name = malloc(32);
-    sprintf(name, "__lambda_%d", lambda_id++);
-    return name;
+// Minuteurs (time.after / time.every) : à chaque échéance, la boucle
+// d'événements lance la fonction dans une nouvelle tâche
+typedef struct {
+    Function* func;
+    ASTNode* node;   // appel time.after / time.every (erreurs)
+    bool repeat;
+} TimerCallback;
+
+static void timerFire(void* arg) {
+    TimerCallback* cb = arg;
+    startTask(cb->func, NULL, 0, NULL, 0, cb->node);
+    if (!cb->repeat) free(cb);
+}
+
+static double evalTimeFunc(ASTNode* node) {
+    switch (node->op_type) {
+        case TK_TIME_NOW_NS: return std_time_now_ns();
+        case TK_TIME_PERF: return std_time_perf();
+        case TK_TIME_CANCEL: {
+            TimerCallback* cb = sched_timer_cancel((int)evalFloat(node->left));
+            free(cb);
+            return cb ? 1.0 : 0.0;
+        }
+        default: {
+            double delay = evalFloat(node->left);
+            bool repeat = node->op_type == TK_TIME_EVERY;
+            if (repeat && delay <= 0) runtime_error(node, "time.every needs a period > 0");
+            TimerCallback* cb = malloc(sizeof(TimerCallback));
+            if (!cb) { fprintf(stderr, "%s[FATAL]%s Out of memory (timer)\n", COLOR_RED, COLOR_RESET); exit(1); }
+            cb->func = resolveCallable(node->right);
+            cb->node = node;
+            cb->repeat = repeat;
+            return (double)sched_timer_add(delay, repeat ? delay : 0, timerFire, cb);
+        }
+    }
 }
+
 // ======================================================
-// [SECTION] MAIN EXECUTION FUNCTION
+// [SECTION] TRI ET RECHERCHE
 // ======================================================
-static void execute(ASTNode* node) {
-    if (!node) return;
-    
-    switch (node->type) {
-    case NODE_ENV_FUNC: {
-        if (node->op_type == TK_ENV_SET) {
-            char* key = evalString(node->left);
-            char* val = evalString(node->right);
-            std_env_set(key, val);
-            free(key); free(val);
+// Tri natif des listes : les clés (élément ou résultat de la fonction 'key')
+// sont calculées une seule fois par élément, puis triées par un introsort
+// (quicksort médiane de trois, repli heapsort, insertion pour les petites
+// tranches) avec un comparateur C spécialisé : tout numérique, tout string
+// (memcmp), ou mixte (nombres avant strings). L'index d'origine départage
+// les égalités, ce qui rend le tri stable.
+
+typedef struct {
+    double num;
+    const char* str;   // NULL : clé numérique
+    size_t len;
+    int index;         // position d'origine dans la liste
+} SortItem;
+
+typedef int (*SortCompare)(const SortItem*, const SortItem*);
+
+static ISOLATE int sort_direction = 1;    // -1 : ordre décroissant
+static ISOLATE bool sort_tiebreak = true; // false : {stable: false}
+
+static int sortCompareIndex(const SortItem* a, const SortItem* b) {
+    return sort_tiebreak ? (a->index > b->index) - (a->index < b->index) : 0;
+}
+
+static int sortCompareNum(const SortItem* a, const SortItem* b) {
+    int c = (a->num > b->num) - (a->num < b->num);
+    return c ? c * sort_direction : sortCompareIndex(a, b);
+}
+
+static int sortCompareStr(const SortItem* a, const SortItem* b) {
+    int c = memcmp(a->str, b->str, a->len < b->len ? a->len : b->len);
+    if (c == 0) c = (a->len > b->len) - (a->len < b->len);
+    else c = c < 0 ? -1 : 1;
+    return c ? c * sort_direction : sortCompareIndex(a, b);
+}
+
+static int sortCompareMixed(const SortItem* a, const SortItem* b) {
+    if (!a->str != !b->str) return (a->str ? 1 : -1) * sort_direction;
+    return a->str ? sortCompareStr(a, b) : sortCompareNum(a, b);
+}
+
+static void sortInsertion(SortItem* a, int n, SortCompare cmp) {
+    for (int i = 1; i < n; i++) {
+        SortItem item = a[i];
+        int j = i;
+        while (j > 0 && cmp(&item, &a[j - 1]) < 0) {
+            a[j] = a[j - 1];
+            j--;
         }
-        break;
+        a[j] = item;
+    }
+}
+
+static void sortSiftDown(SortItem* a, int root, int n, SortCompare cmp) {
+    SortItem item = a[root];
+    for (int child = 2 * root + 1; child < n; child = 2 * root + 1) {
+        if (child + 1 < n && cmp(&a[child + 1], &a[child]) > 0) child++;
+        if (cmp(&a[child], &item) <= 0) break;
+        a[root] = a[child];
+        root = child;
     }
-    case NODE_METHOD_CALL: {
-        char* method_name = node->data.name;
+    a[root] = item;
+}
+
+static void sortHeap(SortItem* a, int n, SortCompare cmp) {
+    for (int i = n / 2 - 1; i >= 0; i--) sortSiftDown(a, i, n, cmp);
+    for (int end = n - 1; end > 0; end--) {
+        SortItem tmp = a[0]; a[0] = a[end]; a[end] = tmp;
+        sortSiftDown(a, 0, end, cmp);
+    }
+}
+
+static void sortIntro(SortItem* a, int n, int depth, SortCompare cmp) {
+    while (n > 16) {
+        if (depth-- == 0) {
+            sortHeap(a, n, cmp);
+            return;
+        }
+        // Médiane de trois : premier, milieu, dernier
+        int mid = (n - 1) / 2;
+        SortItem tmp;
+        if (cmp(&a[mid], &a[0]) < 0) { tmp = a[mid]; a[mid] = a[0]; a[0] = tmp; }
+        if (cmp(&a[n - 1], &a[mid]) < 0) {
+            tmp = a[n - 1]; a[n - 1] = a[mid]; a[mid] = tmp;
+            if (cmp(&a[mid], &a[0]) < 0) { tmp = a[mid]; a[mid] = a[0]; a[0] = tmp; }
+        }
         
-        char* inst_id = evalString(node->left);
-        if (!inst_id) {
-            runtime_error(node, "Cannot call method on a null object");
-            break;
+        // Partition de Hoare : [0, j] <= pivot <= [j + 1, n)
+        SortItem pivot = a[mid];
+        int i = -1, j = n;
+        for (;;) {
+            do i++; while (cmp(&a[i], &pivot) < 0);
+            do j--; while (cmp(&a[j], &pivot) > 0);
+            if (i >= j) break;
+            tmp = a[i]; a[i] = a[j]; a[j] = tmp;
         }
         
-        // 2. Trouver la classe de l'instance (ex: "Zarch")
-        char* cls = findClassOf(inst_id);
-        if (!cls) {
-            runtime_error(node, "Object instance has no class");
-            free(inst_id);
-            break;
+        // Récursion sur la plus petite moitié, boucle sur la plus grande
+        if (j + 1 < n - j - 1) {
+            sortIntro(a, j + 1, depth, cmp);
+            a += j + 1;
+            n -= j + 1;
+        } else {
+            sortIntro(a + j + 1, n - j - 1, depth, cmp);
+            n = j + 1;
         }
+    }
+    sortInsertion(a, n, cmp);
+}
 
-        // 3. Construire le nom interne de la fonction (ex: "Zarch_install")
-        char real_func_name[256];
-        snprintf(real_func_name, 256, "%s_%s", cls, method_name);
+static void sortItems(SortItem* items, int n, SortCompare cmp) {
+    int depth = 0;
+    for (int m = n; m > 1; m >>= 1) depth += 2;
+    sortIntro(items, n, depth, cmp);
+}
 
-        Function* func = findFunction(real_func_name);
-        if (!func) {
-            runtime_error(node, "Method '%s' not found in class '%s'", method_name, cls);
-            free(inst_id);
-            break;
+// Fonction passée en argument : lambda, nom de fonction (identifiant ou string)
+static Function* resolveCallable(ASTNode* arg) {
+    if (!arg) return NULL;
+    if (arg->type == NODE_LAMBDA) return lambdaFunction(arg);
+    if (arg->type == NODE_IDENT && findVarSym(nodeSym(arg)) < 0) {
+        Function* func = findFunctionSym(nodeSym(arg));
+        if (func) return func;
+    }
+    char* name = evalStr(arg);
+    Function* func = findFunctionSym(intern(name));
+    if (!func) runtime_error(arg, "'%s' is not a function", name);
+    rstr_release(name);
+    return func;
+}
+
+// Appelle key(v) et retourne son résultat (nouvelle référence)
+static EvalValue callKey(Function* key, EvalValue v) {
+    EvalValue arg = copyValue(v);
+    callFunctionValues(key, &arg, 1);
+    EvalValue result = { false, false, NULL, key->return_value };
+    if (key->return_string) {
+        result.is_string = true;
+        result.str = rstr_retain(key->return_string);
+    }
+    return result;
+}
+
+// Clés de tri de la liste : éléments, ou key(élément) calculé une seule fois.
+// keys[] reçoit les références à libérer, le comparateur adapté est retourné.
+static SortCompare buildSortItems(ASTNode* node, List* list, Function* key, SortItem* items, EvalValue* keys) {
+    int count = list->count;
+    bool has_num = false, has_str = false;
+    for (int i = 0; i < count; i++) {
+        keys[i] = key ? callKey(key, list->items[i]) : copyValue(list->items[i]);
+        if (list->count != count) runtime_error(node, "List modified by the key function during sort");
+    }
+    for (int i = 0; i < count; i++) {
+        items[i].index = i;
+        if (keys[i].is_string) {
+            items[i].str = keys[i].str;
+            items[i].len = rstr_len(keys[i].str);
+            items[i].num = 0;
+            has_str = true;
+        } else {
+            items[i].str = NULL;
+            items[i].len = 0;
+            items[i].num = keys[i].num;
+            has_num = true;
         }
+    }
+    if (has_str && has_num) return sortCompareMixed;
+    return has_str ? sortCompareStr : sortCompareNum;
+}
 
-        // --- EXÉCUTION (similaire à NODE_FUNC_CALL) ---
-        char* prev_this = current_this;
-        current_this = inst_id; // Injecter 'this'
+static void releaseKeys(EvalValue* keys, int count) {
+    for (int i = 0; i < count; i++) rstr_release(keys[i].str);
+    free(keys);
+}
 
-        Function* prev_func = current_function;
-        current_function = func;
-        int old_scope = scope_level;
-        scope_level++;
+// Options : l.sort(f) ou l.sort({key: f, reverse: true, stable: false})
+static Function* sortKeyOption(ASTNode* opts) {
+    if (!opts) return NULL;
+    if (opts->type != NODE_MAP) return resolveCallable(opts);
+    ASTNode* key = findOption(opts, "key");
+    return key ? resolveCallable(key) : NULL;
+}
 
-        // Passage des arguments (le code que tu as déjà)
-        if (node->right && func->param_names) {
-            ASTNode* arg = node->right;
-            int param_idx = 0;
-            while (arg && param_idx < func->param_count) {
-                // ... (Logique de binding des arguments) ...
-                if (var_count < 1000) {
-                    Variable* var = &vars[var_count++];
-                    strncpy(var->name, func->param_names[param_idx], 99);
-                    var->scope_level = scope_level;
-                    var->is_initialized = true;
-                    if(arg->type == NODE_STRING) {
-                        var->is_string = true;
-                        var->value.str_val = evalString(arg);
-                    } else {
-                        var->is_float = true;
-                        var->value.float_val = evalFloat(arg);
-                    }
-                }
-                arg = arg->right;
-                param_idx++;
-            }
-        }
-        
-        func->has_returned = false;
-        if (func->body) execute(func->body);
-        
-        // Restauration
-        scope_level = old_scope;
-        current_function = prev_func;
-        current_this = prev_this; // Restaurer 'this'
-        free(inst_id);
-        break;
+static bool sortFlagOption(ASTNode* opts, const char* name, bool def) {
+    ASTNode* value = findOption(opts, name);
+    return value ? evalBool(value) : def;
+}
+
+// Trie la liste en place
+static void sortList(ASTNode* node, List* list, ASTNode* opts) {
+    int count = list->count;
+    if (count < 2) return;
+    Function* key = sortKeyOption(opts);
+    bool reverse = sortFlagOption(opts, "reverse", false);
+    bool stable = sortFlagOption(opts, "stable", true);
+    
+    SortItem* items = malloc(count * sizeof(SortItem));
+    EvalValue* keys = malloc(count * sizeof(EvalValue));
+    EvalValue* sorted = malloc(count * sizeof(EvalValue));
+    if (!items || !keys || !sorted) { fprintf(stderr, "%s[FATAL]%s Out of memory (sort)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    
+    SortCompare cmp = buildSortItems(node, list, key, items, keys);
+    sort_direction = reverse ? -1 : 1;
+    sort_tiebreak = stable;
+    sortItems(items, count, cmp);
+    
+    for (int i = 0; i < count; i++) sorted[i] = list->items[items[i].index];
+    memcpy(list->items, sorted, count * sizeof(EvalValue));
+    free(sorted);
+    free(items);
+    releaseKeys(keys, count);
+}
+
+// Ordre naturel entre deux valeurs (nombres avant strings)
+static int compareValues(EvalValue a, EvalValue b) {
+    SortItem x = { a.is_string ? 0 : a.num, a.is_string ? a.str : NULL, a.is_string ? rstr_len(a.str) : 0, 0 };
+    SortItem y = { b.is_string ? 0 : b.num, b.is_string ? b.str : NULL, b.is_string ? rstr_len(b.str) : 0, 0 };
+    sort_direction = 1;
+    sort_tiebreak = false;
+    return sortCompareMixed(&x, &y);
+}
+
+// Recherche dichotomique dans une liste triée : index ou -1
+static long binarySearch(List* list, EvalValue needle) {
+    long lo = 0, hi = list->count - 1;
+    while (lo <= hi) {
+        long mid = lo + (hi - lo) / 2;
+        int c = compareValues(list->items[mid], needle);
+        if (c == 0) return mid;
+        if (c < 0) lo = mid + 1;
+        else hi = mid - 1;
     }
-        case NODE_SYS_EXIT: {
-            int code = 0;
-            if (node->left) code = (int)evalFloat(node->left);
-            exit(code);
-            break;
+    return -1;
+}
+
+// Éléments distincts dans l'ordre de première apparition (map comme ensemble)
+static List* uniqueList(List* list) {
+    List* result = newList(list->count);
+    gcPushRoot(&result->gc);
+    Map* seen = newMap();
+    gcPushRoot(&seen->gc);
+    for (int i = 0; i < list->count; i++) {
+        EvalValue v = list->items[i];
+        if (mapFind(seen, v)) continue;
+        EvalValue present = { false, true, NULL, 1 };
+        mapSet(seen, copyValue(v), present);
+        listPush(result, copyValue(v));
+    }
+    gcPopRoots(2);
+    return result;
+}
+
+// key(élément) -> liste des éléments ayant cette clé, groupes dans l'ordre
+// de première apparition
+static Map* groupBy(ASTNode* node, List* list, Function* key) {
+    Map* groups = newMap();
+    gcPushRoot(&groups->gc);
+    int count = list->count;
+    for (int i = 0; i < count && i < list->count; i++) {
+        EvalValue k = callKey(key, list->items[i]);
+        MapEntry* e = mapFind(groups, k);
+        List* group;
+        if (e) {
+            group = listFromId(e->value.str);
+            rstr_release(k.str);
+        } else {
+            group = newList(4);
+            mapSet(groups, k, listValue(group));
         }
-        case NODE_TIME_SLEEP:
-        std_time_sleep(evalFloat(node->left));
-        break;
-        case NODE_SYS_EXEC: {
-             // Si utilisé comme instruction simple sans récupération de variable
-             char* cmd = evalString(node->left);
-             system(cmd);
-             if (cmd) free(cmd);
-             break;
+        listPush(group, copyValue(list->items[i]));
+    }
+    if (list->count != count) runtime_error(node, "List modified by the key function during group_by");
+    gcPopRoots(1);
+    return groups;
+}
+
+// Les k plus grands éléments (ou plus petits avec {smallest: true}), du
+// premier au dernier dans l'ordre demandé : tas de taille k, O(n log k).
+static List* topK(ASTNode* node, List* list, long k, ASTNode* opts) {
+    int count = list->count;
+    if (k > count) k = count;
+    if (k < 0) k = 0;
+    Function* key = sortKeyOption(opts);
+    bool smallest = sortFlagOption(opts, "smallest", false);
+    
+    SortItem* items = malloc((count ? count : 1) * sizeof(SortItem));
+    EvalValue* keys = malloc((count ? count : 1) * sizeof(EvalValue));
+    if (!items || !keys) { fprintf(stderr, "%s[FATAL]%s Out of memory (top_k)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    SortCompare cmp = buildSortItems(node, list, key, items, keys);
+    
+    // Ordre inversé pour 'smallest' ; à clé égale, le premier élément gagne
+    sort_direction = smallest ? 1 : -1;
+    sort_tiebreak = true;
+    
+    // Tas max sur l'ordre demandé : la racine est le pire des k retenus
+    int size = 0;
+    for (int i = 0; i < count && k > 0; i++) {
+        if (size < k) {
+            items[size++] = items[i];
+            if (size == k) {
+                for (int r = size / 2 - 1; r >= 0; r--) sortSiftDown(items, r, size, cmp);
+            }
+        } else if (cmp(&items[i], &items[0]) < 0) {
+            items[0] = items[i];
+            sortSiftDown(items, 0, size, cmp);
         }
-        case NODE_EXPORT: {
-        
-    if (node->data.export.symbol) {
-        char* symbol = node->data.export.symbol;
-        char* alias = node->data.export.alias ? node->data.export.alias : symbol;
-                
-        registerExport(symbol, alias);
     }
-    break;
+    sortItems(items, size, cmp);
+    
+    List* result = newList(size);
+    for (int i = 0; i < size; i++) listPush(result, copyValue(list->items[items[i].index]));
+    free(items);
+    releaseKeys(keys, count);
+    return result;
 }
-        // net pour le command void
-        case NODE_NET_CONNECT: {
-            int fd = (int)evalFloat(node->left);      // Évaluation variable sock
-            char* ip = evalString(node->right);       // Évaluation string ip
-            int port = (int)evalFloat(node->third);   // Évaluation int/var port
-            
-            net_connect_to(fd, ip, port);
-            
-            if (ip) free(ip);
+
+// sort(opts), sorted(opts), binary_search(x), unique(), group_by(f), top_k(k, opts)
+static bool callListAlgorithm(ASTNode* node, List* list, EvalValue* result) {
+    const char* name = node->data.name;
+    ASTNode* args = node->right;
+    
+    if (strcmp(name, "sort") == 0) {
+        sortList(node, list, args);
+        result->num = list->count;
+    } else if (strcmp(name, "sorted") == 0) {
+        List* copy = listSlice(list, 0, list->count);
+        gcPushRoot(&copy->gc);
+        sortList(node, copy, args);
+        gcPopRoots(1);
+        *result = listValue(copy);
+    } else if (strcmp(name, "binary_search") == 0) {
+        if (!args) runtime_error(node, "binary_search(x) expects one argument");
+        EvalValue needle = evalValue(args);
+        result->num = binarySearch(list, needle);
+        rstr_release(needle.str);
+    } else if (strcmp(name, "unique") == 0) {
+        *result = listValue(uniqueList(list));
+    } else if (strcmp(name, "group_by") == 0) {
+        if (!args) runtime_error(node, "group_by(f) expects a key function");
+        Map* groups = groupBy(node, list, resolveCallable(args));
+        result->is_string = true;
+        result->str = heapIdStr(&groups->gc);
+    } else if (strcmp(name, "top_k") == 0) {
+        if (!args) runtime_error(node, "top_k(k) expects a count");
+        long k = (long)evalFloat(args);
+        *result = listValue(topK(node, list, k, args->next));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Chaîne partagée (rstr) : à libérer avec rstr_release
+static char* evalStr(ASTNode* node) {
+    if (!node) return rstr_new("", 0);
+    
+    switch (node->type) {
+        case NODE_STRING:
+            return rstr_from(node->data.str_val);
+        case NODE_THIS:
+            if (current_this) return rstr_retain(current_this);
             break;
+        case NODE_INT:
+            return numberToRstr((double)node->data.int_val);
+        case NODE_FLOAT:
+            return numberToRstr(node->data.float_val);
+        case NODE_IDENT:
+        case NODE_MEMBER_ACCESS: {
+            Variable* var = lookupVar(node);
+            if (!var || !var->is_initialized) break;
+            if (var->is_string) {
+                if (var->value.str_val) return rstr_retain(var->value.str_val);
+                break;
+            }
+            if (var->is_float) return numberToRstr(var->value.float_val);
+            return numberToRstr((double)var->value.int_val);
         }
-        case NODE_NET_SEND: {
-            int fd = (int)evalFloat(node->left);
-            char* data = evalString(node->right);
-            
-            net_send_data(fd, data);
-            
-            if (data) free(data);
+        case NODE_BINARY:
+            if (isConcat(node)) return evalConcat(node, NULL);
+            if (isDynamicPlus(node)) {
+                EvalValue v = evalDynamicPlus(node);
+                return v.is_string ? v.str : numberToRstr(v.num);
+            }
             break;
-        }
-        case NODE_NET_CLOSE: {
-            int fd = (int)evalFloat(node->left);
-            net_close_socket(fd);
+        case NODE_LIST:
+            return evalListLiteral(node);
+        case NODE_MAP:
+            return evalMapLiteral(node);
+        case NODE_MATH_FUNC:
+            if (isVectorOp(node->op_type)) return evalVectorOp(node);
             break;
+        case NODE_STD_SPLIT:
+            return evalSplit(node);
+        case NODE_SYS_SPAWN:
+            return evalSysSpawn(node);
+        case NODE_SYS_RUN_ALL:
+            return evalSysRunAll(node);
+        case NODE_ARRAY_ACCESS: {
+            EvalValue v = evalIndex(node);
+            return v.is_string ? v.str : numberToRstr(v.num);
         }
+        case NODE_METHOD_CALL:
+        case NODE_FUNC_CALL: {
+            // Le résultat est partagé avec la fonction, sans copie
+            Function* func = callFunction(node);
+            if (!func) return rstr_new("", 0);
+            if (func->return_string) return rstr_retain(func->return_string);
+            return numberToRstr(func->return_value);
+        }
+        default:
+            break;
+    }
+    return rstr_adopt(evalString(node));
+}
 
-
-        
-        case NODE_VAR_DECL:
-        case NODE_NET_DECL:
-        case NODE_CLOG_DECL:
-        case NODE_DOS_DECL:
-        case NODE_SEL_DECL:
-        case NODE_CONST_DECL: {
-            // 1. DÉTERMINER LE TYPE
-            TokenKind var_type = TK_VAR;
-            if (node->type == NODE_NET_DECL) var_type = TK_NET;
-            else if (node->type == NODE_CLOG_DECL) var_type = TK_CLOG;
-            else if (node->type == NODE_DOS_DECL) var_type = TK_DOS;
-            else if (node->type == NODE_SEL_DECL) var_type = TK_SEL;
-            else if (node->type == NODE_CONST_DECL) var_type = TK_CONST;
-            
-            // 2. CALCULER LA VALEUR D'ABORD (IMPORTANT : AVANT d'allouer la variable)
-            // Cela empêche les fonctions appelées d'écraser la mémoire de cette variable
-            bool has_init = false;
-            bool val_is_str = false;
-            bool val_is_float = false;
-            char* temp_str = NULL;
-            double temp_float = 0.0;
-            int64_t temp_int = 0;
-            
-            if (node->left) {
-                has_init = true;
-                if (node->left->type == NODE_STRING) {
-                    val_is_str = true;
-                    temp_str = str_copy(node->left->data.str_val);
-                } 
-                else if (node->left->type == NODE_FLOAT) {
-                    val_is_float = true;
-                    temp_float = node->left->data.float_val;
-                }
-                else if (node->left->type == NODE_BOOL) {
-                    temp_int = node->left->data.bool_val ? 1 : 0;
-                }
-                else {
-                    // Pour les appels de fonction ou expressions
-                    // On exécute l'expression MAINTENANT
-                    temp_float = evalFloat(node->left);
-                    
-                    // Si c'était un appel de fonction qui a renvoyé une string
-                    if (node->left->type == NODE_FUNC_CALL) {
-                        Function* f = findFunction(node->left->data.name);
-                        if (f && f->return_string) {
-                            val_is_str = true;
-                            temp_str = str_copy(f->return_string);
-                        } else {
-                            val_is_float = true; // On assume float par défaut pour les retours
-                        }
-                    } else {
-                        // Expression mathématique standard
-                        val_is_float = true; 
-                    }
-                }
+// s += x, s -= x, ... : '+=' sur une chaîne ajoute en place
+static void executeCompoundAssign(Variable* var, ASTNode* node) {
+    TokenKind op = node->op_type;
+    
+    if (op == TK_CONCAT_ASSIGN ||
+        (op == TK_PLUS_ASSIGN && (var->is_string || isStringExpr(node->right)))) {
+        char* piece = evalStr(node->right);
+        char* base;
+        if (var->is_string && var->value.str_val) {
+            base = var->value.str_val;
+            var->value.str_val = NULL;
+        } else {
+            base = numberToRstr(varNumber(var)); // nombre -> texte
+        }
+        base = rstr_append(base, piece, rstr_len(piece));
+        rstr_release(piece);
+        setVarString(var, base);
+        return;
+    }
+    
+    double current = varNumber(var);
+    double operand = evalFloat(node->right);
+    double result = current;
+    switch (op) {
+        case TK_PLUS_ASSIGN: result = current + operand; break;
+        case TK_MINUS_ASSIGN: result = current - operand; break;
+        case TK_MULT_ASSIGN: result = current * operand; break;
+        case TK_DIV_ASSIGN:
+            if (operand == 0.0) {
+                printf("%s[EXEC WARNING]%s Division by zero\n", COLOR_YELLOW, COLOR_RESET);
+                result = INFINITY;
+            } else {
+                result = current / operand;
             }
-            
-            // 3. MAINTENANT ON ALLOUE LA VARIABLE (Une fois que l'exécution est finie)
-            if (var_count < 1000) {
-                Variable* var = &vars[var_count]; // On prend le slot
-                
-                strncpy(var->name, node->data.name, 99);
-                var->name[99] = '\0';
-                var->type = var_type;
-                var->size_bytes = calculateVariableSize(var_type);
-                var->scope_level = scope_level;
-                var->is_constant = (var_type == TK_CONST);
-                var->module = NULL;
-                var->is_exported = false;
-                
-                if (has_init) {
-                    var->is_initialized = true;
-                    if (val_is_str) {
-                        var->is_string = true;
-                        var->is_float = false;
-                        var->value.str_val = temp_str;
-                    } else if (val_is_float) {
-                        var->is_float = true;
-                        var->is_string = false;
-                        var->value.float_val = temp_float;
-                    } else {
-                        var->is_float = false;
-                        var->is_string = false;
-                        var->value.int_val = (int64_t)(val_is_float ? temp_float : temp_int);
-                    }
-                } else {
-                    var->is_initialized = false;
-                    var->is_float = false;
-                    var->is_string = false;
-                    var->value.int_val = 0;
-                }
-                
-                var_count++; // On incrémente le compteur SEULEMENT à la fin
+            break;
+        case TK_MOD_ASSIGN:
+            if (operand == 0.0) {
+                printf("%s[EXEC WARNING]%s Modulo by zero\n", COLOR_YELLOW, COLOR_RESET);
+                result = 0.0;
+            } else {
+                result = fmod(current, operand);
             }
             break;
-        }
-        
+        case TK_POW_ASSIGN: result = pow(current, operand); break;
+        default: break;
+    }
+    setVarNumber(var, result);
+}
 
-case NODE_FILE_OPEN:
-    io_open(node);
-    break;
-    
-case NODE_FILE_CLOSE:
-    io_close(node);
-    break;
-    
+// ======================================================
+// [SECTION] SUPERINSTRUCTIONS
+// ======================================================
+// Nœuds fusionnés par l'optimiseur pour les motifs des boucles : x = x + k
+// et x += k (NODE_INC_LOCAL), comparaison de deux variables ou d'une
+// variable et d'un littéral (NODE_CMP_LOCALS), x + k dans une expression
+// (NODE_ADD_LOCAL_CONST). Le nœud lit les slots directement au lieu de
+// descendre dans l'arbre. Variable absente, chaîne ou constante : la forme
+// générique (fourth) est évaluée, avec ses messages et ses concaténations.
+// Deux entiers (slots int : booléens, 'var x: int') restent en arithmétique
+// int64 tant que le résultat est exact en double ; sinon calcul en double,
+// comme evalFloat.
+#define EXACT_INT_LIMIT 9007199254740992LL // 2^53
 
-case NODE_FILE_WRITE:
-    io_write(node);
-    break;
-    
-case NODE_FILE_SEEK:
-    io_seek(node);
-    break;
-    
-case NODE_FILE_TELL:
-    io_tell(node);
-    break;
-    
-case NODE_PATH_ISFILE:
-    io_isfile(node);
-    break;
-    
-case NODE_PATH_ISDIR:
-    io_isdir(node);
-    break;
-    
-case NODE_DIR_CREATE:
-    io_mkdir(node);
-    break;
-    
-case NODE_DIR_LIST:
-    io_listdir(node);
-    break;    
-        
-        case NODE_ASSIGN: {
-        char* target_name = NULL;
-        bool is_prop = false;
-        
-        // 1. IDENTIFICATION DE LA CIBLE
-        // Cas A : Assignation simple (x = 1)
-        if (node->data.name) {
-            target_name = strdup(node->data.name);
-        }
-        // Cas B : Assignation de propriété (obj.x = 1)
-        else if (node->left && node->left->type == NODE_MEMBER_ACCESS) {
-            is_prop = true;
-            // On évalue la partie gauche (ex: "zarch" ou "inst_1")
-            char* obj = evalString(node->left->left);
-            // On prend le nom de la propriété à droite
-            char* prop = node->left->right->data.name;
-            
-            if (obj && prop) {
-                target_name = malloc(strlen(obj) + strlen(prop) + 2);
-                snprintf(target_name, 256, "%s_%s", obj, prop);
-            }
-            if (obj) free(obj);
+static Variable* localSlot(ASTNode* node) {
+    int idx = findVarSym(nodeSym(node));
+    return idx >= 0 ? &vars[idx] : NULL;
+}
+
+static bool isIntSlot(Variable* var) {
+    return !var->is_float && !var->is_string;
+}
+
+static double literalNumber(ASTNode* node) {
+    return node->type == NODE_INT ? (double)node->data.int_val : node->data.float_val;
+}
+
+static bool compareNumbers(TokenKind op, double a, double b) {
+    switch (op) {
+        case TK_LT: return a < b;
+        case TK_LTE: return a <= b;
+        case TK_GT: return a > b;
+        case TK_GTE: return a >= b;
+        case TK_EQ: return a == b;
+        default: return a != b;
+    }
+}
+
+static bool compareInts(TokenKind op, int64_t a, int64_t b) {
+    switch (op) {
+        case TK_LT: return a < b;
+        case TK_LTE: return a <= b;
+        case TK_GT: return a > b;
+        case TK_GTE: return a >= b;
+        case TK_EQ: return a == b;
+        default: return a != b;
+    }
+}
+
+static void executeIncLocal(ASTNode* node) {
+    Variable* var = localSlot(node);
+    if (!var || var->is_string || var->is_constant) {
+        execute(node->fourth);
+        return;
+    }
+    ASTNode* k = node->right;
+    if (k->type == NODE_INT && isIntSlot(var) &&
+        k->data.int_val > -EXACT_INT_LIMIT && k->data.int_val < EXACT_INT_LIMIT) {
+        int64_t result = node->op_type == TK_MINUS ? var->value.int_val - k->data.int_val
+                                                   : var->value.int_val + k->data.int_val;
+        if (result > -EXACT_INT_LIMIT && result < EXACT_INT_LIMIT) {
+            var->value.int_val = result;
+            var->is_initialized = true;
+            return;
         }
+    }
+    double current = varNumber(var);
+    double step = literalNumber(k);
+    var->value.float_val = node->op_type == TK_MINUS ? current - step : current + step;
+    var->is_float = true;
+    var->is_initialized = true;
+}
 
-        if (target_name) {
-            // 2. RECHERCHE OU CRÉATION
-            int idx = findVar(target_name);
-            
-            // Si la variable n'existe pas, on la crée (Auto-déclaration)
-            // C'est CRUCIAL pour les propriétés d'objets qui sont créées à la volée
-            if (idx == -1 && var_count < 1000) {
-                idx = var_count++;
-                strncpy(vars[idx].name, target_name, 99);
-                vars[idx].name[99] = '\0';
-                vars[idx].type = TK_VAR; 
-                // Les propriétés sont globales (attachées à l'instance), les vars locales respectent le scope
-                vars[idx].scope_level = (is_prop ? 0 : scope_level); 
-                vars[idx].is_constant = false;
-                vars[idx].is_initialized = false;
-                // printf("%s[EXEC]%s Auto-declared variable/prop '%s'\n", COLOR_CYAN, COLOR_RESET, target_name);
-            }
+// Faux si la forme générique doit être évaluée (variable absente ou chaîne)
+static bool compareLocals(ASTNode* node, bool* result) {
+    Variable* a = localSlot(node->left);
+    if (!a || a->is_string) return false;
+    ASTNode* right = node->right;
+    if (right->type == NODE_IDENT) {
+        Variable* b = localSlot(right);
+        if (!b || b->is_string) return false;
+        *result = isIntSlot(a) && isIntSlot(b)
+            ? compareInts(node->op_type, a->value.int_val, b->value.int_val)
+            : compareNumbers(node->op_type, varNumber(a), varNumber(b));
+        return true;
+    }
+    *result = right->type == NODE_INT && isIntSlot(a)
+        ? compareInts(node->op_type, a->value.int_val, right->data.int_val)
+        : compareNumbers(node->op_type, varNumber(a), literalNumber(right));
+    return true;
+}
 
-            // 3. AFFECTATION DE LA VALEUR
-            if (idx >= 0) {
-                if (vars[idx].is_constant) {
-                      runtime_error(node, "Cannot assign to constant '%s'", target_name);
-                } 
-                else if (node->right) {
-                    vars[idx].is_initialized = true;
-
-                    // Nettoyage de l'ancienne valeur si c'était une chaîne
-                    if (vars[idx].is_string && vars[idx].value.str_val) {
-                        free(vars[idx].value.str_val);
-                        vars[idx].value.str_val = NULL;
-                    }
+static double evalCmpLocals(ASTNode* node) {
+    bool result;
+    if (!compareLocals(node, &result)) return evalFloat(node->fourth);
+    return result ? 1.0 : 0.0;
+}
 
-                    // --- Gestion des Types ---
-                    
-                    // TYPE STRING
-                    if (node->right->type == NODE_STRING) {
-                        vars[idx].is_string = true;
-                        vars[idx].is_float = false;
-                        vars[idx].value.str_val = evalString(node->right);
-                    }
-                    // TYPE NOUVELLE INSTANCE (new Class)
-                    else if (node->right->type == NODE_NEW) {
-                        vars[idx].is_string = true;
-                        vars[idx].is_float = false;
-                        vars[idx].value.str_val = evalString(node->right); // Retourne "inst_X"
-                    }
-                    // TYPES DYNAMIQUES (Appel de fonction, variable, membre)
-                    else if (node->right->type == NODE_FUNC_CALL || 
-                             node->right->type == NODE_IDENT || 
-                             node->right->type == NODE_MEMBER_ACCESS) {
-                        
-                        // On évalue en string pour voir si c'est du texte ou une instance
-                        char* val_str = evalString(node->right);
-                        if (vars[idx].is_locked) {
-                            runtime_error(node, "Cannot assign to constant '%s'", target_name);
-                             return;
-                        }
-                        // Détection simple : Si ça ressemble à une instance "inst_" ou contient des lettres
-                        // qui ne sont pas des notations scientifiques, c'est une string.
-                        bool is_numeric = true;
-                        if (strstr(val_str, "inst_")) is_numeric = false;
-                        else {
-                            char* endptr;
-                            strtod(val_str, &endptr);
-                            if (*endptr != '\0') is_numeric = false;
-                        }
-
-                        if (!is_numeric) {
-                            vars[idx].is_string = true;
-                            vars[idx].is_float = false;
-                            vars[idx].value.str_val = val_str;
-                        } else {
-                            free(val_str);
-                            vars[idx].is_string = false;
-                            vars[idx].is_float = true;
-                            vars[idx].value.float_val = evalFloat(node->right);
-                        }
-                    }
-                    // TYPE NUMERIQUE / BOOL (Par défaut)
-                    else {
-                        vars[idx].is_string = false;
-                        vars[idx].is_float = true;
-                        vars[idx].value.float_val = evalFloat(node->right);
-                    }
-                }
-            }
-            free(target_name);
+static double evalAddLocalConst(ASTNode* node) {
+    Variable* var = localSlot(node->left);
+    if (!var || var->is_string) return evalFloat(node->fourth);
+    double step = literalNumber(node->right);
+    return node->op_type == TK_MINUS ? varNumber(var) - step : varNumber(var) + step;
+}
+
+// ======================================================
+// [SECTION] EXPRESSION EVALUATION
+// ======================================================
+// Nœuds numériques fréquents, traités en ligne par evalFloat()
+#define EVAL_HOT(X) \
+    X(NODE_IDENT, eval_ident) \
+    X(NODE_INT, eval_int) \
+    X(NODE_BINARY, eval_binary) \
+    X(NODE_FUNC_CALL, eval_call) \
+    X(NODE_METHOD_CALL, eval_call) \
+    X(NODE_MEMBER_ACCESS, eval_member) \
+    X(NODE_ARRAY_ACCESS, eval_index) \
+    X(NODE_FLOAT, eval_float) \
+    X(NODE_UNARY, eval_unary) \
+    X(NODE_TERNARY, eval_ternary) \
+    X(NODE_BOOL, eval_bool) \
+    X(NODE_STRING, eval_string) \
+    X(NODE_STD_LEN, eval_len) \
+    X(NODE_MATH_FUNC, eval_math) \
+    X(NODE_CMP_LOCALS, eval_cmp_locals) \
+    X(NODE_ADD_LOCAL_CONST, eval_add_local_const)
+
+// Nœuds rares (IO, temps, réseau, système) : hors du chemin chaud
+COLD static double evalFloatCold(ASTNode* node) {
+    switch (node->type) {
+    case NODE_IO_FUNC: {
+        if (node->op_type == TK_IO_WRITER) {
+            char* path = evalString(node->left);
+            ASTNode* buffer_opt = findOption(node->right, "buffer");
+            ASTNode* append_opt = findOption(node->right, "append");
+            size_t buffer_size = buffer_opt ? (size_t)evalFloat(buffer_opt) : 0;
+            bool append = append_opt ? evalBool(append_opt) : false;
+            int fd = io_writer_open(path, buffer_size, append);
+            free(path);
+            return (double)fd;
         }
-        break;
+        if (node->op_type == TK_IO_READ_ASYNC) {
+            char* path = evalString(node->left);
+            int handle = aio_read_submit(path);
+            free(path);
+            return (double)handle;
+        }
+        if (node->op_type == TK_IO_WRITE_ASYNC) {
+            char* path = evalString(node->left);
+            char* data = evalString(node->right);
+            ASTNode* append_opt = findOption(node->third, "append");
+            int handle = aio_write_submit(path, data, strlen(data), append_opt ? evalBool(append_opt) : false);
+            free(path);
+            free(data);
+            return (double)handle;
+        }
+        return 0.0;
     }
-        case NODE_PRINT: {
-            if (node->left) {
-                ASTNode* current_arg = node->left;
-                while (current_arg) {
-                    char* str = evalString(current_arg);
-                    printf("%s", str);
-                    free(str);
-                    current_arg = current_arg->right;
-                    if (current_arg) printf(" ");
-                }
-            }
-            printf("\n");
-            break;
+    case NODE_FILE_WRITE: {
+        int fd = (int)evalFloat(node->left);
+        char* data = evalString(node->right);
+        long written = io_write_fd(fd, data, strlen(data));
+        free(data);
+        return (double)written;
+    }
+    case NODE_FILE_FLUSH:
+        return (double)io_flush_fd((int)evalFloat(node->left));
+    case NODE_FILE_COPY: {
+        char* src = evalString(node->left);
+        char* dst = evalString(node->right);
+        ASTNode* preserve_opt = findOption(node->third, "preserve");
+        long long copied = io_copy_file(src, dst, preserve_opt ? evalBool(preserve_opt) : false);
+        free(src);
+        free(dst);
+        return (double)copied;
+    }
+    case NODE_FILE_CLOSE:
+        return (double)io_close_fd((int)evalFloat(node->left));
+    case NODE_TIME_NOW:
+        return std_time_now();
+    case NODE_TIME_FUNC:
+        return evalTimeFunc(node);
+    case NODE_GC_FUNC: {
+        if (node->op_type == TK_GC_COLLECT) return (double)gcCollect();
+        char* name = evalStr(node->left);
+        double value = gcStat(name);
+        rstr_release(name);
+        return value;
+    }
+    case NODE_TIME_SLEEP:
+        sched_sleep(evalFloat(node->left)); // les tâches async continuent
+        return 0.0;
+        
+    case NODE_PATH_EXISTS: {
+        char* path = evalString(node->left);
+        // Utilise la fonction booléenne de io.c
+        bool res = (access(path, F_OK) == 0); 
+        if (path) free(path);
+        return res ? 1.0 : 0.0;
+    }   
+    case NODE_AWAIT: {
+        double num;
+        char* content = evalAwait(node, &num);
+        if (content) {
+            num = strtod(content, NULL);
+            free(content);
         }
-            
-        case NODE_READ:
-            executeRead(node);
-            break;
-            
-        case NODE_WRITE:
-            executeWrite(node);
-            break;
-            
-        case NODE_APPEND:
-            executeAppend(node);
-            break;
-            
-        case NODE_PASS:
-            break;
-            
-        case NODE_RETURN: {
-    if (current_function) {
-        current_function->has_returned = true;
-        if (node->left) {
-            current_function->return_value = evalFloat(node->left);
-            char* str_val = evalString(node->left);
-            if (current_function->return_string) {
-                free(current_function->return_string);
+        return num;
+    }
+    case NODE_STD_TO_INT: {
+        char* val = evalStr(node->left);
+        double res = atof(val);
+        rstr_release(val);
+        return res;
+    }
+    case NODE_SYS_EXEC: {
+        char* cmd = evalString(node->left);
+        // sys_exec_int est une nouvelle fonction dans sys.c qui retourne le int
+        // ou on adapte sys_exec pour retourner int
+        int res = system(cmd); 
+        if (cmd) free(cmd);
+        return (double)res;
+    }
+    case NODE_NET_SOCKET:
+        return (double)net_socket_create();
+        
+    case NODE_NET_LISTEN: {
+        int port = (int)evalFloat(node->left); // Évaluation de la variable port
+        return (double)net_start_listen(port);
+    }
+        
+    case NODE_NET_ACCEPT: {
+        int server_fd = (int)evalFloat(node->left); // Évaluation de la variable server
+        return (double)net_accept_client(server_fd);
+    }
+    case NODE_NULL:
+    case NODE_UNDEFINED:
+    case NODE_NAN:
+        return NAN;
+    case NODE_INF:
+        return INFINITY;
+    case NODE_STR_FUNC: {
+        if (node->op_type == TK_STR_CONTAINS) {
+            char* h = evalStr(node->left);
+            char* n = evalStr(node->right);
+            int res = std_str_contains(h, n);
+            rstr_release(h); rstr_release(n);
+            return (double)res;
+        }
+        return 0.0;
+    }
+    default:
+        return 0.0;
+    }
+}
+
+static double evalFloat(ASTNode* node) {
+    if (!node) return 0.0;
+    DISPATCH(EVAL_HOT, node, eval_cold);
+
+eval_ident: {
+    int idx = findVarSym(nodeSym(node));
+    if (idx >= 0) {
+        if (vars[idx].is_float) {
+            return vars[idx].value.float_val;
+        } else if (vars[idx].is_string) {
+            char* endptr;
+            double val = strtod(vars[idx].value.str_val, &endptr);
+            if (endptr != vars[idx].value.str_val) {
+                return val;
             }
-            current_function->return_string = str_copy(str_val);
-            free(str_val);
+            return 0.0;
         } else {
-            current_function->return_value = 0;
-            if (current_function->return_string) {
-                free(current_function->return_string);
-                current_function->return_string = NULL;
-            }
+            return (double)vars[idx].value.int_val;
         }
     }
-    break;
-   }
-            
-        case NODE_BLOCK: {
-            int old_scope = scope_level;
-            scope_level++;
-            
-            ASTNode* current = node->left;
-            while (current && !(current_function && current_function->has_returned)) {
-                execute(current);
-                current = current->right;
+    printf("%s[EXEC ERROR]%s Undefined variable: %s\n", COLOR_RED, COLOR_RESET, node->data.name);
+    return 0.0;
+}
+eval_int:
+    return (double)node->data.int_val;
+
+eval_binary: {
+    if (node->op_type == TK_IN) return evalMembership(node) ? 1.0 : 0.0;
+    if ((node->op_type == TK_EQ || node->op_type == TK_NEQ) &&
+        (isStringExpr(node->left) || isStringExpr(node->right))) {
+        char* ls = evalStr(node->left);
+        char* rs = evalStr(node->right);
+        bool equal = rstr_equal(ls, rs);
+        rstr_release(ls);
+        rstr_release(rs);
+        return (node->op_type == TK_EQ) == equal ? 1.0 : 0.0;
+    }
+    
+    // "12" + 3 en contexte numérique : concaténation puis conversion
+    if (isConcat(node)) {
+        char* joined = evalConcat(node, NULL);
+        double val = strtod(joined, NULL);
+        rstr_release(joined);
+        return val;
+    }
+    if (node->op_type == TK_PLUS && hasCallOperand(node)) {
+        EvalValue v = evalDynamicPlus(node);
+        if (!v.is_string) return v.num;
+        double val = strtod(v.str, NULL);
+        rstr_release(v.str);
+        return val;
+    }
+
+    double left = evalFloat(node->left);
+    double right = evalFloat(node->right);
+    
+    switch (node->op_type) {
+        case TK_PLUS: return left + right;
+        case TK_MINUS: return left - right;
+        case TK_MULT: return left * right;
+        case TK_DIV: 
+            if (right == 0.0) {
+                printf("%s[EXEC WARNING]%s Division by zero\n", COLOR_YELLOW, COLOR_RESET);
+                return INFINITY;
             }
-            
-            scope_level = old_scope;
-            break;
-        }
-            
-        case NODE_MAIN: {
-            if (node->left) execute(node->left);
-            break;
-        }
-            
-        case NODE_DBVAR: {
-            printf("\n%s╔═════════════════════════════════════════════════╗%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-             printf("%s║                   VARIABLE TABLE (dbvar)          ║%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-            printf("%s╠═══════════════════════════════════════════════════╣%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-            printf("%s║  Type    │ Name     │ Size │ Value  │ Initialized ║%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-            printf("%s╠═══════════════════════════════════════════════════╣%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-            
-            for (int i = 0; i < var_count; i++) {
-                Variable* var = &vars[i];
-                char value_str[50];
-                
-                if (var->is_string && var->value.str_val) {
-                    snprintf(value_str, sizeof(value_str), "\"%s\"", var->value.str_val);
-                } else if (var->is_float) {
-                    snprintf(value_str, sizeof(value_str), "%g", var->value.float_val);
-                } else {
-                    snprintf(value_str, sizeof(value_str), "%lld", var->value.int_val);
-                }
-                
-                printf("%s║ %-8s │ %-11s │ %-8d │ %-11s │ %-11s ║%s\n",
-                       COLOR_CYAN,
-                       getTypeName(var->type),
-                       var->name,
-                       var->size_bytes,
-                       value_str,
-                       var->is_initialized ? "✓" : "✗",
-                       COLOR_RESET);
+            return left / right;
+        case TK_MOD: 
+            if (right == 0.0) {
+                printf("%s[EXEC WARNING]%s Modulo by zero\n", COLOR_YELLOW, COLOR_RESET);
+                return 0.0;
             }
+            return fmod(left, right);
+        case TK_POW: return pow(left, right);
+        case TK_SHL: return (double)((int64_t)left << (int64_t)right);
+        case TK_SHR: return (double)((int64_t)left >> (int64_t)right);
+        case TK_BIT_AND: return (double)((int64_t)left & (int64_t)right);
+        case TK_BIT_OR: return (double)((int64_t)left | (int64_t)right);
+        case TK_BIT_XOR: return (double)((int64_t)left ^ (int64_t)right);
+        case TK_CONCAT: {
+            char* left_str = evalString(node->left);
+            char* right_str = evalString(node->right);
+            char* combined = malloc(strlen(left_str) + strlen(right_str) + 1);
+            strcpy(combined, left_str);
+            strcat(combined, right_str);
             
-            if (var_count == 0) {
-                printf("%s║                   No variables declared                       ║%s\n", 
-                       COLOR_CYAN, COLOR_RESET);
-            }
+            char* endptr;
+            double val = strtod(combined, &endptr);
             
-            printf("   %s╚════════════════════════════════════════════════════════════════╝%s\n", 
-                   COLOR_CYAN, COLOR_RESET);
-            break;
-        }
+            free(left_str);
+            free(right_str);
+            free(combined);
             
-        case NODE_IMPORT: {
-    if (node->data.imports.module_count > 0) {
-        for (int i = 0; i < node->data.imports.module_count; i++) {
-            char* module_name = node->data.imports.modules[i];
-            char* from_module = node->data.imports.from_module;
+            if (endptr != combined) return val;
+            return 0.0;
+        }
+        case TK_EQ: return left == right ? 1.0 : 0.0;
+        case TK_NEQ: return left != right ? 1.0 : 0.0;
+        case TK_GT: return left > right ? 1.0 : 0.0;
+        case TK_LT: return left < right ? 1.0 : 0.0;
+        case TK_GTE: return left >= right ? 1.0 : 0.0;
+        case TK_LTE: return left <= right ? 1.0 : 0.0;
+        case TK_AND: return (left != 0.0 && right != 0.0) ? 1.0 : 0.0;
+        case TK_OR: return (left != 0.0 || right != 0.0) ? 1.0 : 0.0;
+        default: return 0.0;
+    }
+}
+eval_call: {
+    Function* func = callFunction(node);
+    if (func) {
+        if (func->return_string) {
+            char* endptr;
+            double val = strtod(func->return_string, &endptr);
+            if (endptr != func->return_string) {
+                return val;
+            }
+        }
+        return func->return_value;
+    }
+    
+    printf("%s[EXEC ERROR]%s Function not found: %s\n", COLOR_RED, COLOR_RESET, node->data.name);
+    return 0.0;
+}
+eval_member: {
+    // Forme connue du cache : une comparaison puis une lecture de slot
+    Variable* var = resolveMember(node, false, NULL);
+    return var ? varNumber(var) : 0.0;
+}
+eval_index: {
+    EvalValue v = evalIndex(node);
+    double num = v.is_string ? strtod(v.str, NULL) : v.num;
+    rstr_release(v.str);
+    return num;
+}
+eval_float:
+    return node->data.float_val;
+
+eval_unary: {
+    double operand = evalFloat(node->left);
+    switch (node->op_type) {
+        case TK_MINUS: return -operand;
+        case TK_NOT: return operand == 0.0 ? 1.0 : 0.0;
+        default: return operand;
+    }
+}
+eval_ternary:
+    return evalFloat(node->left) != 0.0 ? evalFloat(node->right) : evalFloat(node->third);
+
+eval_bool:
+    return node->data.bool_val ? 1.0 : 0.0;
+
+eval_string: {
+    char* endptr;
+    double val = strtod(node->data.str_val, &endptr);
+    if (endptr != node->data.str_val) {
+        return val;
+    }
+    return 0.0;
+}
+eval_len: {
+    // Longueur d'une string, nombre d'éléments d'une liste, d'une map ou d'un tableau
+    char* val = evalStr(node->left);
+    List* list = listFromId(val);
+    Map* map = list ? NULL : mapFromId(val);
+    TypedArray* arr = list || map ? NULL : arrayFromId(val);
+    size_t len = list ? (size_t)list->count : map ? (size_t)map->count :
+                 arr ? (size_t)arr->count : rstr_len(val);
+    rstr_release(val);
+    return (double)len;
+}
+eval_math: {
+    if (node->op_type == TK_MATH_PI || node->op_type == TK_MATH_E) {
+        return std_math_const(node->op_type);
+    }
+    if (isVectorReduce(node->op_type)) return evalVectorReduce(node);
+    if (isVectorOp(node->op_type)) return 0.0;
+    double v1 = node->left ? evalFloat(node->left) : 0;
+    double v2 = node->right ? evalFloat(node->right) : 0;
+    return std_math_calc(node->op_type, v1, v2);
+}
+eval_cmp_locals:
+    return evalCmpLocals(node);
+
+eval_add_local_const:
+    return evalAddLocalConst(node);
+
+eval_cold:
+    return evalFloatCold(node);
+}
+
+static char* evalString(ASTNode* node) {
+    if (!node) return str_copy("");
+    
+    switch (node->type) {
+    
+    // --- MODULE CRYPTO (Le correctif est ici) ---
+    case NODE_CRYPTO_FUNC: {
+        char* data = evalString(node->left);
+        char* res = NULL;
+        
+        if (node->op_type == TK_CRYPTO_SHA256) res = std_crypto_sha256(data);
+        else if (node->op_type == TK_CRYPTO_MD5) res = std_crypto_md5(data);
+        else if (node->op_type == TK_CRYPTO_B64ENC) res = std_crypto_b64enc(data);
+        else if (node->op_type == TK_CRYPTO_B64DEC) res = std_crypto_b64dec(data);
+        
+        if (data) free(data);
+        return res ? res : str_copy("");
+    }
+
+    // --- MODULE PATH (Le correctif est ici) ---
+    case NODE_PATH_FUNC: {
+        char* p1 = evalString(node->left);
+        char* res = NULL;
+        
+        if (node->op_type == TK_PATH_BASENAME) res = std_path_basename(p1);
+        else if (node->op_type == TK_PATH_DIRNAME) res = std_path_dirname(p1);
+        else if (node->op_type == TK_PATH_ABS) res = std_path_abs(p1);
+        else if (node->op_type == TK_PATH_JOIN) {
+            char* p2 = evalString(node->right);
+            res = std_path_join(p1, p2);
+            free(p2);
+        }
+        
+        free(p1);
+        return res ? res : str_copy("");
+    }
+
+    // --- MODULE ENV ---
+    case NODE_ENV_FUNC: {
+        if (node->op_type == TK_ENV_GET) {
+            char* key = evalString(node->left);
+            char* val = std_env_get(key);
+            free(key);
+            return val ? val : str_copy("");
+        }
+        if (node->op_type == TK_ENV_OS) {
+            return std_env_os();
+        }
+        return str_copy("");
+    }
+
+    // --- MODULE STR ---
+    case NODE_STR_FUNC: {
+        char* s = evalStr(node->left);
+        char* res = NULL;
+        
+        if (node->op_type == TK_STR_UPPER) res = std_str_upper(s);
+        else if (node->op_type == TK_STR_LOWER) res = std_str_lower(s);
+        else if (node->op_type == TK_STR_TRIM) res = std_str_trim(s);
+        else if (node->op_type == TK_STR_SUB) {
+            int start = (int)evalFloat(node->right);
+            int len = (int)evalFloat(node->third);
+            res = std_str_sub(s, start, len);
+        }
+        else if (node->op_type == TK_STR_REPLACE) {
+            char* search = evalString(node->right);
+            char* replace = evalString(node->third);
+            res = std_str_replace(s, search, replace);
+            free(search); free(replace);
+        }
+        
+        rstr_release(s);
+        return res ? res : str_copy("");
+    }
+
+    // --- MODULE MATH (Conversion en string pour affichage) ---
+    case NODE_MATH_FUNC: {
+        if (isVectorOp(node->op_type)) {
+            char* str = evalStr(node);
+            char* res = str_copy(str);
+            rstr_release(str);
+            return res;
+        }
+        if (isVectorReduce(node->op_type)) return numberToString(evalFloat(node));
+        double val = evalFloat(node);
+        char buf[64];
+        sprintf(buf, "%g", val);
+        return str_copy(buf);
+    }
+
+    // --- INSTANCIATION ---
+    case NODE_NEW: {
+        char instance_name[64];
+        newObject(node->data.name, instance_name, sizeof(instance_name));
+        return str_copy(instance_name);
+    }
+
+    case NODE_THIS:
+        return str_copy(current_this ? current_this : "null");
+
+    // --- ACCÈS MEMBRE ---
+    case NODE_MEMBER_ACCESS: {
+        Variable* var = resolveMember(node, false, NULL);
+        if (var && var->is_string) {
+            return str_copy(var->value.str_val ? var->value.str_val : "");
+        }
+        // Fallback: si c'est un nombre, le convertir en string
+        if (var && var->is_initialized) {
+            return numberToString(varNumber(var));
+        }
+        return str_copy("");
+    }
+
+    // --- IO ---
+    case NODE_FILE_READ: {
+        char* path = evalString(node->left);
+        char* content = io_read_string(path); 
+        if (path) free(path);
+        return content ? content : str_copy("");
+    }
+    case NODE_WELD: {
+        char* prompt = NULL;
+        if (node->left) prompt = evalString(node->left);
+        char* input = weldInput(prompt);
+        if (prompt) free(prompt);
+        return input ? input : str_copy("");
+    }
+
+    // --- HTTP / SYS / JSON / NET / STD ---
+    case NODE_HTTP_GET: {
+        char* url = evalString(node->left);
+        char* res = http_get(url);
+        free(url); return res ? res : str_copy("");
+    }
+    case NODE_HTTP_POST: {
+        char* url = evalString(node->left);
+        char* data = evalString(node->right);
+        char* res = http_post(url, data);
+        free(url); free(data); return res ? res : str_copy("");
+    }
+    case NODE_HTTP_DOWNLOAD: {
+        char* url = evalString(node->left);
+        char* out = evalString(node->right);
+        char* res = http_download(url, out);
+        free(url); free(out); return res ? res : str_copy("failed");
+    }
+    case NODE_SYS_ARGV: {
+        int idx = (int)evalFloat(node->left);
+        char* arg = sys_get_argv(idx); 
+        return arg ? str_copy(arg) : NULL;
+    }
+    case NODE_JSON_GET: {
+        char* json = evalString(node->left);
+        char* key = evalString(node->right);
+        char* res = json_extract(json, key);
+        free(json); free(key); return res ? res : NULL;
+    }
+    case NODE_NET_RECV: {
+        int fd = (int)evalFloat(node->left);
+        int size = 1024;
+        if (node->right) size = (int)evalFloat(node->right);
+        char* res = net_recv_data(fd, size);
+        return res ? res : str_copy("");
+    }
+    case NODE_STD_TO_STR: {
+        double val = evalFloat(node->left);
+        char* buf = malloc(64);
+        if (val == (int64_t)val) sprintf(buf, "%lld", (int64_t)val);
+        else sprintf(buf, "%g", val);
+        return buf;
+    }
+    case NODE_STD_SPLIT:
+    case NODE_SYS_SPAWN:
+    case NODE_SYS_RUN_ALL:
+    case NODE_LIST:
+    case NODE_MAP:
+    case NODE_ARRAY_ACCESS: {
+        char* str = evalStr(node);
+        char* res = str_copy(str);
+        rstr_release(str);
+        return res;
+    }
+
+    // --- TYPES DE BASE ---
+    case NODE_STRING: return str_copy(node->data.str_val);
+    case NODE_BOOL: return str_copy(node->data.bool_val ? "true" : "false");
+    case NODE_NULL: return str_copy("null");
+    case NODE_UNDEFINED: return str_copy("undefined");
+    case NODE_INT: {
+        char* r = malloc(32); sprintf(r, "%lld", node->data.int_val); return r;
+    }
+    case NODE_FLOAT: {
+        double val = node->data.float_val;
+        if (isnan(val)) return str_copy("nan");
+        if (isinf(val)) return str_copy(val > 0 ? "inf" : "-inf");
+        return numberToString(val); // même format qu'evalStr
+    }
+    case NODE_IDENT: {
+        int idx = findVarSym(nodeSym(node));
+        if (idx >= 0) {
+            if (vars[idx].is_string && vars[idx].value.str_val) return str_copy(vars[idx].value.str_val);
+            if (vars[idx].is_float) return numberToString(vars[idx].value.float_val);
+            char* r = malloc(32); sprintf(r, "%lld", vars[idx].value.int_val); return r;
+        }
+        return str_copy("undefined");
+    }
+    case NODE_BINARY: {
+        if (isConcat(node) || isDynamicPlus(node)) {
+            char* joined = evalStr(node);
+            char* res = str_copy(joined);
+            rstr_release(joined);
+            return res;
+        }
+        // Conversion implicite number -> string
+        return numberToString(evalFloat(node));
+    }
+
+    // --- APPEL DE FONCTION / METHODE ---
+    case NODE_METHOD_CALL:
+    case NODE_FUNC_CALL: {
+        Function* func = callFunction(node);
+        if (!func) return str_copy("");
+        if (func->return_string) return str_copy(func->return_string);
+        return numberToString(func->return_value);
+    }
+
+    // --- PRIMITIVES NUMÉRIQUES (handles, octets, longueurs, temps) ---
+    case NODE_STD_LEN:
+    case NODE_STD_TO_INT:
+    case NODE_TIME_NOW:
+    case NODE_TIME_FUNC:
+    case NODE_GC_FUNC:
+    case NODE_PATH_EXISTS:
+    case NODE_SYS_EXEC:
+    case NODE_UNARY:
+    case NODE_IO_FUNC:
+        if (node->op_type == TK_IO_ASYNC_BACKEND) return str_copy(aio_backend_name());
+        /* fallthrough */
+    case NODE_FILE_WRITE:
+    case NODE_FILE_FLUSH:
+    case NODE_FILE_CLOSE:
+    case NODE_FILE_COPY:
+        return numberToString(evalFloat(node));
+    case NODE_TERNARY:
+        return evalBool(node->left) ? evalString(node->right) : evalString(node->third);
+
+    // --- ASYNC / AWAIT / LAMBDA ---
+    case NODE_AWAIT: {
+        double num;
+        char* content = evalAwait(node, &num);
+        return content ? content : numberToString(num);
+    }
+    case NODE_LAMBDA:
+        return str_copy(lambdaFunction(node)->name);
+    case NODE_CMP_LOCALS:
+    case NODE_ADD_LOCAL_CONST:
+        return evalString(node->fourth);
+
+    default: return str_copy("");
+    } // Fin Switch
+}
+    
+static bool evalBool(ASTNode* node) {
+    if (!node) return false;
+    
+    switch (node->type) {
+        case NODE_BOOL:
+            return node->data.bool_val;
+            
+        case NODE_INT:
+            return node->data.int_val != 0;
+            
+        case NODE_FLOAT:
+            return fabs(node->data.float_val) > 1e-10;
+            
+        case NODE_STRING:
+            return node->data.str_val && strlen(node->data.str_val) > 0;
+            
+        case NODE_NULL:
+        case NODE_UNDEFINED:
+        case NODE_NAN:
+            return false;
+            
+        case NODE_INF:
+            return true;
+            
+        case NODE_CMP_LOCALS: {
+            bool result;
+            if (compareLocals(node, &result)) return result;
+            return evalFloat(node->fourth) != 0.0;
+        }
+            
+        default:
+            return evalFloat(node) != 0.0;
+    }
+}
+
+// ======================================================
+// [SECTION] FILE I/O FUNCTIONS
+// ======================================================
+static void executeRead(ASTNode* node) {
+    if (!node->left) {
+        printf("%s[READ ERROR]%s Missing filename\n", COLOR_RED, COLOR_RESET);
+        return;
+    }
+    
+    char* filename = evalString(node->left);
+    if (!filename) {
+        printf("%s[READ ERROR]%s Invalid filename\n", COLOR_RED, COLOR_RESET);
+        return;
+    }
+    
+    io_sync_path(filename); // Vider un éventuel append/writer en attente sur ce fichier
+    
+    // Check if file exists
+    if (access(filename, F_OK) != 0) {
+        printf("%s[READ ERROR]%s File not found: %s\n", COLOR_RED, COLOR_RESET, filename);
+        free(filename);
+        return;
+    }
+    
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+        printf("%s[READ ERROR]%s Cannot open file: %s\n", COLOR_RED, COLOR_RESET, filename);
+        free(filename);
+        return;
+    }
+    
+    // Read file content
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    
+    char* content = malloc(size + 1);
+    if (!content) {
+        printf("%s[READ ERROR]%s Memory allocation failed\n", COLOR_RED, COLOR_RESET);
+        fclose(f);
+        free(filename);
+        return;
+    }
+    
+    fread(content, 1, size, f);
+    content[size] = '\0';
+    fclose(f);
+    
+    // Store in variable if specified
+    if (node->right) {
+        char* var_name = evalString(node->right);
+        if (var_name) {
+            int idx = findVar(var_name);
+            if (idx == -1 && var_count < var_limit) {
+                Variable* var = &vars[var_count];
+                setVarName(var, var_name);
+                var->type = TK_VAR;
+                var->size_bytes = strlen(content) + 1;
+                var->scope_level = scope_level;
+                var->is_constant = false;
+                var->is_initialized = true;
+                var->is_string = true;
+                var->is_float = false;
+                var->value.str_val = rstr_from(content);
+                var_count++;
+                printf("%s[READ]%s Stored file content in variable '%s'\n", COLOR_GREEN, COLOR_RESET, var_name);
+            } else if (idx >= 0) {
+                setVarString(&vars[idx], rstr_from(content));
+                printf("%s[READ]%s Updated variable '%s' with file content\n", COLOR_GREEN, COLOR_RESET, var_name);
+            }
+            free(var_name);
+        }
+    } else {
+        // Store in default variable
+        int idx = findVar("__file_content__");
+        if (idx == -1 && var_count < var_limit) {
+            Variable* var = &vars[var_count];
+            setVarName(var, "__file_content__");
+            var->type = TK_VAR;
+            var->size_bytes = strlen(content) + 1;
+            var->scope_level = scope_level;
+            var->is_constant = false;
+            var->is_initialized = true;
+            var->is_string = true;
+            var->is_float = false;
+            var->value.str_val = rstr_from(content);
+            var_count++;
+        } else if (idx >= 0) {
+            setVarString(&vars[idx], rstr_from(content));
+        }
+
+    }
+    
+    free(content);
+    free(filename);
+}
+
+static void executeWrite(ASTNode* node) {
+    if (!node->left || !node->right) {
+        printf("%s[WRITE ERROR]%s Missing filename or data\n", COLOR_RED, COLOR_RESET);
+        return;
+    }
+    
+    char* filename = evalString(node->left);
+    char* data = evalString(node->right);
+    
+    if (!filename || !data) {
+        if (filename) free(filename);
+        if (data) free(data);
+        return;
+    }
+    
+    char* mode = "w"; // Default write mode
+    if (node->third) {
+        char* mode_str = evalString(node->third);
+        if (mode_str && (strcmp(mode_str, "a") == 0 || strcmp(mode_str, "append") == 0)) {
+            mode = "a";
+        }
+        free(mode_str);
+    }
+    
+    if (mode[0] == 'a') {
+        if (!io_append_cached(filename, data, strlen(data), scope_level)) {
+            printf("%s[WRITE ERROR]%s Cannot open file for appending: %s\n", COLOR_RED, COLOR_RESET, filename);
+        }
+        free(filename);
+        free(data);
+        return;
+    }
+    
+    io_sync_path(filename); // Un handle d'append en cache ne doit pas survivre à la troncature
+    FILE* f = fopen(filename, mode);
+    if (!f) {
+        printf("%sWRITE ERROR%s Cannot open file for writing: %s\n", COLOR_RED, COLOR_RESET, filename);
+        free(filename);
+        free(data);
+        return;
+    }
+    
+    fwrite(data, 1, strlen(data), f);
+    fclose(f);
+        
+    free(filename);
+    free(data);
+}
+
+static void executeAppend(ASTNode* node) {
+    // Le parser range les arguments dans data.append_op (list = chemin, value = données)
+    if (!node->data.append_op.list || !node->data.append_op.value) {
+        printf("%s[APPEND ERROR]%s Missing filename or data\n", COLOR_RED, COLOR_RESET);
+        return;
+    }
+    
+    char* filename = evalString(node->data.append_op.list);
+    char* data = evalString(node->data.append_op.value);
+    
+    if (!filename || !data) {
+        if (filename) free(filename);
+        if (data) free(data);
+        return;
+    }
+    
+    // Le handle reste ouvert (et bufferisé) jusqu'à la sortie de la fonction courante
+    if (!io_append_cached(filename, data, strlen(data), scope_level)) {
+        printf("%s[APPEND ERROR]%s Cannot open file for appending: %s\n", COLOR_RED, COLOR_RESET, filename);
+    }
+        
+    free(filename);
+    free(data);
+}
+
+// ======================================================
+// [SECTION] FOR-IN
+// ======================================================
+// Retire les variables de portée > level créées depuis 'mark' (fin de bloc,
+// fin d'itération) pour que la table ne se remplisse pas au fil des boucles.
+// Les propriétés d'objets créées entre-temps (portée 0) sont conservées.
+static void releaseScopeVars(int mark, int level) {
+    int kept = mark;
+    for (int i = mark; i < var_count; i++) {
+        if (vars[i].scope_level > level) {
+            if (vars[i].is_string) rstr_release(vars[i].value.str_val);
+            continue;
+        }
+        if (kept != i) vars[kept] = vars[i];
+        kept++;
+    }
+    for (int i = kept; i < var_count; i++) memset(&vars[i], 0, sizeof(Variable));
+    var_count = kept;
+}
+
+// Retire les 'count' slots consécutifs à partir de 'first' (variables de boucle)
+static void removeVars(int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        if (vars[i].is_string) rstr_release(vars[i].value.str_val);
+    }
+    memmove(&vars[first], &vars[first + count], (var_count - first - count) * sizeof(Variable));
+    var_count -= count;
+    memset(&vars[var_count], 0, count * sizeof(Variable));
+}
+
+// Crée un slot de variable réservé à la boucle (réutilisé à chaque itération)
+static int newLoopVar(const char* name, bool is_string) {
+    if (var_count >= var_limit) return -1;
+    int slot = var_count++;
+    Variable* var = &vars[slot];
+    memset(var, 0, sizeof(Variable));
+    setVarName(var, name);
+    var->type = TK_VAR;
+    var->scope_level = scope_level;
+    var->is_string = is_string;
+    var->is_float = !is_string;
+    var->is_initialized = true;
+    return slot;
+}
+
+static bool setLoopString(int slot, const char* value, size_t len) {
+    // Réutilise le buffer de l'itération précédente s'il n'a pas été partagé
+    char* copy = rstr_assign(vars[slot].value.str_val, value, len);
+    if (!copy) return false;
+    vars[slot].value.str_val = copy;
+    vars[slot].size_bytes = (int)(len + 1);
+    return true;
+}
+
+// for e in io.walk(...) : 'e' vaut l'identifiant d'un enregistrement dont les
+// champs (e.path, e.type, e.size, e.mtime) sont des variables "<id>_<champ>".
+static void executeWalk(ASTNode* node, ASTNode* iterable) {
+    static ISOLATE int walk_id = 0;
+    
+    ASTNode* options = iterable->right;
+    ASTNode* parallel_opt = findOption(options, "parallel");
+    ASTNode* follow_opt = findOption(options, "follow_links");
+    ASTNode* filter_opt = findOption(options, "filter");
+    ASTNode* stat_opt = findOption(options, "stat");
+    
+    char* root = evalString(iterable->left);
+    char* filter = filter_opt ? evalString(filter_opt) : NULL;
+    int handle = io_walk_open(root,
+                              parallel_opt ? (int)evalFloat(parallel_opt) : 0,
+                              follow_opt ? evalBool(follow_opt) : false,
+                              filter,
+                              stat_opt ? evalBool(stat_opt) : true);
+    free(root);
+    if (filter) free(filter);
+    if (handle < 0) return;
+    
+    char record[64];
+    snprintf(record, sizeof(record), "walk_%d", ++walk_id);
+    char field[128];
+    
+    int base = var_count;
+    int slot = newLoopVar(node->data.for_in.var_name, true);
+    snprintf(field, sizeof(field), "%s_path", record);
+    int path_slot = newLoopVar(field, true);
+    snprintf(field, sizeof(field), "%s_type", record);
+    int type_slot = newLoopVar(field, true);
+    snprintf(field, sizeof(field), "%s_size", record);
+    int size_slot = newLoopVar(field, false);
+    snprintf(field, sizeof(field), "%s_mtime", record);
+    int mtime_slot = newLoopVar(field, false);
+    
+    if (mtime_slot < 0) {
+        removeVars(base, var_count - base);
+        io_walk_close(handle);
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    setLoopString(slot, record, strlen(record));
+    
+    IoWalkEntry entry;
+    while (io_walk_next(handle, &entry)) {
+        bool ok = setLoopString(path_slot, entry.path, strlen(entry.path)) &&
+                  setLoopString(type_slot, entry.type, strlen(entry.type));
+        free(entry.path);
+        if (!ok) break;
+        vars[size_slot].value.float_val = (double)entry.size;
+        vars[mtime_slot].value.float_val = entry.mtime;
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(mtime_slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    
+    io_walk_close(handle);
+    removeVars(base, 5);
+}
+
+// for x in liste : la longueur est relue à chaque tour (le corps peut
+// ajouter ou retirer des éléments)
+static void executeForInList(ASTNode* node, List* list) {
+    int slot = newLoopVar(node->data.for_in.var_name, true);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    gcPushRoot(&list->gc);
+    for (int i = 0; i < list->count; i++) {
+        storeValue(&vars[slot], copyValue(list->items[i]));
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    gcPopRoots(1);
+    removeVars(slot, 1);
+}
+
+static void executeForInArray(ASTNode* node, TypedArray* arr) {
+    int slot = newLoopVar(node->data.for_in.var_name, false);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    gcPushRoot(&arr->gc);
+    for (int i = 0; i < arr->count; i++) {
+        setVarNumber(&vars[slot], arrayGet(arr, i));
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    gcPopRoots(1);
+    removeVars(slot, 1);
+}
+
+// for k in map : clés dans l'ordre d'insertion
+static void executeForInMap(ASTNode* node, Map* map) {
+    int slot = newLoopVar(node->data.for_in.var_name, true);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    gcPushRoot(&map->gc);
+    for (int i = 0; i < map->entry_count; i++) {
+        if (map->entries[i].deleted) continue;
+        storeValue(&vars[slot], copyValue(map->entries[i].key));
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    gcPopRoots(1);
+    removeVars(slot, 1);
+}
+
+// Nombre de tours de a..b (b exclu) ou a..=b (b inclus), pas de 1
+static long rangeCount(ASTNode* node, double start, double end) {
+    double span = end - start;
+    long count = node->op_type == TK_RANGE_INCL ? (long)floor(span) + 1 : (long)ceil(span);
+    return count > 0 ? count : 0;
+}
+
+// for i in a..b : tours [from, to) de l'intervalle qui commence à 'start'
+static void executeForInRange(ASTNode* node, double start, long from, long to) {
+    int slot = newLoopVar(node->data.for_in.var_name, false);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    for (long k = from; k < to; k++) {
+        setVarNumber(&vars[slot], start + (double)k);
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    removeVars(slot, 1);
+}
+
+static void executeForIn(ASTNode* node) {
+    ASTNode* iterable = node->data.for_in.iterable;
+    char* var_name = node->data.for_in.var_name;
+    if (!iterable || !var_name) return;
+    
+    if (node->third) {
+        double start = evalFloat(iterable);
+        executeForInRange(node, start, 0, rangeCount(node, start, evalFloat(node->third)));
+        return;
+    }
+    
+    if (iterable->type == NODE_IO_FUNC && iterable->op_type == TK_IO_WALK) {
+        executeWalk(node, iterable);
+        return;
+    }
+    
+    if (iterable->type != NODE_IO_FUNC) {
+        char* id = evalStr(iterable);
+        List* list = listFromId(id);
+        Map* map = list ? NULL : mapFromId(id);
+        TypedArray* arr = list || map ? NULL : arrayFromId(id);
+        ChanRef* chan = list || map || arr ? NULL : chanFromId(id);
+        ProcRef* proc = list || map || arr || chan ? NULL : procFromId(id);
+        rstr_release(id);
+        if (map) {
+            executeForInMap(node, map);
+            return;
+        }
+        if (chan) {
+            executeForInChan(node, chan);
+            return;
+        }
+        if (proc) {
+            executeForInProc(node, proc);
+            return;
+        }
+        if (arr) {
+            executeForInArray(node, arr);
+            return;
+        }
+        if (!list) {
+            runtime_error(node, "for-in: unsupported iterable (expected a list, a map, an array, a channel, a process, io.lines, io.chunks or io.walk)");
+            return;
+        }
+        executeForInList(node, list);
+        return;
+    }
+    if (iterable->op_type != TK_IO_LINES && iterable->op_type != TK_IO_CHUNKS) {
+        runtime_error(node, "for-in: unsupported iterable (expected a list, a map, an array, a channel, a process, io.lines, io.chunks or io.walk)");
+        return;
+    }
+    
+    char* path = evalString(iterable->left);
+    int handle = iterable->op_type == TK_IO_LINES
+        ? io_lines_open(path)
+        : io_chunks_open(path, (size_t)evalFloat(iterable->right));
+    free(path);
+    if (handle < 0) return;
+    
+    // Variable de boucle : un seul slot, réutilisé à chaque itération
+    int slot = newLoopVar(var_name, true);
+    if (slot < 0) {
+        io_iter_close(handle);
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    
+    size_t len;
+    const char* item;
+    while ((item = io_iter_next(handle, &len)) != NULL) {
+        if (!setLoopString(slot, item, len)) break;
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    
+    io_iter_close(handle);
+    removeVars(slot, 1);
+}
+
+// ======================================================
+// [SECTION] VERROUS
+// ======================================================
+// lock(x) { ... } : exclusion mutuelle entre les tâches de l'isolat, sur la
+// valeur du tas référencée par x (liste, map, objet...) ou, pour un nombre
+// ou une chaîne, sur la variable elle-même. Réentrant : la tâche qui détient
+// le verrou peut le reprendre. rwlock read(x) / rwlock write(x) : lecteurs
+// simultanés ou un seul écrivain ; un écrivain en attente passe avant les
+// nouveaux lecteurs. La tâche qui attend est suspendue (sched_park) et
+// réveillée à chaque libération. Le verrou est rendu à la sortie du bloc,
+// return et break compris. Les isolats ne partagent aucune valeur (les
+// canaux copient) : il n'y a pas de contention entre threads à gérer ici.
+
+typedef struct {
+    int task;     // id sched
+    int depth;
+} LockReader;
+
+typedef struct {
+    const void* key;
+    int writer;              // tâche qui écrit, -1 sinon
+    int write_depth;
+    LockReader* readers;
+    int reader_count;
+    int reader_cap;
+    int* waiters;            // tâches suspendues, réveillées ensemble
+    int waiter_count;
+    int waiter_cap;
+    int writers_waiting;
+} ValueLock;
+
+static ISOLATE ValueLock* value_locks = NULL; // verrous tenus ou attendus
+static ISOLATE int value_lock_count = 0;
+static ISOLATE int value_lock_cap = 0;
+
+static ValueLock* findValueLock(const void* key, bool create) {
+    for (int i = 0; i < value_lock_count; i++) {
+        if (value_locks[i].key == key) return &value_locks[i];
+    }
+    if (!create) return NULL;
+    if (value_lock_count == value_lock_cap) {
+        value_lock_cap = value_lock_cap ? value_lock_cap * 2 : 8;
+        value_locks = realloc(value_locks, value_lock_cap * sizeof(ValueLock));
+        if (!value_locks) { fprintf(stderr, "%s[FATAL]%s Out of memory (lock)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    }
+    ValueLock* lock = &value_locks[value_lock_count++];
+    memset(lock, 0, sizeof(ValueLock));
+    lock->key = key;
+    lock->writer = -1;
+    return lock;
+}
+
+static int lockReaderIndex(ValueLock* lock, int task) {
+    for (int i = 0; i < lock->reader_count; i++) {
+        if (lock->readers[i].task == task) return i;
+    }
+    return -1;
+}
+
+static bool lockAvailable(ValueLock* lock, int self, bool write) {
+    if (lock->writer == self) return true;
+    if (lock->writer >= 0) return false;
+    if (write) return lock->reader_count == 0;
+    return lockReaderIndex(lock, self) >= 0 || lock->writers_waiting == 0;
+}
+
+// Clé du verrou : valeur du tas, sinon la variable (racine ajoutée : *heap)
+static const void* lockKey(ASTNode* target, HeapHeader** heap) {
+    *heap = NULL;
+    if (target->type == NODE_IDENT) {
+        int idx = findVarSym(nodeSym(target));
+        if (idx < 0) runtime_error(target, "Cannot lock undefined variable '%s'", target->data.name);
+        *heap = vars[idx].is_string ? heapFromId(vars[idx].value.str_val) : NULL;
+        return *heap ? (const void*)*heap : (const void*)&vars[idx];
+    }
+    char* id = evalStr(target);
+    *heap = heapFromId(id);
+    rstr_release(id);
+    if (!*heap) runtime_error(target, "lock expects a variable or a list, map or object");
+    return *heap;
+}
+
+// Retourne vrai si le verrou a été pris en écriture (lecture dans sa
+// propre écriture : compté comme écriture)
+static bool acquireLock(const void* key, bool write, ASTNode* node) {
+    int self = sched_current();
+    ValueLock* lock = findValueLock(key, true);
+    if (write && lock->writer != self && lockReaderIndex(lock, self) >= 0) {
+        runtime_error(node, "Cannot upgrade a read lock to a write lock");
+    }
+    while (!lockAvailable(lock, self, write)) {
+        if (lock->waiter_count == lock->waiter_cap) {
+            lock->waiter_cap = lock->waiter_cap ? lock->waiter_cap * 2 : 4;
+            lock->waiters = realloc(lock->waiters, lock->waiter_cap * sizeof(int));
+            if (!lock->waiters) { fprintf(stderr, "%s[FATAL]%s Out of memory (lock)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        }
+        lock->waiters[lock->waiter_count++] = self;
+        if (write) lock->writers_waiting++;
+        sched_park();
+        lock = findValueLock(key, true); // la table a pu être agrandie
+        if (write) lock->writers_waiting--;
+    }
+    
+    if (write || lock->writer == self) {
+        lock->writer = self;
+        lock->write_depth++;
+        return true;
+    }
+    int r = lockReaderIndex(lock, self);
+    if (r < 0) {
+        if (lock->reader_count == lock->reader_cap) {
+            lock->reader_cap = lock->reader_cap ? lock->reader_cap * 2 : 4;
+            lock->readers = realloc(lock->readers, lock->reader_cap * sizeof(LockReader));
+            if (!lock->readers) { fprintf(stderr, "%s[FATAL]%s Out of memory (lock)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        }
+        r = lock->reader_count++;
+        lock->readers[r].task = self;
+        lock->readers[r].depth = 0;
+    }
+    lock->readers[r].depth++;
+    return false;
+}
+
+static void releaseLock(const void* key, bool write) {
+    ValueLock* lock = findValueLock(key, false);
+    if (!lock) return;
+    if (write) {
+        if (--lock->write_depth > 0) return;
+        lock->writer = -1;
+    } else {
+        int r = lockReaderIndex(lock, sched_current());
+        if (r < 0 || --lock->readers[r].depth > 0) return;
+        lock->readers[r] = lock->readers[--lock->reader_count];
+        if (lock->reader_count > 0) return;
+    }
+    
+    // Libre : toutes les tâches en attente revérifient, dans l'ordre d'arrivée
+    for (int i = 0; i < lock->waiter_count; i++) sched_unpark(lock->waiters[i]);
+    lock->waiter_count = 0;
+    if (lock->writers_waiting == 0 && lock->reader_count == 0) {
+        free(lock->readers);
+        free(lock->waiters);
+        *lock = value_locks[--value_lock_count];
+    }
+}
+
+static void executeLock(ASTNode* node) {
+    if (!node->left) return;
+    HeapHeader* heap;
+    const void* key = lockKey(node->left, &heap);
+    gcPushRoot(heap); // la clé reste valide tant que le verrou est tenu
+    bool write = acquireLock(key, node->op_type != TK_READ, node);
+    execute(node->right);
+    releaseLock(key, write);
+    gcPopRoots(1);
+}
+
+// ======================================================
+// [SECTION] WELD FUNCTION
+// ======================================================
+static char* weldInput(const char* prompt) {
+    if (prompt) {
+        printf("%s", prompt);
+        fflush(stdout);
+    }
+    
+    char* input = malloc(1024);
+    if (input) {
+        if (fgets(input, 1024, stdin)) {
+            input[strcspn(input, "\n")] = 0;
+        } else {
+            strcpy(input, "");
+        }
+    }
+    return input;
+}
+// Helper pour enregistrer une constante (utilisé par ENUM)
+static void registerGlobalConstant(const char* name, int value) {
+    if (var_count < var_limit) {
+        Variable* var = &vars[var_count];
+        memset(var, 0, sizeof(Variable));
+        setVarName(var, name);
+        var->type = TK_CONST;
+        var->size_bytes = 8;
+        var->scope_level = 0; // Toujours global
+        var->is_constant = true;
+        var->is_initialized = true;
+        var->is_float = false;
+        var->is_string = false;
+        var->value.int_val = value;
+        var_count++;
+        
+    }
+}
+
+// Helper pour générer un nom unique pour les lambdas
+static char* generateLambdaName() {
+    static ISOLATE int lambda_id = 0;
+    char* name = malloc(32);
+    sprintf(name, "__lambda_%d", lambda_id++);
+    return name;
+}
+// ======================================================
+// [SECTION] MAIN EXECUTION FUNCTION
+// ======================================================
+// Table des variables (dbvar) : commande de débogage, hors du chemin chaud
+COLD static void executeDbvar(void) {
+    printf("\n%s╔═════════════════════════════════════════════════╗%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+     printf("%s║                   VARIABLE TABLE (dbvar)          ║%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+    printf("%s╠═══════════════════════════════════════════════════╣%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+    printf("%s║  Type    │ Name     │ Size │ Value  │ Initialized ║%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+    printf("%s╠═══════════════════════════════════════════════════╣%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+    
+    for (int i = var_floor; i < var_count; i++) {
+        Variable* var = &vars[i];
+        char value_str[50];
+        
+        if (var->is_string && var->value.str_val) {
+            snprintf(value_str, sizeof(value_str), "\"%s\"", var->value.str_val);
+        } else if (var->is_float) {
+            snprintf(value_str, sizeof(value_str), "%g", var->value.float_val);
+        } else {
+            snprintf(value_str, sizeof(value_str), "%lld", var->value.int_val);
+        }
+        
+        printf("%s║ %-8s │ %-11s │ %-8d │ %-11s │ %-11s ║%s\n",
+               COLOR_CYAN,
+               getTypeName(var->type),
+               var->name,
+               var->size_bytes,
+               value_str,
+               var->is_initialized ? "✓" : "✗",
+               COLOR_RESET);
+    }
+    
+    if (var_count == var_floor) {
+        printf("%s║                   No variables declared                       ║%s\n", 
+               COLOR_CYAN, COLOR_RESET);
+    }
+    
+    printf("   %s╚════════════════════════════════════════════════════════════════╝%s\n", 
+           COLOR_CYAN, COLOR_RESET);
+}
+
+COLD static void executeImport(ASTNode* node) {
+    if (node->data.imports.module_count > 0) {
+        for (int i = 0; i < node->data.imports.module_count; i++) {
+            char* module_name = node->data.imports.modules[i];
+            char* from_module = node->data.imports.from_module;
             
             // Si c'est un import nommé (import {add, PI} from "math")
             if (node->left) {
@@ -2001,345 +4993,2477 @@ case NODE_DIR_LIST:
                     symbol_node = symbol_node->right;
                 }
                 
-                // Créer un tableau des noms de symboles
-                char** named_symbols = malloc(symbol_count * sizeof(char*));
-                symbol_node = node->left;
-                int idx = 0;
-                while (symbol_node && idx < symbol_count) {
-                    if (symbol_node->type == NODE_IDENT && symbol_node->data.name) {
-                        named_symbols[idx] = str_copy(symbol_node->data.name);
-                    } else {
-                        named_symbols[idx] = NULL;
-                    }
-                    symbol_node = symbol_node->right;
-                    idx++;
+                // Créer un tableau des noms de symboles
+                char** named_symbols = malloc(symbol_count * sizeof(char*));
+                symbol_node = node->left;
+                int idx = 0;
+                while (symbol_node && idx < symbol_count) {
+                    if (symbol_node->type == NODE_IDENT && symbol_node->data.name) {
+                        named_symbols[idx] = str_copy(symbol_node->data.name);
+                    } else {
+                        named_symbols[idx] = NULL;
+                    }
+                    symbol_node = symbol_node->right;
+                    idx++;
+                }
+                
+                // Importer avec les symboles nommés
+                if (!loadAndExecuteModule(module_name, from_module, true, named_symbols, symbol_count)) {
+                    runtime_error(node, "Cannot import '%s'", module_name);
+                }
+                
+                // Nettoyer
+                for (int j = 0; j < symbol_count; j++) {
+                    if (named_symbols[j]) free(named_symbols[j]);
+                }
+                free(named_symbols);
+            } 
+            // Import simple (import "math")
+            else {
+                if (!loadAndExecuteModule(module_name, from_module, false, NULL, 0)) {
+                     runtime_error(node, "import runtime stoped '%s'", module_name);                          
+                }
+            }
+        }
+    }
+}
+
+// Nœuds rares (déclarations, IO, réseau, système, modules) : hors ligne
+COLD static void executeCold(ASTNode* node) {
+    switch (node->type) {
+    case NODE_ENV_FUNC: {
+        if (node->op_type == TK_ENV_SET) {
+            char* key = evalString(node->left);
+            char* val = evalString(node->right);
+            std_env_set(key, val);
+            free(key); free(val);
+        }
+        break;
+    }
+        case NODE_SYS_EXIT: {
+            int code = 0;
+            if (node->left) code = (int)evalFloat(node->left);
+            exit(code);
+            break;
+        }
+        case NODE_TIME_SLEEP:
+        sched_sleep(evalFloat(node->left));
+        break;
+        case NODE_GC_FUNC:
+        case NODE_TIME_FUNC:
+        evalFloat(node);
+        break;
+        case NODE_SYS_SPAWN:
+        case NODE_SYS_RUN_ALL:
+        rstr_release(evalStr(node)); // spawn : lancé sans attendre
+        break;
+        case NODE_SYS_EXEC: {
+             // Si utilisé comme instruction simple sans récupération de variable
+             char* cmd = evalString(node->left);
+             system(cmd);
+             if (cmd) free(cmd);
+             break;
+        }
+        case NODE_EXPORT: {
+        
+    if (node->data.export.symbol) {
+        char* symbol = node->data.export.symbol;
+        char* alias = node->data.export.alias ? node->data.export.alias : symbol;
+                
+        registerExport(symbol, alias);
+    }
+    break;
+}
+        // net pour le command void
+        case NODE_NET_CONNECT: {
+            int fd = (int)evalFloat(node->left);      // Évaluation variable sock
+            char* ip = evalString(node->right);       // Évaluation string ip
+            int port = (int)evalFloat(node->third);   // Évaluation int/var port
+            
+            net_connect_to(fd, ip, port);
+            
+            if (ip) free(ip);
+            break;
+        }
+        case NODE_NET_SEND: {
+            int fd = (int)evalFloat(node->left);
+            char* data = evalString(node->right);
+            
+            net_send_data(fd, data);
+            
+            if (data) free(data);
+            break;
+        }
+        case NODE_NET_CLOSE: {
+            int fd = (int)evalFloat(node->left);
+            net_close_socket(fd);
+            break;
+        }
+
+
+        
+case NODE_FILE_OPEN:
+    io_open(node);
+    break;
+    
+case NODE_FILE_CLOSE:
+case NODE_FILE_WRITE:
+case NODE_FILE_FLUSH:
+case NODE_FILE_COPY:
+case NODE_IO_FUNC:
+    evalFloat(node);
+    break;
+    
+case NODE_FILE_SEEK:
+    io_seek(node);
+    break;
+    
+case NODE_FILE_TELL:
+    io_tell(node);
+    break;
+    
+case NODE_PATH_ISFILE:
+    io_isfile(node);
+    break;
+    
+case NODE_PATH_ISDIR:
+    io_isdir(node);
+    break;
+    
+case NODE_DIR_CREATE:
+    io_mkdir(node);
+    break;
+    
+case NODE_DIR_LIST:
+    io_listdir(node);
+    break;    
+        
+        case NODE_READ:
+            executeRead(node);
+            break;
+            
+        case NODE_WRITE:
+            executeWrite(node);
+            break;
+            
+        case NODE_APPEND:
+            executeAppend(node);
+            break;
+            
+        case NODE_DBVAR:
+            executeDbvar();
+            break;
+
+        case NODE_IMPORT:
+            executeImport(node);
+            break;
+
+    case NODE_PARALLEL_FOR:
+        executeParallelFor(node);
+        break;
+
+    // --- OOP (CLASS) ---
+    case NODE_CLASS: {
+        char* cls_name = node->data.class_def.name;
+        if (cls_name) {
+            // 1. Enregistrement de la classe (existant)
+            char* parent = node->data.class_def.parent ? node->data.class_def.parent->data.name : NULL;
+            registerClass(cls_name, parent, node->data.class_def.members);
+            
+            // 2. [NOUVEAU] Aplatissement des méthodes : Zarch.install -> Zarch_install
+            ASTNode* member = node->data.class_def.members;
+            while (member) {
+                if (member->type == NODE_FUNC) {
+                    char method_full_name[256];
+                    snprintf(method_full_name, 256, "%s_%s", cls_name, member->data.name);
+                    
+                    // Compter les params
+                    int p_count = 0;
+                    ASTNode* p = member->left;
+                    while(p) { p_count++; p = p->right; }
+                    
+                    registerFunction(method_full_name, member->left, member->right, p_count);
+                    // printf("[OOP] Registered method: %s\n", method_full_name);
+                }
+                member = member->next;
+            }
+        }
+        break;
+    }
+
+    // --- OOP (ENUM) ---
+    case NODE_ENUM: {
+        // Transforme: enum Color { RED, BLUE } 
+        // En constantes globales: Color_RED = 0, Color_BLUE = 1
+        if (node->data.name && node->left) {
+            ASTNode* variant = node->left;
+            int val_counter = 0;
+            
+            while (variant) {
+                char full_name[256];
+                char* variant_name = NULL;
+                
+                // Le variant peut être un IDENT ou un ASSIGN (si valeur manuelle)
+                if (variant->type == NODE_IDENT) {
+                    variant_name = variant->data.name;
+                } else if (variant->type == NODE_ASSIGN && variant->data.name) {
+                    variant_name = variant->data.name;
+                    // Si une valeur est assignée (ex: RED = 5)
+                    if (variant->left) val_counter = (int)evalFloat(variant->left);
                 }
                 
-                // Importer avec les symboles nommés
-                if (!loadAndExecuteModule(module_name, from_module, true, named_symbols, symbol_count)) {
-                    runtime_error(node, "Cannot import '%s'", module_name);
+                if (variant_name) {
+                    snprintf(full_name, 256, "%s_%s", node->data.name, variant_name);
+                    registerGlobalConstant(full_name, val_counter);
+                    val_counter++;
                 }
                 
-                // Nettoyer
-                for (int j = 0; j < symbol_count; j++) {
-                    if (named_symbols[j]) free(named_symbols[j]);
-                }
-                free(named_symbols);
-            } 
-            // Import simple (import "math")
-            else {
-                if (!loadAndExecuteModule(module_name, from_module, false, NULL, 0)) {
-                     runtime_error(node, "import runtime stoped '%s'", module_name);                          
+                variant = variant->right;
+            }
+        }
+        break;
+    }
+
+    // --- ASYNC (Déclaration) ---
+    case NODE_ASYNC: {
+        // 'async func' : fonction normale dont les appels lancent une tâche
+        if (node->left && node->left->type == NODE_FUNC) {
+            // On délègue l'enregistrement au NODE_FUNC standard
+            execute(node->left); 
+            
+            if (node->left->data.name) {
+                Function* f = findFunctionSym(intern(node->left->data.name));
+                if (f) f->is_async = true;
+            }
+        }
+        break;
+    }         
+       
+        case NODE_FUNC: {
+    // Enregistrer la fonction SEULEMENT si on est dans le scope global
+    // et si ce n'est pas dans un module importé (géré par loadAndExecuteModule)
+    if (node->data.name && scope_level == 0) {
+                               
+        int param_count = 0;
+        ASTNode* param = node->left;
+        while (param) {
+            param_count++;
+            param = param->right;
+        }
+        
+        registerFunction(node->data.name, node->left, node->right, param_count);
+    }
+    break;
+} 
+            
+       case NODE_LOCK:
+        executeLock(node);
+        break;
+            
+        case NODE_TYPEDEF:
+            break;
+            
+        case NODE_JSON:
+            break;
+            
+        case NODE_AWAIT:
+        case NODE_LIST:
+        case NODE_MAP:
+            evalFloat(node);
+            break;
+            
+        default:
+            break;
+    }
+}
+
+// Nœuds fréquents, traités en ligne par execute()
+#define EXEC_HOT(X) \
+    X(NODE_BLOCK, exec_block) \
+    X(NODE_INC_LOCAL, exec_inc_local) \
+    X(NODE_ASSIGN, exec_assign) \
+    X(NODE_COMPOUND_ASSIGN, exec_assign) \
+    X(NODE_FUNC_CALL, exec_call) \
+    X(NODE_METHOD_CALL, exec_method) \
+    X(NODE_IF, exec_if) \
+    X(NODE_WHILE, exec_while) \
+    X(NODE_FOR, exec_for) \
+    X(NODE_FOR_IN, exec_for_in) \
+    X(NODE_RETURN, exec_return) \
+    X(NODE_VAR_DECL, exec_decl) \
+    X(NODE_CONST_DECL, exec_decl) \
+    X(NODE_NET_DECL, exec_decl) \
+    X(NODE_CLOG_DECL, exec_decl) \
+    X(NODE_DOS_DECL, exec_decl) \
+    X(NODE_SEL_DECL, exec_decl) \
+    X(NODE_PRINT, exec_print) \
+    X(NODE_BINARY, exec_expr) \
+    X(NODE_UNARY, exec_expr) \
+    X(NODE_TERNARY, exec_expr) \
+    X(NODE_CMP_LOCALS, exec_expr) \
+    X(NODE_ADD_LOCAL_CONST, exec_expr) \
+    X(NODE_PASS, exec_pass) \
+    X(NODE_MAIN, exec_main)
+
+static void execute(ASTNode* node) {
+    if (!node) return;
+    DISPATCH(EXEC_HOT, node, exec_cold);
+
+exec_block: {
+    int old_scope = scope_level;
+    int var_mark = var_count;
+    scope_level++;
+    
+    ASTNode* current = node->left;
+    while (current && !(current_function && current_function->has_returned)) {
+        if (gc_pending || gc_sweeping) gcSafepoint();
+        execute(current);
+        current = current->next;
+    }
+    
+    scope_level = old_scope;
+    releaseScopeVars(var_mark, old_scope); // Variables locales au bloc
+    return;
+}
+exec_inc_local:
+    executeIncLocal(node);
+    return;
+
+exec_assign: {
+    Variable* target = NULL;
+    const char* target_name = NULL;
+    Object* owner = NULL; // objet dont on écrit un slot : racine pendant l'évaluation
+    
+    if (!node->data.name && node->left && node->left->type == NODE_ARRAY_ACCESS) {
+        executeIndexAssign(node);
+        return;
+    }
+    
+    // 1. IDENTIFICATION DE LA CIBLE
+    // Cas A : Assignation simple (x = 1)
+    if (node->data.name) {
+        int idx = findVarSym(nodeSym(node));
+        
+        // Si la variable n'existe pas, on la crée (Auto-déclaration)
+        if (idx == -1 && var_count < var_limit) {
+            idx = var_count++;
+            memset(&vars[idx], 0, sizeof(Variable));
+            setVarName(&vars[idx], node->data.name);
+            vars[idx].type = TK_VAR; 
+            vars[idx].scope_level = scope_level; 
+        }
+        if (idx >= 0) target = &vars[idx];
+        target_name = node->data.name;
+    }
+    // Cas B : Assignation de propriété (obj.x = 1) : slot de l'objet,
+    // ajouté à sa forme s'il n'existe pas encore
+    else if (node->left && node->left->type == NODE_MEMBER_ACCESS) {
+        target = resolveMember(node->left, true, &owner);
+        target_name = node->left->right->data.name;
+    }
+    gcPushRoot(owner ? &owner->gc : NULL);
+
+    // 2. AFFECTATION DE LA VALEUR
+    if (target) {
+        if (target->is_constant) {
+            runtime_error(node, "Cannot assign to constant '%s'", target_name);
+        }
+        else if (node->right) {
+            // L'ancienne chaîne n'est relâchée qu'après évaluation de la
+            // valeur (s = s + x lit encore s)
+            if (node->type == NODE_COMPOUND_ASSIGN) {
+                executeCompoundAssign(target, node);
+            } else if (isSelfConcat(node->right, target)) {
+                setVarString(target, evalConcat(node->right, target));
+            } else {
+                storeValue(target, evalValue(node->right));
+            }
+        }
+    }
+    gcPopRoots(1);
+    return;
+}
+exec_call:
+    if (!callFunction(node)) {
+        fprintf(stderr, "\033[31m[RUNTIME ERROR]\033[0m Function or method not found: '%s'\n", node->data.name);
+        exit(1);
+    }
+    return;
+
+exec_method:
+    callFunction(node);
+    return;
+
+// --- CONTROL FLOW (IF / ELIF / ELSE) ---
+exec_if:
+    // Le parser gère le ELIF comme un NODE_IF imbriqué dans le 'third' (else)
+    if (evalBool(node->left)) {
+        execute(node->right);
+    } else if (node->third) {
+        execute(node->third);
+    }
+    return;
+
+// --- LOOPS (WHILE) ---
+exec_while:
+    while (evalBool(node->left)) {
+        execute(node->right);
+        // Important: si un 'return' est appelé dans la boucle, on doit s'arrêter
+        if (current_function && current_function->has_returned) break;
+    }
+    return;
+
+// --- LOOPS (FOR) ---
+exec_for:
+    if (node->data.loop.init) execute(node->data.loop.init);
+    while (evalBool(node->data.loop.condition)) {
+        execute(node->data.loop.body);
+        if (current_function && current_function->has_returned) break;
+        if (node->data.loop.update) execute(node->data.loop.update);
+    }
+    return;
+
+// --- LOOPS (FOR-IN) ---
+exec_for_in:
+    executeForIn(node);
+    return;
+
+exec_return: {
+    if (current_function) {
+        current_function->has_returned = true;
+        if (node->left) {
+            // Une seule évaluation : l'expression peut avoir des effets de bord.
+            // La chaîne retournée est partagée avec l'appelant.
+            EvalValue result = evalValue(node->left);
+            rstr_release(current_function->return_string);
+            current_function->return_string = NULL;
+            if (result.is_string) {
+                current_function->return_value = strtod(result.str, NULL);
+                current_function->return_string = result.str;
+            } else if (node->left->type == NODE_BOOL) {
+                current_function->return_value = result.num;
+                current_function->return_string = rstr_from(node->left->data.bool_val ? "true" : "false");
+            } else {
+                current_function->return_value = result.num;
+            }
+        } else {
+            current_function->return_value = 0;
+            rstr_release(current_function->return_string);
+            current_function->return_string = NULL;
+        }
+    }
+    return;
+}
+exec_decl: {
+    // 1. DÉTERMINER LE TYPE
+    TokenKind var_type = TK_VAR;
+    if (node->type == NODE_NET_DECL) var_type = TK_NET;
+    else if (node->type == NODE_CLOG_DECL) var_type = TK_CLOG;
+    else if (node->type == NODE_DOS_DECL) var_type = TK_DOS;
+    else if (node->type == NODE_SEL_DECL) var_type = TK_SEL;
+    else if (node->type == NODE_CONST_DECL) var_type = TK_CONST;
+    
+    // 2. CALCULER LA VALEUR D'ABORD (IMPORTANT : AVANT d'allouer la variable)
+    // Cela empêche les fonctions appelées d'écraser la mémoire de cette variable
+    bool has_init = node->left != NULL;
+    EvalValue value = { false, false, NULL, 0.0 };
+    if (has_init) value = evalValue(node->left);
+    // 'var x: int' : une valeur entière exacte est rangée dans un slot int
+    if (node->op_type == TK_TYPE_INT && !value.is_string && fabs(value.num) < EXACT_INT_LIMIT &&
+        value.num == (double)(int64_t)value.num) {
+        value.is_int = true;
+    }
+    
+    // 3. MAINTENANT ON ALLOUE LA VARIABLE (Une fois que l'exécution est finie)
+    if (var_count < var_limit) {
+        Variable* var = &vars[var_count]; // On prend le slot
+        memset(var, 0, sizeof(Variable));
+        
+        setVarName(var, node->data.name);
+        var->type = var_type;
+        var->size_bytes = calculateVariableSize(var_type);
+        var->scope_level = scope_level;
+        var->is_constant = (var_type == TK_CONST);
+        var->module = NULL;
+        var->is_exported = false;
+        
+        if (has_init) storeValue(var, value);
+        
+        var_count++; // On incrémente le compteur SEULEMENT à la fin
+    } else {
+        rstr_release(value.str);
+    }
+    return;
+}
+exec_print: {
+    if (node->left) {
+        ASTNode* current_arg = node->left;
+        while (current_arg) {
+            char* str = displayStr(evalStr(current_arg));
+            fwrite(str, 1, rstr_len(str), stdout);
+            rstr_release(str);
+            current_arg = current_arg->next;
+            if (current_arg) printf(" ");
+        }
+    }
+    printf("\n");
+    return;
+}
+exec_expr:
+    evalFloat(node);
+    return;
+
+exec_pass:
+    return;
+
+exec_main:
+    if (node->left) execute(node->left);
+    return;
+
+exec_cold:
+    executeCold(node);
+}
+
+// ======================================================
+// [SECTION] OPTIMISATION DE L'AST
+// ======================================================
+// Passe unique entre parse() et l'exécution : les expressions dont les
+// opérandes sont des littéraux (60 * 60 * 24, "a" + "b", math.PI) sont
+// remplacées par leur valeur, les branches if/elif/while dont la condition
+// est constante sont élaguées et les négations simplifiées. Les règles
+// reprennent exactement celles d'evalFloat / evalStr / evalBool : une
+// expression qui produirait un avertissement à l'exécution (division par
+// zéro...) n'est pas pliée.
+
+static bool opt_enabled = true; // SWIFT_NO_OPT=1 : exécution de l'AST brut
+static bool dump_ast = false;   // --dump-ast : affiche l'arbre optimisé sans l'exécuter
+
+static ASTNode* optimizeNode(ASTNode* node);
+
+static ASTNode* newConstNode(NodeType type, ASTNode* origin) {
+    ASTNode* node = calloc(1, sizeof(ASTNode));
+    if (!node) { fprintf(stderr, "%s[FATAL]%s Out of memory (optimizer)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    node->type = type;
+    node->line = origin->line;
+    node->column = origin->column;
+    return node;
+}
+
+// Nombre : NODE_INT quand la valeur est entière (même affichage que
+// formatNumber), NODE_FLOAT sinon
+static ASTNode* numberNode(double value, ASTNode* origin) {
+    if (value == (int64_t)value && fabs(value) < 1e18) {
+        ASTNode* node = newConstNode(NODE_INT, origin);
+        node->data.int_val = (int64_t)value;
+        return node;
+    }
+    ASTNode* node = newConstNode(NODE_FLOAT, origin);
+    node->data.float_val = value;
+    return node;
+}
+
+static ASTNode* stringNode(char* value, ASTNode* origin) {
+    ASTNode* node = newConstNode(NODE_STRING, origin);
+    node->data.str_val = value;
+    return node;
+}
+
+// Valeur numérique d'un littéral (contexte evalFloat) ; les strings ne sont
+// pas des constantes numériques ici
+static bool constNumber(ASTNode* node, double* value) {
+    if (!node) return false;
+    switch (node->type) {
+        case NODE_INT: *value = (double)node->data.int_val; return true;
+        case NODE_FLOAT: *value = node->data.float_val; return true;
+        case NODE_BOOL: *value = node->data.bool_val ? 1.0 : 0.0; return true;
+        case NODE_MATH_FUNC:
+            if (node->op_type != TK_MATH_PI && node->op_type != TK_MATH_E) return false;
+            *value = std_math_const(node->op_type);
+            return true;
+        default: return false;
+    }
+}
+
+// math.PI / math.E opérande d'un calcul : remplacé par sa valeur. Seul, il
+// reste un appel (affiché en %g, comme avant).
+static ASTNode* resolveMathConst(ASTNode* node) {
+    if (!node || node->type != NODE_MATH_FUNC ||
+        (node->op_type != TK_MATH_PI && node->op_type != TK_MATH_E)) return node;
+    ASTNode* value = newConstNode(NODE_FLOAT, node);
+    value->data.float_val = std_math_const(node->op_type);
+    return value;
+}
+
+// Vérité d'un littéral en condition (evalBool)
+static bool constTruth(ASTNode* node, bool* truth) {
+    if (!node) return false;
+    switch (node->type) {
+        case NODE_BOOL: *truth = node->data.bool_val; return true;
+        case NODE_INT: *truth = node->data.int_val != 0; return true;
+        case NODE_FLOAT: *truth = fabs(node->data.float_val) > 1e-10; return true;
+        case NODE_STRING: *truth = node->data.str_val && node->data.str_val[0]; return true;
+        case NODE_NULL:
+        case NODE_UNDEFINED:
+        case NODE_NAN: *truth = false; return true;
+        case NODE_INF: *truth = true; return true;
+        default: return false;
+    }
+}
+
+// Un flottant plié doit se comporter comme l'expression d'origine dans
+// evalBool (seuil 1e-10) et ne pas être NaN/inf
+static bool foldableNumber(double value) {
+    return isfinite(value) && (value == 0.0 || fabs(value) > 1e-10);
+}
+
+// Texte d'un littéral dans une concaténation (evalStr)
+static char* constText(ASTNode* node) {
+    if (node->type == NODE_STRING) return str_copy(node->data.str_val);
+    if (node->type == NODE_INT) return numberToString((double)node->data.int_val);
+    if (node->type == NODE_FLOAT) return numberToString(node->data.float_val);
+    return NULL;
+}
+
+static ASTNode* foldBinary(ASTNode* node) {
+    ASTNode* l = node->left;
+    ASTNode* r = node->right;
+    if (!l || !r) return node;
+    
+    // Concaténation de littéraux
+    bool l_str = l->type == NODE_STRING, r_str = r->type == NODE_STRING;
+    if ((node->op_type == TK_CONCAT || (node->op_type == TK_PLUS && (l_str || r_str)))) {
+        char* ls = constText(l);
+        char* rs = ls ? constText(r) : NULL;
+        if (!rs) { free(ls); return node; }
+        size_t ll = strlen(ls), rl = strlen(rs);
+        char* joined = malloc(ll + rl + 1);
+        memcpy(joined, ls, ll);
+        memcpy(joined + ll, rs, rl + 1);
+        free(ls);
+        free(rs);
+        return stringNode(joined, node);
+    }
+    if ((node->op_type == TK_EQ || node->op_type == TK_NEQ) && (l_str || r_str)) {
+        char* ls = constText(l);
+        char* rs = ls ? constText(r) : NULL;
+        if (!rs) { free(ls); return node; }
+        bool equal = strcmp(ls, rs) == 0;
+        free(ls);
+        free(rs);
+        return numberNode((node->op_type == TK_EQ) == equal ? 1.0 : 0.0, node);
+    }
+    
+    // Opérateurs purement numériques seulement : '+' peut devenir une
+    // concaténation et '==' une comparaison de chaînes selon les variables
+    if (node->op_type != TK_PLUS && node->op_type != TK_CONCAT &&
+        node->op_type != TK_EQ && node->op_type != TK_NEQ && node->op_type != TK_IN) {
+        node->left = l = resolveMathConst(l);
+        node->right = r = resolveMathConst(r);
+    }
+    
+    double a, b, v;
+    if (!constNumber(l, &a) || !constNumber(r, &b)) return node;
+    switch (node->op_type) {
+        case TK_PLUS: v = a + b; break;
+        case TK_MINUS: v = a - b; break;
+        case TK_MULT: v = a * b; break;
+        case TK_DIV:
+            if (b == 0.0) return node; // avertissement à l'exécution
+            v = a / b;
+            break;
+        case TK_MOD:
+            if (b == 0.0) return node;
+            v = fmod(a, b);
+            break;
+        case TK_POW: v = pow(a, b); break;
+        case TK_SHL:
+        case TK_SHR:
+            if (b < 0 || b >= 63) return node;
+            v = node->op_type == TK_SHL ? (double)((int64_t)a << (int64_t)b) : (double)((int64_t)a >> (int64_t)b);
+            break;
+        case TK_BIT_AND: v = (double)((int64_t)a & (int64_t)b); break;
+        case TK_BIT_OR: v = (double)((int64_t)a | (int64_t)b); break;
+        case TK_BIT_XOR: v = (double)((int64_t)a ^ (int64_t)b); break;
+        case TK_EQ: v = a == b; break;
+        case TK_NEQ: v = a != b; break;
+        case TK_GT: v = a > b; break;
+        case TK_LT: v = a < b; break;
+        case TK_GTE: v = a >= b; break;
+        case TK_LTE: v = a <= b; break;
+        case TK_AND: v = a != 0.0 && b != 0.0; break;
+        case TK_OR: v = a != 0.0 || b != 0.0; break;
+        default: return node;
+    }
+    return foldableNumber(v) ? numberNode(v, node) : node;
+}
+
+// Superinstructions ([SECTION] SUPERINSTRUCTIONS) : le nœud d'origine est
+// gardé dans fourth, détaché de sa chaîne
+static bool isNumberLiteral(ASTNode* node) {
+    return node && (node->type == NODE_INT || node->type == NODE_FLOAT);
+}
+
+static bool isLocalIdent(ASTNode* node) {
+    return node && node->type == NODE_IDENT && node->data.name;
+}
+
+static ASTNode* fusedNode(NodeType type, ASTNode* origin) {
+    ASTNode* node = newConstNode(type, origin);
+    origin->next = NULL;
+    node->fourth = origin;
+    return node;
+}
+
+static ASTNode* fuseBinary(ASTNode* node) {
+    ASTNode* l = node->left;
+    ASTNode* r = node->right;
+    switch (node->op_type) {
+        case TK_LT: case TK_LTE: case TK_GT: case TK_GTE: case TK_EQ: case TK_NEQ:
+            if (!isLocalIdent(l) || !(isLocalIdent(r) || isNumberLiteral(r))) return node;
+            break;
+        case TK_PLUS:
+            if (isNumberLiteral(l) && isLocalIdent(r)) { ASTNode* t = l; l = r; r = t; } // k + x
+            /* fallthrough */
+        case TK_MINUS:
+            if (!isLocalIdent(l) || !isNumberLiteral(r)) return node;
+            break;
+        default:
+            return node;
+    }
+    bool compare = node->op_type != TK_PLUS && node->op_type != TK_MINUS;
+    ASTNode* fused = fusedNode(compare ? NODE_CMP_LOCALS : NODE_ADD_LOCAL_CONST, node);
+    fused->op_type = node->op_type;
+    fused->left = l;
+    fused->right = r;
+    return fused;
+}
+
+// x = x + k, x = k + x, x = x - k, x += k, x -= k
+static ASTNode* fuseAssign(ASTNode* node) {
+    if (!node->data.name || !node->right) return node;
+    ASTNode* k;
+    TokenKind op;
+    if (node->type == NODE_ASSIGN) {
+        ASTNode* add = node->right;
+        if (add->type != NODE_ADD_LOCAL_CONST || strcmp(add->left->data.name, node->data.name) != 0) return node;
+        node->right = add->fourth; // repli : s = s + 1 reste une concaténation en place
+        k = add->right;
+        op = add->op_type;
+    } else {
+        if (node->op_type != TK_PLUS_ASSIGN && node->op_type != TK_MINUS_ASSIGN) return node;
+        if (!isNumberLiteral(node->right)) return node;
+        k = node->right;
+        op = node->op_type == TK_PLUS_ASSIGN ? TK_PLUS : TK_MINUS;
+    }
+    ASTNode* fused = fusedNode(NODE_INC_LOCAL, node);
+    fused->data.name = node->data.name;
+    fused->sym = nodeSym(node);
+    fused->op_type = op;
+    fused->right = k;
+    return fused;
+}
+
+static ASTNode* foldUnary(ASTNode* node) {
+    ASTNode* operand = node->left;
+    double v;
+    if (constNumber(operand, &v)) {
+        if (node->op_type == TK_MINUS) return numberNode(-v, node);
+        if (node->op_type == TK_NOT) return numberNode(v == 0.0 ? 1.0 : 0.0, node);
+        return node;
+    }
+    if (node->op_type != TK_NOT || !operand) return node;
+    
+    // !(a == b) -> a != b ; !(a != b) -> a == b
+    if (operand->type == NODE_BINARY && (operand->op_type == TK_EQ || operand->op_type == TK_NEQ)) {
+        operand->op_type = operand->op_type == TK_EQ ? TK_NEQ : TK_EQ;
+        return operand;
+    }
+    return node;
+}
+
+// Condition simplifiée pour evalBool : !!x -> x (evalBool(x) vaut
+// evalFloat(x) != 0 pour toute expression non littérale)
+static ASTNode* simplifyCondition(ASTNode* cond) {
+    while (cond && cond->type == NODE_UNARY && cond->op_type == TK_NOT &&
+           cond->left && cond->left->type == NODE_UNARY && cond->left->op_type == TK_NOT) {
+        bool literal;
+        if (constTruth(cond->left->left, &literal)) break;
+        cond = cond->left->left;
+    }
+    return cond;
+}
+
+// Optimise une chaîne d'instructions/arguments liée par ->next ; une
+// instruction élaguée (if (false) sans else) est retirée de la chaîne.
+static ASTNode* optimizeChain(ASTNode* first) {
+    ASTNode* head = NULL;
+    ASTNode** link = &head;
+    for (ASTNode* node = first; node; ) {
+        ASTNode* next = node->next;
+        ASTNode* result = optimizeNode(node);
+        if (result) {
+            *link = result;
+            link = &result->next;
+        }
+        node = next;
+    }
+    *link = NULL;
+    return head;
+}
+
+static ASTNode* optimizeNode(ASTNode* node) {
+    if (!node) return NULL;
+    
+    switch (node->type) {
+        case NODE_FOR:
+            node->data.loop.init = optimizeChain(node->data.loop.init);
+            node->data.loop.condition = simplifyCondition(optimizeChain(node->data.loop.condition));
+            node->data.loop.update = optimizeChain(node->data.loop.update);
+            node->data.loop.body = optimizeChain(node->data.loop.body);
+            return node;
+        case NODE_FOR_IN:
+        case NODE_PARALLEL_FOR:
+            node->data.for_in.iterable = optimizeChain(node->data.for_in.iterable);
+            node->data.for_in.body = optimizeChain(node->data.for_in.body);
+            node->third = optimizeChain(node->third);
+            return node;
+        case NODE_SWITCH:
+            node->data.switch_stmt.expr = optimizeChain(node->data.switch_stmt.expr);
+            node->data.switch_stmt.cases = optimizeChain(node->data.switch_stmt.cases);
+            node->data.switch_stmt.default_case = optimizeChain(node->data.switch_stmt.default_case);
+            return node;
+        case NODE_CASE:
+            node->data.case_stmt.value = optimizeChain(node->data.case_stmt.value);
+            node->data.case_stmt.body = optimizeChain(node->data.case_stmt.body);
+            return node;
+        case NODE_TRY:
+            node->data.try_catch.try_block = optimizeChain(node->data.try_catch.try_block);
+            node->data.try_catch.catch_block = optimizeChain(node->data.try_catch.catch_block);
+            node->data.try_catch.finally_block = optimizeChain(node->data.try_catch.finally_block);
+            return node;
+        case NODE_APPEND:
+            node->data.append_op.list = optimizeChain(node->data.append_op.list);
+            node->data.append_op.value = optimizeChain(node->data.append_op.value);
+            return node;
+        case NODE_PUSH:
+        case NODE_POP:
+            node->data.collection_op.collection = optimizeChain(node->data.collection_op.collection);
+            node->data.collection_op.value = optimizeChain(node->data.collection_op.value);
+            return node;
+        case NODE_CLASS:
+            node->data.class_def.members = optimizeChain(node->data.class_def.members);
+            return node;
+        default:
+            break;
+    }
+    
+    node->left = optimizeChain(node->left);
+    node->right = optimizeChain(node->right);
+    node->third = optimizeChain(node->third);
+    node->fourth = optimizeChain(node->fourth);
+    
+    switch (node->type) {
+        case NODE_BINARY: {
+            ASTNode* folded = foldBinary(node);
+            return folded == node ? fuseBinary(node) : folded;
+        }
+        case NODE_ASSIGN:
+        case NODE_COMPOUND_ASSIGN:
+            return fuseAssign(node);
+        case NODE_UNARY:
+            return foldUnary(node);
+        case NODE_TERNARY: {
+            // Une ternaire n'est jamais une expression string (evalValue la lit
+            // avec evalFloat) : on ne la remplace que par un littéral numérique
+            double cond, value;
+            if (!constNumber(node->left, &cond) || !foldableNumber(cond)) return node;
+            ASTNode* branch = cond != 0.0 ? node->right : node->third;
+            if (!branch || (branch->type != NODE_INT && branch->type != NODE_FLOAT) ||
+                !constNumber(branch, &value)) return node;
+            return branch;
+        }
+        case NODE_IF: {
+            bool truth;
+            node->left = simplifyCondition(node->left);
+            if (!constTruth(node->left, &truth)) return node;
+            return truth ? node->right : node->third;
+        }
+        case NODE_WHILE: {
+            bool truth;
+            node->left = simplifyCondition(node->left);
+            if (constTruth(node->left, &truth) && !truth) return NULL;
+            return node;
+        }
+        default:
+            return node;
+    }
+}
+
+static void optimizeProgram(ASTNode** nodes, int count) {
+    const char* env = getenv("SWIFT_NO_OPT");
+    if (env && env[0] && strcmp(env, "0") != 0) opt_enabled = false;
+    if (!opt_enabled) return;
+    for (int i = 0; i < count; i++) {
+        if (nodes[i]) nodes[i] = optimizeNode(nodes[i]);
+    }
+}
+
+// --dump-ast : arbre après optimisation, une ligne par noeud
+static const char* nodeTypeName(NodeType type) {
+    switch (type) {
+        case NODE_INT: return "Int";
+        case NODE_FLOAT: return "Float";
+        case NODE_STRING: return "String";
+        case NODE_BOOL: return "Bool";
+        case NODE_IDENT: return "Ident";
+        case NODE_NULL: return "Null";
+        case NODE_LIST: return "List";
+        case NODE_MAP: return "Map";
+        case NODE_MAP_ENTRY: return "MapEntry";
+        case NODE_FUNC: return "Func";
+        case NODE_FUNC_CALL: return "Call";
+        case NODE_METHOD_CALL: return "MethodCall";
+        case NODE_LAMBDA: return "Lambda";
+        case NODE_ARRAY_ACCESS: return "Index";
+        case NODE_MEMBER_ACCESS: return "Member";
+        case NODE_BINARY: return "Binary";
+        case NODE_UNARY: return "Unary";
+        case NODE_TERNARY: return "Ternary";
+        case NODE_ASSIGN: return "Assign";
+        case NODE_COMPOUND_ASSIGN: return "CompoundAssign";
+        case NODE_INC_LOCAL: return "IncLocal";
+        case NODE_CMP_LOCALS: return "CmpLocals";
+        case NODE_ADD_LOCAL_CONST: return "AddLocalConst";
+        case NODE_IF: return "If";
+        case NODE_WHILE: return "While";
+        case NODE_FOR: return "For";
+        case NODE_FOR_IN: return "ForIn";
+        case NODE_PARALLEL_FOR: return "ParallelFor";
+        case NODE_SWITCH: return "Switch";
+        case NODE_CASE: return "Case";
+        case NODE_RETURN: return "Return";
+        case NODE_BREAK: return "Break";
+        case NODE_CONTINUE: return "Continue";
+        case NODE_TRY: return "Try";
+        case NODE_VAR_DECL: return "VarDecl";
+        case NODE_CONST_DECL: return "ConstDecl";
+        case NODE_PRINT: return "Print";
+        case NODE_PASS: return "Pass";
+        case NODE_CLASS: return "Class";
+        case NODE_NEW: return "New";
+        case NODE_IMPORT: return "Import";
+        case NODE_BLOCK: return "Block";
+        case NODE_MAIN: return "Main";
+        case NODE_MATH_FUNC: return "Math";
+        default: return NULL;
+    }
+}
+
+static const char* opName(TokenKind op) {
+    switch (op) {
+        case TK_PLUS: return "+";
+        case TK_MINUS: return "-";
+        case TK_MULT: return "*";
+        case TK_DIV: return "/";
+        case TK_MOD: return "%";
+        case TK_POW: return "**";
+        case TK_CONCAT: return "..";
+        case TK_EQ: return "==";
+        case TK_NEQ: return "!=";
+        case TK_GT: return ">";
+        case TK_LT: return "<";
+        case TK_GTE: return ">=";
+        case TK_LTE: return "<=";
+        case TK_AND: return "&&";
+        case TK_OR: return "||";
+        case TK_NOT: return "!";
+        case TK_SHL: return "<<";
+        case TK_SHR: return ">>";
+        case TK_BIT_AND: return "&";
+        case TK_BIT_OR: return "|";
+        case TK_BIT_XOR: return "^";
+        case TK_IN: return "in";
+        default: return NULL;
+    }
+}
+
+static void dumpNode(ASTNode* node, int depth, const char* label);
+
+static void dumpChain(ASTNode* node, int depth, const char* label) {
+    for (; node; node = node->next) dumpNode(node, depth, label);
+}
+
+static void dumpNode(ASTNode* node, int depth, const char* label) {
+    printf("%*s", depth * 2, "");
+    if (label) printf("%s: ", label);
+    const char* name = nodeTypeName(node->type);
+    if (name) printf("%s", name);
+    else printf("Node#%d", (int)node->type);
+    
+    switch (node->type) {
+        case NODE_INT: printf(" %lld", (long long)node->data.int_val); break;
+        case NODE_FLOAT: printf(" %.17g", node->data.float_val); break;
+        case NODE_BOOL: printf(" %s", node->data.bool_val ? "true" : "false"); break;
+        case NODE_STRING: printf(" \"%s\"", node->data.str_val ? node->data.str_val : ""); break;
+        case NODE_INC_LOCAL:
+            printf(" %s", node->data.name);
+            /* fallthrough */
+        case NODE_BINARY:
+        case NODE_UNARY:
+        case NODE_COMPOUND_ASSIGN:
+        case NODE_CMP_LOCALS:
+        case NODE_ADD_LOCAL_CONST: {
+            const char* op = opName(node->op_type);
+            if (op) printf(" %s", op);
+            else printf(" op#%d", (int)node->op_type);
+            break;
+        }
+        case NODE_FOR:
+        case NODE_FOR_IN:
+        case NODE_PARALLEL_FOR:
+        case NODE_SWITCH:
+        case NODE_CASE:
+        case NODE_TRY:
+        case NODE_APPEND:
+        case NODE_PUSH:
+        case NODE_POP:
+        case NODE_CLASS:
+            break;
+        default:
+            if (node->data.name && (node->type == NODE_IDENT || node->type == NODE_FUNC ||
+                                    node->type == NODE_FUNC_CALL || node->type == NODE_METHOD_CALL ||
+                                    node->type == NODE_VAR_DECL || node->type == NODE_CONST_DECL ||
+                                    node->type == NODE_ASSIGN || node->type == NODE_MEMBER_ACCESS)) {
+                printf(" %s", node->data.name);
+            }
+            break;
+    }
+    printf("\n");
+    
+    switch (node->type) {
+        case NODE_FOR:
+            if (node->data.loop.init) dumpChain(node->data.loop.init, depth + 1, "init");
+            if (node->data.loop.condition) dumpChain(node->data.loop.condition, depth + 1, "cond");
+            if (node->data.loop.update) dumpChain(node->data.loop.update, depth + 1, "update");
+            if (node->data.loop.body) dumpChain(node->data.loop.body, depth + 1, "body");
+            return;
+        case NODE_FOR_IN:
+        case NODE_PARALLEL_FOR:
+            if (node->data.for_in.iterable) dumpChain(node->data.for_in.iterable, depth + 1, "in");
+            if (node->third) dumpChain(node->third, depth + 1, "to");
+            if (node->fourth) dumpChain(node->fourth, depth + 1, "reduce");
+            if (node->data.for_in.body) dumpChain(node->data.for_in.body, depth + 1, "body");
+            return;
+        case NODE_SWITCH:
+            if (node->data.switch_stmt.expr) dumpChain(node->data.switch_stmt.expr, depth + 1, "expr");
+            if (node->data.switch_stmt.cases) dumpChain(node->data.switch_stmt.cases, depth + 1, NULL);
+            if (node->data.switch_stmt.default_case) dumpChain(node->data.switch_stmt.default_case, depth + 1, "default");
+            return;
+        case NODE_CASE:
+            if (node->data.case_stmt.value) dumpChain(node->data.case_stmt.value, depth + 1, "value");
+            if (node->data.case_stmt.body) dumpChain(node->data.case_stmt.body, depth + 1, "body");
+            return;
+        case NODE_TRY:
+            if (node->data.try_catch.try_block) dumpChain(node->data.try_catch.try_block, depth + 1, "try");
+            if (node->data.try_catch.catch_block) dumpChain(node->data.try_catch.catch_block, depth + 1, "catch");
+            if (node->data.try_catch.finally_block) dumpChain(node->data.try_catch.finally_block, depth + 1, "finally");
+            return;
+        case NODE_APPEND:
+        case NODE_PUSH:
+        case NODE_POP:
+        case NODE_CLASS:
+            return;
+        case NODE_INC_LOCAL:
+        case NODE_CMP_LOCALS:
+        case NODE_ADD_LOCAL_CONST:
+            // Forme générique (fourth) non affichée
+            if (node->left) dumpChain(node->left, depth + 1, NULL);
+            if (node->right) dumpChain(node->right, depth + 1, NULL);
+            return;
+        default:
+            break;
+    }
+    if (node->left) dumpChain(node->left, depth + 1, NULL);
+    if (node->right) dumpChain(node->right, depth + 1, NULL);
+    if (node->third) dumpChain(node->third, depth + 1, NULL);
+    if (node->fourth) dumpChain(node->fourth, depth + 1, NULL);
+}
+
+static void dumpProgram(ASTNode** nodes, int count) {
+    for (int i = 0; i < count; i++) {
+        if (nodes[i]) dumpNode(nodes[i], 0, NULL);
+    }
+}
+
+// ======================================================
+// [SECTION] ISOLATS ET WORKERS
+// ======================================================
+// spawn(f, args...) exécute f sur un worker du pool (pool.c) et rend aussitôt
+// "future_N" ; 'await future_N' attend le résultat. Chaque worker possède son
+// propre isolat : tout l'état de l'interpréteur est local au thread (ISOLATE),
+// donc aucun verrou sur les variables ni sur le tas. Au démarrage, un worker
+// analyse la même source et enregistre fonctions, classes et imports ; les
+// variables globales du script ne sont pas rejouées. Arguments et résultat
+// traversent d'un isolat à l'autre par copie profonde (Transfer).
+
+// Source du script, partagée par tous les isolats (lecture seule)
+static char* isolate_source = NULL;
+static char* isolate_filename = NULL;
+
+// Tube de réveil de l'isolat : un octet par future terminée
+static ISOLATE int isolate_notify[2] = { -1, -1 };
+
+#define TRANSFER_MAX_DEPTH 256
+
+static int isolateNotifyFd(void) {
+    if (isolate_notify[0] < 0) {
+        if (pipe(isolate_notify) != 0) {
+            fprintf(stderr, "%s[FATAL]%s Cannot create isolate pipe\n", COLOR_RED, COLOR_RESET);
+            exit(1);
+        }
+        fcntl(isolate_notify[0], F_SETFL, O_NONBLOCK);
+        fcntl(isolate_notify[1], F_SETFL, O_NONBLOCK);
+    }
+    return isolate_notify[1];
+}
+
+// Attend un réveil de l'isolat (future terminée, canal prêt) ou timeout_ms
+// (-1 : sans limite). Les appelants revérifient leur condition au retour.
+static void isolateWait(int timeout_ms) {
+    isolateNotifyFd();
+    struct pollfd pfd = { isolate_notify[0], POLLIN, 0 };
+    if (pool_worker_index() >= 0) {
+        // Worker : aide le pool (le job attendu est peut-être en file)
+        if (pool_run_one()) return;
+        poll(&pfd, 1, timeout_ms >= 0 && timeout_ms < 1 ? timeout_ms : 1);
+    } else {
+        // Le tube est commun aux tâches de l'isolat : une autre a pu le
+        // vider, d'où un délai borné quand d'autres tâches attendent
+        if (sched_task_count() > 0 && (timeout_ms < 0 || timeout_ms > 10)) timeout_ms = 10;
+        sched_poll(&pfd, 1, timeout_ms);
+    }
+    char buf[64];
+    while (read(isolate_notify[0], buf, sizeof(buf)) > 0) {}
+}
+
+static ChanRef* newChanRef(Channel* chan) {
+    ChanRef* ref = calloc(1, sizeof(ChanRef));
+    if (!ref) { fprintf(stderr, "%s[FATAL]%s Out of memory (channel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    ref->chan = chan;
+    heapInsert(&ref->gc, HEAP_CHAN, sizeof(ChanRef));
+    return ref;
+}
+
+static void freeTransfer(Transfer* t) {
+    if (t->chan) chan_release(t->chan);
+    for (int i = 0; i < t->count; i++) freeTransfer(&t->items[i]);
+    free(t->items);
+    free(t->data);
+    memset(t, 0, sizeof(Transfer));
+}
+
+static Transfer* transferItems(int count) {
+    Transfer* items = calloc(count ? count : 1, sizeof(Transfer));
+    if (!items) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    return items;
+}
+
+// Copie autonome de v ; les objets, tâches et futures ne quittent pas leur isolat
+static void transferOut(EvalValue v, Transfer* out, ASTNode* node, int depth) {
+    memset(out, 0, sizeof(Transfer));
+    if (depth > TRANSFER_MAX_DEPTH) runtime_error(node, "Value too deeply nested (or cyclic) to be sent to a worker");
+    if (!v.is_string) {
+        out->kind = v.is_int ? XFER_BOOL : XFER_NUM;
+        out->num = v.num;
+        return;
+    }
+    HeapHeader* h = heapFromId(v.str);
+    if (!h) {
+        out->kind = XFER_STR;
+        out->len = rstr_len(v.str);
+        out->data = malloc(out->len + 1);
+        if (!out->data) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        memcpy(out->data, v.str, out->len + 1);
+        return;
+    }
+    switch (h->kind) {
+        case HEAP_LIST: {
+            List* list = (List*)h;
+            out->kind = XFER_LIST;
+            out->items = transferItems(list->count);
+            out->count = list->count;
+            for (int i = 0; i < list->count; i++) transferOut(list->items[i], &out->items[i], node, depth + 1);
+            return;
+        }
+        case HEAP_MAP: {
+            Map* map = (Map*)h;
+            out->kind = XFER_MAP;
+            out->items = transferItems(map->count * 2);
+            for (int i = 0; i < map->entry_count; i++) {
+                MapEntry* e = &map->entries[i];
+                if (e->deleted) continue;
+                transferOut(e->key, &out->items[out->count++], node, depth + 1);
+                transferOut(e->value, &out->items[out->count++], node, depth + 1);
+            }
+            return;
+        }
+        case HEAP_ARRAY: {
+            TypedArray* arr = (TypedArray*)h;
+            out->kind = arr->is_int ? XFER_I64 : XFER_F64;
+            out->len = (size_t)arr->count * 8;
+            out->data = malloc(out->len ? out->len : 1);
+            if (!out->data) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+            memcpy(out->data, arr->data.raw, out->len);
+            return;
+        }
+        case HEAP_CHAN:
+            out->kind = XFER_CHAN;
+            out->chan = ((ChanRef*)h)->chan;
+            chan_retain(out->chan);
+            return;
+        default:
+            runtime_error(node, "Cannot send '%s' to a worker (objects, tasks, futures and processes stay in their isolate)", v.str);
+    }
+}
+
+// Reconstruit la valeur sur le tas de l'isolat courant (nouvelle référence)
+static EvalValue transferIn(Transfer* t) {
+    EvalValue v = { false, false, NULL, t->num };
+    switch (t->kind) {
+        case XFER_NUM:
+            break;
+        case XFER_BOOL:
+            v.is_int = true;
+            break;
+        case XFER_STR:
+            v.is_string = true;
+            v.str = rstr_new(t->data, t->len);
+            break;
+        case XFER_LIST: {
+            List* list = newList(t->count);
+            gcPushRoot(&list->gc);
+            for (int i = 0; i < t->count; i++) listPush(list, transferIn(&t->items[i]));
+            gcPopRoots(1);
+            v.is_string = true;
+            v.str = heapIdStr(&list->gc);
+            break;
+        }
+        case XFER_MAP: {
+            Map* map = newMap();
+            gcPushRoot(&map->gc);
+            for (int i = 0; i + 1 < t->count; i += 2) {
+                EvalValue key = transferIn(&t->items[i]);
+                mapSet(map, key, transferIn(&t->items[i + 1]));
+            }
+            gcPopRoots(1);
+            v.is_string = true;
+            v.str = heapIdStr(&map->gc);
+            break;
+        }
+        case XFER_F64:
+        case XFER_I64: {
+            TypedArray* arr = newArray(t->kind == XFER_I64, (int)(t->len / 8));
+            memcpy(arr->data.raw, t->data, t->len);
+            v.is_string = true;
+            v.str = heapIdStr(&arr->gc);
+            break;
+        }
+        case XFER_CHAN: {
+            chan_retain(t->chan);
+            v.is_string = true;
+            v.str = heapIdStr(&newChanRef(t->chan)->gc);
+            break;
+        }
+    }
+    return v;
+}
+
+static void releaseFuture(Future* future) {
+    if (__atomic_sub_fetch(&future->refs, 1, __ATOMIC_ACQ_REL) > 0) return;
+    if (future->kind != JOB_LOOP) {
+        for (int i = 0; i < future->arg_count; i++) freeTransfer(&future->args[i]);
+        free(future->args);
+    }
+    freeTransfer(&future->items);
+    freeTransfer(&future->result);
+    free(future);
+}
+
+static FutureRef* futureFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_FUTURE ? (FutureRef*)h : NULL;
+}
+
+// Définitions de premier niveau (fonctions, classes, async) ; with_imports :
+// isolat d'un worker, qui rejoue aussi les imports
+static void registerDefinitions(ASTNode** nodes, int count, bool with_imports) {
+    for (int i = 0; i < count; i++) {
+        if (!nodes[i]) continue;
+        if (nodes[i]->type == NODE_FUNC) {
+            int param_count = 0;
+            ASTNode* param = nodes[i]->left;
+            while (param) {
+                param_count++;
+                param = param->right;
+            }
+            registerFunction(nodes[i]->data.name, nodes[i]->left, nodes[i]->right, param_count);
+        } else if (nodes[i]->type == NODE_CLASS) {
+            execute(nodes[i]); // Enregistrement des classes
+        } else if (nodes[i]->type == NODE_ASYNC) {
+            execute(nodes[i]); // 'async func' : enregistrée et marquée
+        } else if (with_imports && nodes[i]->type == NODE_IMPORT) {
+            execute(nodes[i]);
+        }
+    }
+}
+
+// Création de l'isolat d'un worker (pool_start)
+static void workerInit(int index) {
+    (void)index;
+    initIsolateStorage();
+    parser_set_quiet(true);
+    current_exec_filename = isolate_filename;
+    initWorkingDir(isolate_filename);
+    init_io_module();
+    int count = 0;
+    ASTNode** nodes = parse(isolate_source, &count);
+    if (!nodes) {
+        fprintf(stderr, "%s[FATAL]%s Worker cannot load '%s'\n", COLOR_RED, COLOR_RESET, isolate_filename);
+        exit(1);
+    }
+    optimizeProgram(nodes, count);
+    sched_set_hooks(saveTaskContext, restoreTaskContext);
+    registerDefinitions(nodes, count, true);
+}
+
+static Future* newFuture(JobKind kind) {
+    Future* future = calloc(1, sizeof(Future));
+    if (!future) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    future->kind = kind;
+    future->refs = 2; // isolat demandeur + worker
+    future->notify_fd = isolateNotifyFd();
+    return future;
+}
+
+// Démarre le pool au premier job (SWIFT_WORKERS, sinon un par cœur)
+static int ensurePool(ASTNode* node) {
+    if (pool_size() == 0) {
+        const char* env = getenv("SWIFT_WORKERS");
+        if (!pool_start(env ? atoi(env) : 0, workerInit)) runtime_error(node, "Cannot start worker pool");
+    }
+    return pool_size();
+}
+
+// Fonction nommée transmise à un worker (spawn, pmap) : les lambdas n'existent
+// que dans l'isolat qui les a créées
+static Function* namedFunction(ASTNode* node, ASTNode* arg, const char* what) {
+    if (!arg) runtime_error(node, "%s expects a function", what);
+    if (arg->type == NODE_LAMBDA) runtime_error(node, "%s expects a named function (lambdas stay in their isolate)", what);
+    Function* func = resolveCallable(arg);
+    if (strncmp(func->name, "__lambda_", 9) == 0) {
+        runtime_error(node, "%s expects a named function (lambdas stay in their isolate)", what);
+    }
+    return func;
+}
+
+static Function* workerFunction(Future* future) {
+    Function* func = findFunctionSym(intern(future->func_name));
+    if (!func) {
+        fprintf(stderr, "%s[RUNTIME ERROR] %s: %sFunction '%s' not found in worker\n",
+                COLOR_RED, current_exec_filename, COLOR_RESET, future->func_name);
+        exit(1);
+    }
+    return func;
+}
+
+static void runCallJob(Future* future) {
+    Function* func = workerFunction(future);
+    EvalValue* values = calloc(future->arg_count ? future->arg_count : 1, sizeof(EvalValue));
+    if (!values) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    int rooted = 0;
+    for (int i = 0; i < future->arg_count; i++) {
+        values[i] = transferIn(&future->args[i]);
+        HeapHeader* h = values[i].is_string ? heapFromId(values[i].str) : NULL;
+        if (h) {
+            gcPushRoot(h);
+            rooted++;
+        }
+    }
+    callFunctionValues(func, values, future->arg_count);
+    gcPopRoots(rooted);
+    free(values);
+    
+    EvalValue result = { false, false, NULL, func->return_value };
+    if (func->return_string) {
+        result.is_string = true;
+        result.str = func->return_string;
+    }
+    transferOut(result, &future->result, func->body, 0);
+}
+
+static void runMapJob(Future* future);
+static void runLoopJob(Future* future);
+
+// Job du pool : exécute le travail dans l'isolat du worker courant
+static void futureRun(void* arg) {
+    Future* future = arg;
+    switch (future->kind) {
+        case JOB_CALL: runCallJob(future); break;
+        case JOB_MAP: runMapJob(future); break;
+        case JOB_LOOP: runLoopJob(future); break;
+    }
+    
+    __atomic_store_n(&future->done, 1, __ATOMIC_RELEASE);
+    char byte = 1;
+    ssize_t written = write(future->notify_fd, &byte, 1); // tube plein : réveil déjà en attente
+    (void)written;
+    releaseFuture(future);
+}
+
+// spawn(f, args...) : fonction nommée du script, exécutée par un worker
+static Function* callSpawn(ASTNode* node, ASTNode* args) {
+    Function* func = namedFunction(node, args, "spawn");
+    
+    Future* future = newFuture(JOB_CALL);
+    strncpy(future->func_name, func->name, sizeof(future->func_name) - 1);
+    for (ASTNode* arg = args->next; arg; arg = arg->next) future->arg_count++;
+    future->args = transferItems(future->arg_count);
+    int i = 0;
+    for (ASTNode* arg = args->next; arg; arg = arg->next) {
+        EvalValue v = evalValue(arg);
+        transferOut(v, &future->args[i++], arg, 0);
+        rstr_release(v.str);
+    }
+    ensurePool(node);
+    
+    FutureRef* ref = calloc(1, sizeof(FutureRef));
+    if (!ref) { fprintf(stderr, "%s[FATAL]%s Out of memory (spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    ref->future = future;
+    heapInsert(&ref->gc, HEAP_FUTURE, sizeof(FutureRef));
+    pool_submit(futureRun, future);
+    
+    EvalValue id = { true, false, heapIdStr(&ref->gc), 0.0 };
+    setNativeResult(id);
+    return &native_result;
+}
+
+// Attend la future ; résultat comme evalAwait (chaîne allouée ou *num)
+static char* awaitFuture(FutureRef* ref, double* num) {
+    Future* future = ref->future;
+    gcPushRoot(&ref->gc);
+    while (!__atomic_load_n(&future->done, __ATOMIC_ACQUIRE)) isolateWait(-1);
+    gcPopRoots(1);
+    
+    EvalValue v = transferIn(&future->result);
+    if (!v.is_string) {
+        *num = v.num;
+        return NULL;
+    }
+    char* result = str_copy(v.str);
+    rstr_release(v.str);
+    return result;
+}
+
+static Function* callChan(ASTNode* node, ASTNode* args);
+static Function* callSelect(ASTNode* node, ASTNode* args);
+
+static Function* callIsolateBuiltin(ASTNode* node, ASTNode* args) {
+    const char* name = node->data.name;
+    if (strcmp(name, "spawn") == 0) return callSpawn(node, args);
+    if (strcmp(name, "chan") == 0) return callChan(node, args);
+    if (strcmp(name, "select") == 0) return callSelect(node, args);
+    return NULL;
+}
+
+// ======================================================
+// [SECTION] CANAUX
+// ======================================================
+// chan(n) crée un canal borné à n valeurs (chan.c) et rend "chan_N". Une
+// valeur envoyée est copiée (Transfer) : le récepteur, tâche du même isolat
+// ou worker, reçoit sa propre copie et rien n'est partagé. c.send(v) attend
+// une place, c.recv() une valeur ("null" une fois le canal fermé et vidé) ;
+// l'attente cède la main aux autres tâches, ou aide le pool sur un worker.
+// c.try_send(v) n'attend pas : 1 si la valeur est passée, 0 si le canal est
+// plein ou fermé.
+// select([c1, c2...], timeout) reçoit sur le premier canal prêt et rend
+// [index, valeur], ou [-1, "null"] si tous sont fermés ou le délai écoulé.
+
+static ChanRef* chanFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_CHAN ? (ChanRef*)h : NULL;
+}
+
+static void dropTransfer(void* item) {
+    freeTransfer(item);
+    free(item);
+}
+
+static Transfer* chanItem(EvalValue v, ASTNode* node) {
+    Transfer* item = malloc(sizeof(Transfer));
+    if (!item) { fprintf(stderr, "%s[FATAL]%s Out of memory (channel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    transferOut(v, item, node, 0);
+    return item;
+}
+
+static void chanSend(ChanRef* ref, EvalValue v, ASTNode* node) {
+    Transfer* item = chanItem(v, node);
+    ChanStatus status = chan_try_send(ref->chan, item);
+    if (status == CHAN_FULL) {
+        gcPushRoot(&ref->gc);
+        int fd = isolateNotifyFd();
+        chan_watch(ref->chan, fd);
+        while ((status = chan_try_send(ref->chan, item)) == CHAN_FULL) isolateWait(-1);
+        chan_unwatch(ref->chan, fd);
+        gcPopRoots(1);
+    }
+    if (status == CHAN_CLOSED) {
+        dropTransfer(item);
+        runtime_error(node, "Send on a closed channel");
+    }
+}
+
+// Faux quand le canal est fermé et vide
+static bool chanRecv(ChanRef* ref, EvalValue* out) {
+    void* item = NULL;
+    ChanStatus status = chan_try_recv(ref->chan, &item);
+    if (status == CHAN_EMPTY) {
+        gcPushRoot(&ref->gc);
+        int fd = isolateNotifyFd();
+        chan_watch(ref->chan, fd);
+        while ((status = chan_try_recv(ref->chan, &item)) == CHAN_EMPTY) isolateWait(-1);
+        chan_unwatch(ref->chan, fd);
+        gcPopRoots(1);
+    }
+    if (status == CHAN_CLOSED) return false;
+    *out = transferIn(item);
+    dropTransfer(item);
+    return true;
+}
+
+static EvalValue nullValue(void) {
+    EvalValue v = { true, false, rstr_from("null"), 0.0 };
+    return v;
+}
+
+static Function* callChan(ASTNode* node, ASTNode* args) {
+    if (args && args->next) runtime_error(node, "chan expects at most one argument (capacity)");
+    int capacity = args ? (int)evalFloat(args) : 1;
+    if (capacity < 1) capacity = 1; // chan(0) : une place, pas de rendez-vous
+    ChanRef* ref = newChanRef(chan_new(capacity, dropTransfer));
+    EvalValue id = { true, false, heapIdStr(&ref->gc), 0.0 };
+    setNativeResult(id);
+    return &native_result;
+}
+
+static Function* callChanMethod(ASTNode* node, ChanRef* ref) {
+    const char* name = node->data.name;
+    EvalValue result = { false, false, NULL, 0.0 };
+    
+    gcPushRoot(&ref->gc);
+    if (strcmp(name, "send") == 0) {
+        for (ASTNode* arg = node->right; arg; arg = arg->next) {
+            EvalValue v = evalValue(arg);
+            chanSend(ref, v, arg);
+            rstr_release(v.str);
+        }
+    } else if (strcmp(name, "try_send") == 0) {
+        if (!node->right || node->right->next) runtime_error(node, "try_send expects one value");
+        EvalValue v = evalValue(node->right);
+        Transfer* item = chanItem(v, node->right);
+        rstr_release(v.str);
+        bool sent = chan_try_send(ref->chan, item) == CHAN_OK;
+        if (!sent) dropTransfer(item);
+        result.is_int = true;
+        result.num = sent ? 1.0 : 0.0;
+    } else if (strcmp(name, "recv") == 0) {
+        if (!chanRecv(ref, &result)) result = nullValue();
+    } else if (strcmp(name, "close") == 0) {
+        chan_close(ref->chan);
+    } else if (strcmp(name, "closed") == 0) {
+        result.is_int = true;
+        result.num = chan_closed(ref->chan) ? 1.0 : 0.0;
+    } else if (strcmp(name, "len") == 0) {
+        result.num = chan_len(ref->chan);
+    } else if (strcmp(name, "cap") == 0) {
+        result.num = chan_cap(ref->chan);
+    } else {
+        runtime_error(node, "Unknown channel method '%s'", name);
+    }
+    gcPopRoots(1);
+    
+    setNativeResult(result);
+    return &native_result;
+}
+
+static Function* callSelect(ASTNode* node, ASTNode* args) {
+    char* id = args ? evalStr(args) : NULL;
+    List* list = id ? listFromId(id) : NULL;
+    rstr_release(id);
+    if (!list) runtime_error(node, "select expects a list of channels");
+    double timeout = args->next ? evalFloat(args->next) : -1.0;
+    
+    // Canaux retenus : la liste peut changer pendant l'attente
+    int n = list->count;
+    Channel** chans = malloc((n ? n : 1) * sizeof(Channel*));
+    if (!chans) { fprintf(stderr, "%s[FATAL]%s Out of memory (select)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    for (int i = 0; i < n; i++) {
+        ChanRef* ref = list->items[i].is_string ? chanFromId(list->items[i].str) : NULL;
+        if (!ref) {
+            for (int k = 0; k < i; k++) chan_release(chans[k]);
+            free(chans);
+            runtime_error(node, "select: element %d is not a channel", i);
+        }
+        chans[i] = ref->chan;
+        chan_retain(chans[i]);
+    }
+    
+    static ISOLATE unsigned select_turn = 0; // premier canal essayé : tourne à chaque appel
+    unsigned start = select_turn++;
+    double deadline = timeout >= 0 ? std_time_perf() + timeout : -1.0;
+    int index = -1;
+    void* item = NULL;
+    int fd = -1;
+    for (;;) {
+        int closed = 0;
+        for (int k = 0; k < n && index < 0; k++) {
+            int i = (int)((start + (unsigned)k) % (unsigned)n);
+            ChanStatus status = chan_try_recv(chans[i], &item);
+            if (status == CHAN_OK) index = i;
+            else if (status == CHAN_CLOSED) closed++;
+        }
+        if (index >= 0 || closed == n) break;
+        if (fd < 0) {
+            // Inscription, puis un second passage avant d'attendre
+            fd = isolateNotifyFd();
+            for (int i = 0; i < n; i++) chan_watch(chans[i], fd);
+            continue;
+        }
+        int wait_ms = -1;
+        if (deadline >= 0) {
+            double left = deadline - std_time_perf();
+            if (left <= 0) break;
+            wait_ms = (int)(left * 1000.0) + 1;
+        }
+        isolateWait(wait_ms);
+    }
+    for (int i = 0; i < n; i++) {
+        if (fd >= 0) chan_unwatch(chans[i], fd);
+        chan_release(chans[i]);
+    }
+    free(chans);
+    
+    List* pair = newList(2);
+    gcPushRoot(&pair->gc);
+    EvalValue which = { false, false, NULL, (double)index };
+    listPush(pair, which);
+    if (index >= 0) {
+        listPush(pair, transferIn(item));
+        dropTransfer(item);
+    } else {
+        listPush(pair, nullValue());
+    }
+    gcPopRoots(1);
+    setNativeResult(listValue(pair));
+    return &native_result;
+}
+
+// for v in canal : reçoit jusqu'à la fermeture du canal
+static void executeForInChan(ASTNode* node, ChanRef* ref) {
+    int slot = newLoopVar(node->data.for_in.var_name, true);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
+    }
+    gcPushRoot(&ref->gc);
+    EvalValue v;
+    while (chanRecv(ref, &v)) {
+        storeValue(&vars[slot], v);
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    gcPopRoots(1);
+    removeVars(slot, 1);
+}
+
+// ======================================================
+// [SECTION] PROCESSUS
+// ======================================================
+// sys.spawn(argv, {env, cwd, stdin, limit}) lance argv[0], cherché dans le
+// PATH, sans passer par un shell (une chaîne au lieu d'une liste est passée
+// à /bin/sh -c), et rend "proc_N". stdout et stderr sont
+// capturés ; chaque attente cède la main aux autres tâches de l'isolat, qui
+// peuvent ainsi conduire plusieurs enfants à la fois. env complète
+// l'environnement courant ; stdin est envoyé à l'enfant puis fermé (sans
+// stdin, l'entrée est héritée) ; limit retarde le lancement tant que
+// l'isolat a déjà limit enfants en cours.
+// p.wait() : code de sortie (128 + signal) ; p.line() : ligne suivante de
+// stdout, "null" à la fin ; p.stdout(), p.stderr() : sortie pas encore lue,
+// une fois le processus terminé ; p.pid(), p.running(), p.kill([signal]).
+// for line in p lit stdout ligne à ligne ; await p rend {code, stdout, stderr}.
+
+extern char** environ;
+
+static ProcRef* procFromId(const char* id) {
+    HeapHeader* h = heapFromId(id);
+    return h && h->kind == HEAP_PROC ? (ProcRef*)h : NULL;
+}
+
+// Une attente sur les tubes de tous les enfants de l'isolat
+static void procWaitStep(void) {
+    int count, timeout;
+    struct pollfd* fds = sys_proc_pollfds(&count, &timeout);
+    if (count > 0 || timeout >= 0) sched_poll(fds, count, timeout);
+    free(fds);
+    sys_proc_progress();
+}
+
+static void procWaitDone(ProcRef* ref) {
+    gcPushRoot(&ref->gc);
+    sys_proc_progress();
+    while (!sys_proc_done(ref->proc)) procWaitStep();
+    gcPopRoots(1);
+}
+
+// Ligne suivante de stdout (nouvelle référence) ; faux à la fin du flux
+static bool procNextLine(ProcRef* ref, EvalValue* line) {
+    size_t len;
+    const char* text;
+    while (!(text = sys_proc_line(ref->proc, &len))) {
+        if (sys_proc_eof(ref->proc)) return false;
+        procWaitStep();
+    }
+    line->is_string = true;
+    line->is_int = false;
+    line->str = rstr_new(text, len);
+    return true;
+}
+
+// Environnement courant complété par la map env ("CLE=valeur", alloués)
+static char** procEnv(ASTNode* node, ASTNode* env_opt) {
+    char* id = evalStr(env_opt);
+    Map* map = mapFromId(id);
+    if (!map) runtime_error(node, "sys.spawn: env expects a map");
+    int inherited = 0;
+    while (environ[inherited]) inherited++;
+    char** envp = calloc(inherited + map->count + 1, sizeof(char*));
+    if (!envp) { fprintf(stderr, "%s[FATAL]%s Out of memory (sys.spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    int count = 0;
+    for (int i = 0; i < inherited; i++) envp[count++] = str_copy(environ[i]);
+    for (int i = 0; i < map->entry_count; i++) {
+        MapEntry* e = &map->entries[i];
+        if (e->deleted) continue;
+        char* key = appendDisplay(rstr_new("", 0), e->key, 0);
+        char* entry = appendDisplay(rstr_append(rstr_new(key, rstr_len(key)), "=", 1), e->value, 0);
+        size_t prefix = rstr_len(key) + 1;
+        int k = 0;
+        while (k < count && strncmp(envp[k], entry, prefix) != 0) k++;
+        if (k < count) free(envp[k]);
+        else count++;
+        envp[k] = str_copy(entry);
+        rstr_release(key);
+        rstr_release(entry);
+    }
+    rstr_release(id);
+    return envp;
+}
+
+// Options communes à sys.spawn et sys.run_all
+typedef struct {
+    char** envp;
+    char* cwd;
+    char* input;
+} SpawnOptions;
+
+static void spawnOptions(ASTNode* node, SpawnOptions* opts) {
+    ASTNode* env_opt = findOption(node->right, "env");
+    ASTNode* cwd_opt = findOption(node->right, "cwd");
+    ASTNode* stdin_opt = findOption(node->right, "stdin");
+    opts->envp = env_opt ? procEnv(node, env_opt) : NULL;
+    opts->cwd = cwd_opt ? evalString(cwd_opt) : NULL;
+    opts->input = stdin_opt ? evalStr(stdin_opt) : NULL;
+}
+
+static void freeSpawnOptions(SpawnOptions* opts) {
+    if (opts->envp) {
+        for (int i = 0; opts->envp[i]; i++) free(opts->envp[i]);
+        free(opts->envp);
+    }
+    free(opts->cwd);
+    rstr_release(opts->input);
+}
+
+// Commande : liste [programme, arguments...], ou chaîne passée à /bin/sh -c
+static SysProc* spawnCommand(ASTNode* node, EvalValue command, SpawnOptions* opts) {
+    List* args = command.is_string ? listFromId(command.str) : NULL;
+    if (args && args->count == 0) runtime_error(node, "Empty command list");
+    int argc = args ? args->count : 3;
+    char** argv = calloc(argc + 1, sizeof(char*));
+    if (!argv) { fprintf(stderr, "%s[FATAL]%s Out of memory (sys.spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    if (args) {
+        for (int i = 0; i < argc; i++) argv[i] = appendDisplay(rstr_new("", 0), args->items[i], 0);
+    } else {
+        argv[0] = rstr_from("/bin/sh");
+        argv[1] = rstr_from("-c");
+        argv[2] = appendDisplay(rstr_new("", 0), command, 0);
+    }
+    SysProc* proc = sys_proc_spawn(argv, opts->envp, opts->cwd, opts->input, opts->input ? rstr_len(opts->input) : 0);
+    for (int i = 0; i < argc; i++) rstr_release(argv[i]);
+    free(argv);
+    return proc;
+}
+
+static char* evalSysSpawn(ASTNode* node) {
+    EvalValue command = evalValue(node->left);
+    HeapHeader* h = command.is_string ? heapFromId(command.str) : NULL;
+    if (h) gcPushRoot(h);
+    SpawnOptions opts;
+    spawnOptions(node, &opts);
+    ASTNode* limit_opt = findOption(node->right, "limit");
+    int limit = limit_opt ? (int)evalFloat(limit_opt) : 0;
+    
+    while (limit > 0 && sys_proc_running() >= limit) procWaitStep();
+    SysProc* proc = spawnCommand(node, command, &opts);
+    freeSpawnOptions(&opts);
+    if (h) gcPopRoots(1);
+    rstr_release(command.str);
+    
+    ProcRef* ref = calloc(1, sizeof(ProcRef));
+    if (!ref) { fprintf(stderr, "%s[FATAL]%s Out of memory (sys.spawn)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    ref->proc = proc;
+    heapInsert(&ref->gc, HEAP_PROC, sizeof(ProcRef));
+    return heapIdStr(&ref->gc);
+}
+
+static void mapSetNamed(Map* map, const char* key, EvalValue value) {
+    EvalValue k = { true, false, rstr_from(key), 0.0 };
+    mapSet(map, k, value);
+}
+
+// sys.run_all(commandes, {jobs, fail_fast, env, cwd}) : au plus 'jobs'
+// commandes en cours (un par cœur par défaut), comme make -j. Rend, dans
+// l'ordre des commandes, {code, stdout, stderr, wall, cpu, skipped}.
+// fail_fast : au premier code non nul, plus aucun lancement et les commandes
+// en cours reçoivent SIGTERM ; celles jamais lancées ont skipped vrai et
+// code -1.
+static char* evalSysRunAll(ASTNode* node) {
+    char* id = evalStr(node->left);
+    List* commands = listFromId(id);
+    if (!commands) runtime_error(node, "sys.run_all expects a list of commands");
+    gcPushRoot(&commands->gc);
+    rstr_release(id);
+    
+    SpawnOptions opts;
+    spawnOptions(node, &opts);
+    ASTNode* jobs_opt = findOption(node->right, "jobs");
+    ASTNode* fail_opt = findOption(node->right, "fail_fast");
+    int jobs = jobs_opt ? (int)evalFloat(jobs_opt) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs < 1) jobs = 1;
+    bool fail_fast = fail_opt ? evalBool(fail_opt) : false;
+    
+    int count = commands->count;
+    SysProc** procs = calloc(count ? count : 1, sizeof(SysProc*));
+    bool* finished = calloc(count ? count : 1, sizeof(bool));
+    if (!procs || !finished) { fprintf(stderr, "%s[FATAL]%s Out of memory (sys.run_all)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    int next = 0, active = 0;
+    bool failed = false;
+    while ((next < count && !failed) || active > 0) {
+        while (next < count && !failed && active < jobs) {
+            procs[next] = spawnCommand(node, commands->items[next], &opts);
+            next++;
+            active++;
+        }
+        sys_proc_progress();
+        bool progressed = false;
+        for (int i = 0; i < next; i++) {
+            if (finished[i] || !sys_proc_done(procs[i])) continue;
+            finished[i] = true;
+            progressed = true;
+            active--;
+            if (fail_fast && !failed && sys_proc_status(procs[i]) != 0) {
+                failed = true;
+                for (int k = 0; k < next; k++) {
+                    if (!finished[k]) sys_proc_kill(procs[k], SIGTERM);
                 }
             }
         }
+        if (!progressed && active > 0) procWaitStep();
+    }
+    freeSpawnOptions(&opts);
+    
+    List* results = newList(count);
+    gcPushRoot(&results->gc);
+    for (int i = 0; i < count; i++) {
+        Map* result = newMap();
+        EvalValue entry = { true, false, heapIdStr(&result->gc), 0.0 };
+        listPush(results, entry);
+        SysProc* proc = procs[i];
+        EvalValue code = { false, false, NULL, proc ? (double)sys_proc_status(proc) : -1.0 };
+        EvalValue wall = { false, false, NULL, proc ? sys_proc_wall(proc) : 0.0 };
+        EvalValue cpu = { false, false, NULL, proc ? sys_proc_cpu(proc) : 0.0 };
+        EvalValue skipped = { false, true, NULL, proc ? 0.0 : 1.0 };
+        size_t len = 0;
+        const char* out = proc ? sys_proc_output(proc, false, &len) : "";
+        EvalValue out_value = { true, false, rstr_new(out, len), 0.0 };
+        const char* err = proc ? sys_proc_output(proc, true, &len) : "";
+        EvalValue err_value = { true, false, rstr_new(err, proc ? len : 0), 0.0 };
+        mapSetNamed(result, "code", code);
+        mapSetNamed(result, "stdout", out_value);
+        mapSetNamed(result, "stderr", err_value);
+        mapSetNamed(result, "wall", wall);
+        mapSetNamed(result, "cpu", cpu);
+        mapSetNamed(result, "skipped", skipped);
+        if (proc) sys_proc_release(proc);
+    }
+    gcPopRoots(2);
+    free(procs);
+    free(finished);
+    return heapIdStr(&results->gc);
+}
+
+static EvalValue procOutput(ProcRef* ref, bool err) {
+    procWaitDone(ref);
+    size_t len;
+    const char* out = sys_proc_output(ref->proc, err, &len);
+    EvalValue v = { true, false, rstr_new(out, len), 0.0 };
+    return v;
+}
+
+static Function* callProcMethod(ASTNode* node, ProcRef* ref) {
+    const char* name = node->data.name;
+    ASTNode* args = node->right;
+    EvalValue result = { false, false, NULL, 0.0 };
+    
+    gcPushRoot(&ref->gc);
+    sys_proc_progress();
+    if (strcmp(name, "wait") == 0) {
+        procWaitDone(ref);
+        result.num = sys_proc_status(ref->proc);
+    } else if (strcmp(name, "line") == 0) {
+        if (!procNextLine(ref, &result)) result = nullValue();
+    } else if (strcmp(name, "stdout") == 0 || strcmp(name, "stderr") == 0) {
+        result = procOutput(ref, name[3] == 'e');
+    } else if (strcmp(name, "pid") == 0) {
+        result.num = sys_proc_pid(ref->proc);
+    } else if (strcmp(name, "running") == 0) {
+        result.is_int = true;
+        result.num = !sys_proc_done(ref->proc);
+    } else if (strcmp(name, "kill") == 0) {
+        result.is_int = true;
+        result.num = sys_proc_kill(ref->proc, args ? (int)evalFloat(args) : SIGTERM);
+    } else {
+        runtime_error(node, "Unknown process method '%s'", name);
+    }
+    gcPopRoots(1);
+    
+    setNativeResult(result);
+    return &native_result;
+}
+
+// for line in p : lignes de stdout au fil de leur arrivée
+static void executeForInProc(ASTNode* node, ProcRef* ref) {
+    int slot = newLoopVar(node->data.for_in.var_name, true);
+    if (slot < 0) {
+        runtime_error(node, "Too many variables");
+        return;
     }
-    break;
+    gcPushRoot(&ref->gc);
+    EvalValue line;
+    while (procNextLine(ref, &line)) {
+        storeValue(&vars[slot], line);
+        
+        execute(node->data.for_in.body);
+        releaseScopeVars(slot + 1, scope_level);
+        
+        if (current_function && current_function->has_returned) break;
+    }
+    gcPopRoots(1);
+    removeVars(slot, 1);
 }
-   
 
-    // --- CONTROL FLOW (IF / ELIF / ELSE) ---
-    case NODE_IF: {
-        bool cond = evalBool(node->left);
-        if (cond) {
-            execute(node->right); // Bloc IF
-        } else if (node->third) {
-            // Le parser gère le ELIF comme un NODE_IF imbriqué dans le 'third' (else)
-            // Donc execute(node->third) gère récursivement les chaines if/else if/else
-            execute(node->third);
-        }
-        break;
-    }
+// await p : {code, stdout, stderr} une fois le processus terminé
+static char* awaitProc(ProcRef* ref) {
+    gcPushRoot(&ref->gc);
+    Map* map = newMap();
+    gcPushRoot(&map->gc);
+    procWaitDone(ref);
+    EvalValue code = { false, false, NULL, (double)sys_proc_status(ref->proc) };
+    mapSetNamed(map, "code", code);
+    mapSetNamed(map, "stdout", procOutput(ref, false));
+    mapSetNamed(map, "stderr", procOutput(ref, true));
+    gcPopRoots(2);
+    
+    char* id = heapIdStr(&map->gc);
+    char* result = str_copy(id);
+    rstr_release(id);
+    return result;
+}
 
-    // --- LOOPS (WHILE) ---
-    case NODE_WHILE: {
-        // Boucle tant que la condition (node->left) est vraie
-        while (evalBool(node->left)) {
-            // Exécute le corps de la boucle (node->right)
-            execute(node->right);
+// ======================================================
+// [SECTION] BOUCLES PARALLÈLES
+// ======================================================
+// parallel for i in a..b { ... } et parallel for x in liste { ... } découpent
+// les itérations en tranches exécutées par les workers ; list.pmap(f) fait de
+// même pour f(x) et rend les résultats dans l'ordre. Le corps voit dans son
+// worker une copie des variables du script qu'il nomme, et n'en affecte que
+// celles de reduce(nom: op, ...) (runtime error sinon). Chacune repart de
+// l'élément neutre de op dans chaque tranche, puis les résultats partiels sont
+// combinés dans l'ordre des tranches : sum (nombres, ou chaînes et listes mises
+// bout à bout), min, max, concat (listes ou chaînes). En dessous de
+// PARALLEL_MIN_ITEMS itérations, avec un seul worker, ou depuis un worker, la
+// boucle reste séquentielle dans l'isolat courant.
 
-            // Important: si un 'return' est appelé dans la boucle, on doit s'arrêter
-            if (current_function && current_function->has_returned) {
-                break;
+#define PARALLEL_MIN_ITEMS 128
+#define PARALLEL_CHUNKS_PER_WORKER 4 // tranches plus petites : le vol de travail équilibre
+
+typedef enum { REDUCE_SUM, REDUCE_MIN, REDUCE_MAX, REDUCE_CONCAT } ReduceOp;
+
+static ReduceOp reduceOp(ASTNode* reduction) {
+    const char* op = reduction->left->data.name;
+    if (strcmp(op, "sum") == 0) return REDUCE_SUM;
+    if (strcmp(op, "min") == 0) return REDUCE_MIN;
+    if (strcmp(op, "max") == 0) return REDUCE_MAX;
+    if (strcmp(op, "concat") == 0) return REDUCE_CONCAT;
+    runtime_error(reduction, "Unknown reduction '%s' (expected sum, min, max or concat)", op);
+    return REDUCE_SUM;
+}
+
+static Variable* reductionVar(ASTNode* reduction) {
+    int idx = findVarSym(nodeSym(reduction));
+    if (idx < 0) runtime_error(reduction, "Undefined reduction variable '%s'", reduction->data.name);
+    return &vars[idx];
+}
+
+// Élément neutre de l'opération, du type de la valeur capturée
+static void resetReduction(ASTNode* reduction) {
+    Variable* var = reductionVar(reduction);
+    switch (reduceOp(reduction)) {
+        case REDUCE_MIN:
+            setVarNumber(var, INFINITY);
+            return;
+        case REDUCE_MAX:
+            setVarNumber(var, -INFINITY);
+            return;
+        case REDUCE_SUM:
+        case REDUCE_CONCAT:
+            if (var->is_string && listFromId(var->value.str_val)) {
+                storeValue(var, listValue(newList(0)));
+            } else if (var->is_string) {
+                setVarString(var, rstr_new("", 0));
+            } else {
+                setVarNumber(var, 0.0);
             }
-        }
-        break;
+            return;
     }
-    // --- LOOPS (FOR) ---
-    case NODE_FOR: {
-        // 1. Clause d'initialisation (ex: var i = 0)
-        if (node->data.loop.init) {
-            execute(node->data.loop.init);
-        }
+}
 
-        // 2. Boucle avec condition
-        while (evalBool(node->data.loop.condition)) {
-            // 3. Exécution du corps
-            execute(node->data.loop.body);
+// Ajoute le résultat partiel d'une tranche à la variable de l'isolat demandeur
+static void combineReduction(ASTNode* reduction, EvalValue part) {
+    Variable* var = reductionVar(reduction);
+    ReduceOp op = reduceOp(reduction);
+    if (op == REDUCE_MIN || op == REDUCE_MAX) {
+        double current = varNumber(var);
+        if (op == REDUCE_MIN ? part.num < current : part.num > current) setVarNumber(var, part.num);
+        return;
+    }
+    if (!var->is_string && !part.is_string) {
+        setVarNumber(var, varNumber(var) + part.num);
+        return;
+    }
+    List* dst = var->is_string ? listFromId(var->value.str_val) : NULL;
+    List* src = part.is_string ? listFromId(part.str) : NULL;
+    if (dst && src) {
+        for (int i = 0; i < src->count; i++) listPush(dst, copyValue(src->items[i]));
+        return;
+    }
+    if (dst || src || !var->is_string || !part.is_string) {
+        runtime_error(reduction, "Reduction '%s' cannot combine a list with a string or a number", reduction->data.name);
+    }
+    char* joined = rstr_new(var->value.str_val ? var->value.str_val : "", var->value.str_val ? rstr_len(var->value.str_val) : 0);
+    joined = rstr_append(joined, part.str, rstr_len(part.str));
+    setVarString(var, joined);
+}
 
-            // Sortir si 'return'
-            if (current_function && current_function->has_returned) {
-                break;
-            }
+// Variables du script nommées par le corps, sauf la variable de boucle
+typedef struct {
+    int skip;
+    int* syms;
+    const char** names;
+    int count;
+    int cap;
+} CaptureSet;
 
-            // 4. Clause de mise à jour (ex: i = i + 1)
-            if (node->data.loop.update) {
-                execute(node->data.loop.update);
-            }
-        }
-        break;
+static bool hasSym(CaptureSet* set, int sym) {
+    for (int i = 0; i < set->count; i++) {
+        if (set->syms[i] == sym) return true;
     }
+    return false;
+}
 
-    // --- OOP (CLASS) ---
-    case NODE_CLASS: {
-        char* cls_name = node->data.class_def.name;
-        if (cls_name) {
-            // 1. Enregistrement de la classe (existant)
-            char* parent = node->data.class_def.parent ? node->data.class_def.parent->data.name : NULL;
-            registerClass(cls_name, parent, node->data.class_def.members);
-            
-            // 2. [NOUVEAU] Aplatissement des méthodes : Zarch.install -> Zarch_install
-            ASTNode* member = node->data.class_def.members;
-            while (member) {
-                if (member->type == NODE_FUNC) {
-                    char method_full_name[256];
-                    snprintf(method_full_name, 256, "%s_%s", cls_name, member->data.name);
-                    
-                    // Compter les params
-                    int p_count = 0;
-                    ASTNode* p = member->left;
-                    while(p) { p_count++; p = p->right; }
-                    
-                    registerFunction(method_full_name, member->left, member->right, p_count);
-                    // printf("[OOP] Registered method: %s\n", method_full_name);
-                }
-                member = member->right;
-            }
-        }
-        break;
+static void addSym(CaptureSet* set, int sym, const char* name) {
+    if (!sym || hasSym(set, sym)) return;
+    if (set->count == set->cap) {
+        set->cap = set->cap ? set->cap * 2 : 8;
+        set->syms = realloc(set->syms, set->cap * sizeof(int));
+        set->names = realloc(set->names, set->cap * sizeof(char*));
+        if (!set->syms || !set->names) { fprintf(stderr, "%s[FATAL]%s Out of memory (parallel)\n", COLOR_RED, COLOR_RESET); exit(1); }
     }
+    set->syms[set->count] = sym;
+    set->names[set->count++] = name;
+}
 
-    // --- OOP (ENUM) ---
-    case NODE_ENUM: {
-        // Transforme: enum Color { RED, BLUE } 
-        // En constantes globales: Color_RED = 0, Color_BLUE = 1
-        if (node->data.name && node->left) {
-            ASTNode* variant = node->left;
-            int val_counter = 0;
-            
-            while (variant) {
-                char full_name[256];
-                char* variant_name = NULL;
-                
-                // Le variant peut être un IDENT ou un ASSIGN (si valeur manuelle)
-                if (variant->type == NODE_IDENT) {
-                    variant_name = variant->data.name;
-                } else if (variant->type == NODE_ASSIGN && variant->data.name) {
-                    variant_name = variant->data.name;
-                    // Si une valeur est assignée (ex: RED = 5)
-                    if (variant->left) val_counter = (int)evalFloat(variant->left);
-                }
-                
-                if (variant_name) {
-                    snprintf(full_name, 256, "%s_%s", node->data.name, variant_name);
-                    registerGlobalConstant(full_name, val_counter);
-                    val_counter++;
-                }
-                
-                variant = variant->right;
-            }
+static void addCapture(CaptureSet* set, ASTNode* node) {
+    int sym = nodeSym(node);
+    if (!sym || sym == set->skip || findVarSym(sym) < 0) return;
+    addSym(set, sym, node->data.name);
+}
+
+// Visite d'un nœud du corps ; false : ne pas descendre dans ses enfants
+typedef bool (*LoopVisit)(ASTNode* node, CaptureSet* set);
+
+// Même parcours que optimizeNode
+static void walkLoopBody(ASTNode* node, CaptureSet* set, LoopVisit visit) {
+    for (; node; node = node->next) {
+        if (node->type == NODE_CLASS || !visit(node, set)) continue;
+        switch (node->type) {
+            case NODE_FOR:
+                walkLoopBody(node->data.loop.init, set, visit);
+                walkLoopBody(node->data.loop.condition, set, visit);
+                walkLoopBody(node->data.loop.update, set, visit);
+                walkLoopBody(node->data.loop.body, set, visit);
+                continue;
+            case NODE_FOR_IN:
+            case NODE_PARALLEL_FOR:
+                walkLoopBody(node->data.for_in.iterable, set, visit);
+                walkLoopBody(node->third, set, visit);
+                walkLoopBody(node->data.for_in.body, set, visit);
+                continue;
+            case NODE_SWITCH:
+                walkLoopBody(node->data.switch_stmt.expr, set, visit);
+                walkLoopBody(node->data.switch_stmt.cases, set, visit);
+                walkLoopBody(node->data.switch_stmt.default_case, set, visit);
+                continue;
+            case NODE_CASE:
+                walkLoopBody(node->data.case_stmt.value, set, visit);
+                walkLoopBody(node->data.case_stmt.body, set, visit);
+                continue;
+            case NODE_TRY:
+                walkLoopBody(node->data.try_catch.try_block, set, visit);
+                walkLoopBody(node->data.try_catch.catch_block, set, visit);
+                walkLoopBody(node->data.try_catch.finally_block, set, visit);
+                continue;
+            case NODE_APPEND:
+                walkLoopBody(node->data.append_op.list, set, visit);
+                walkLoopBody(node->data.append_op.value, set, visit);
+                continue;
+            case NODE_PUSH:
+            case NODE_POP:
+                walkLoopBody(node->data.collection_op.collection, set, visit);
+                walkLoopBody(node->data.collection_op.value, set, visit);
+                continue;
+            default:
+                break;
         }
-        break;
+        walkLoopBody(node->left, set, visit);
+        walkLoopBody(node->right, set, visit);
+        walkLoopBody(node->third, set, visit);
+        walkLoopBody(node->fourth, set, visit);
     }
+}
 
-    // --- ASYNC (Déclaration) ---
-    case NODE_ASYNC: {
-        // Dans notre interpréteur synchrone, on traite 'async func' comme une func normale
-        // Mais on pourrait marquer un flag "is_async" dans la structure Function
-        if (node->left && node->left->type == NODE_FUNC) {
-            // On délègue l'enregistrement au NODE_FUNC standard
-            execute(node->left); 
-            
-            // Optionnel : Retrouver la fonction et marquer comme async
-            // Optionnel : Retrouver la fonction et marquer comme async
-            if (node->left->data.name) {
-                // Function* f = findFunction(node->left->data.name); // Variable supprimée pour éviter le warning
-                
-            }
-        }
-        break;
-    }         
-       
-        case NODE_FUNC: {
-    // Enregistrer la fonction SEULEMENT si on est dans le scope global
-    // et si ce n'est pas dans un module importé (géré par loadAndExecuteModule)
-    if (node->data.name && scope_level == 0) {
-                               
-        int param_count = 0;
-        ASTNode* param = node->left;
-        while (param) {
-            param_count++;
-            param = param->right;
-        }
-        
-        registerFunction(node->data.name, node->left, node->right, param_count);
+static bool visitCapture(ASTNode* node, CaptureSet* set) {
+    if ((node->type == NODE_IDENT || node->type == NODE_ASSIGN || node->type == NODE_COMPOUND_ASSIGN) &&
+        node->data.name) {
+        addCapture(set, node);
     }
-    break;
-} 
-            
-       case NODE_FUNC_CALL: {
-        char* func_name = node->data.name;
-        char* prev_this = current_this; 
-        char real_func_name[256];
-        bool is_method = false;
+    return true;
+}
 
-        // ====================================================
-        // [FIX OOP] LOGIQUE DE REDIRECTION MÉTHODE
-        // ====================================================
-        char* dot = strchr(func_name, '.');
-        
-        if (dot) {
-            // On sépare l'objet et la méthode (ex: "app" et "install")
-            int len = dot - func_name;
-            char var_name[128];
-            strncpy(var_name, func_name, len);
-            var_name[len] = '\0';
-            char* method_name = dot + 1;
-
-            // 1. On cherche la variable "app" pour avoir son ID d'instance
-            int v_idx = findVar(var_name);
-            
-            if (v_idx >= 0 && vars[v_idx].is_string) {
-                char* inst_id = vars[v_idx].value.str_val; // ex: "inst_1"
-                
-                // 2. On cherche la classe de cette instance
-                char* cls = findClassOf(inst_id); // ex: "Zarch"
-                
-                if (cls) {
-                    // 3. On construit le nom interne "Zarch_install"
-                    snprintf(real_func_name, 256, "%s_%s", cls, method_name);
-                    func_name = real_func_name;
-                    
-                    // 4. On définit le contexte 'this'
-                    current_this = inst_id;
-                    is_method = true;
-                }
-            }
-        }
-        // ====================================================
+static void collectCaptures(ASTNode* node, CaptureSet* set) {
+    walkLoopBody(node, set, visitCapture);
+}
 
-        Function* func = findFunction(func_name);
-        
-        if (func) {
-            Function* prev_func = current_function;
-            current_function = func;
-            
-            int old_scope = scope_level;
-            scope_level++;
-            
-            // Passage des arguments
-            if (node->left && func->param_names) {
-                ASTNode* arg = node->left;
-                int param_idx = 0;
-                
-                while (arg && param_idx < func->param_count) {
-                    if (func->param_names[param_idx]) {
-                        if (var_count < 1000) {
-                            Variable* var = &vars[var_count];
-                            strncpy(var->name, func->param_names[param_idx], 99);
-                            var->type = TK_VAR;
-                            var->scope_level = scope_level;
-                            var->is_constant = false;
-                            var->is_initialized = true;
-                            
-                            // Évaluation de l'argument
-                            if (arg->type == NODE_STRING) {
-                                var->is_string = true;
-                                var->value.str_val = evalString(arg);
-                            } else {
-                                var->is_float = true;
-                                var->value.float_val = evalFloat(arg);
-                            }
-                            var_count++;
-                        }
-                    }
-                    arg = arg->right;
-                    param_idx++;
-                }
-            }
-            
-            // Exécution
-            func->has_returned = false;
-            if (func->body) {
-                execute(func->body);
-            }
-            
-            // Restauration
-            scope_level = old_scope;
-            current_function = prev_func;
-            
-            if (is_method) current_this = prev_this;
-            
-        } else {
-            // Affichage d'erreur propre
-            // Utilise runtime_error si tu l'as ajoutée, sinon printf simple
-            fprintf(stderr, "\033[31m[RUNTIME ERROR]\033[0m Function or method not found: '%s'\n", func_name);
-            exit(1);
-        }
-        
-        // Sécurité
-        if (is_method) current_this = prev_this;
-        break;
+// Un parallel for n'écrit dans le script que par reduce() : ailleurs, une
+// affectation serait appliquée en séquentiel mais perdue dans la copie d'un
+// worker. Elle est refusée dans les deux cas, avant de choisir le mode.
+// set : noms que le corps peut affecter (boucle, reduce, variables déclarées
+// dans le corps).
+static bool isDeclNode(ASTNode* node) {
+    switch (node->type) {
+        case NODE_VAR_DECL: case NODE_NET_DECL: case NODE_CLOG_DECL: case NODE_DOS_DECL:
+        case NODE_SEL_DECL: case NODE_LET: case NODE_CONST_DECL:
+            return true;
+        default:
+            return false;
     }
-            
-       case NODE_LOCK: {
-        // Syntaxe: lock(variable) { code... }
-        if (node->left && node->left->type == NODE_IDENT) {
-            int idx = findVar(node->left->data.name);
-            if (idx >= 0) {
-                if (vars[idx].is_locked) {
-                    printf("Cannot not lock variable not found");
-                    return;
-                }
-                // Verrouillage
-                vars[idx].is_locked = true;
-                
-                // Exécution du bloc sécurisé
-                execute(node->right);
-                
-                // Déverrouillage
-                vars[idx].is_locked = false;
-            }
-        }
-        break;
-    } 
-            
-        case NODE_TYPEDEF:
-            break;
-            
-        case NODE_JSON:
+}
+
+static bool visitLoopLocal(ASTNode* node, CaptureSet* set) {
+    if (node->type == NODE_FUNC || node->type == NODE_LAMBDA) return false;
+    if (isDeclNode(node) && node->data.name) addSym(set, nodeSym(node), node->data.name);
+    if ((node->type == NODE_FOR_IN || node->type == NODE_PARALLEL_FOR) && node->data.for_in.var_name) {
+        addSym(set, intern(node->data.for_in.var_name), node->data.for_in.var_name);
+    }
+    return true;
+}
+
+// Variable racine d'une cible (x, x.champ, x[i]...)
+static ASTNode* writeRoot(ASTNode* target) {
+    while (target && (target->type == NODE_MEMBER_ACCESS || target->type == NODE_ARRAY_ACCESS)) target = target->left;
+    return target && target->type == NODE_IDENT && target->data.name ? target : NULL;
+}
+
+static bool visitLoopWrite(ASTNode* node, CaptureSet* set) {
+    ASTNode* root = NULL;
+    switch (node->type) {
+        case NODE_FUNC:
+        case NODE_LAMBDA:
+            return false;
+        case NODE_ASSIGN:
+        case NODE_COMPOUND_ASSIGN:
+        case NODE_INC_LOCAL:
+            root = node->data.name ? node : writeRoot(node->left);
             break;
-            
-        case NODE_BINARY:
-        case NODE_UNARY:
-        case NODE_TERNARY:
-            evalFloat(node);
+        case NODE_APPEND:
+            root = writeRoot(node->data.append_op.list);
             break;
-            
-        case NODE_LIST:
-        case NODE_MAP:
-            evalFloat(node);
+        case NODE_PUSH:
+        case NODE_POP:
+            root = writeRoot(node->data.collection_op.collection);
             break;
-            
         default:
-            break;
+            return true;
+    }
+    if (root && !hasSym(set, nodeSym(root))) {
+        runtime_error(node, "parallel for cannot assign '%s' outside the loop: declare it in the body or list it in reduce()",
+                      root->data.name);
+    }
+    return true;
+}
+
+static void checkLoopWrites(ASTNode* node) {
+    CaptureSet set = { 0, NULL, NULL, 0, 0 };
+    addSym(&set, intern(node->data.for_in.var_name), node->data.for_in.var_name);
+    for (ASTNode* r = node->fourth; r; r = r->next) addSym(&set, nodeSym(r), r->data.name);
+    walkLoopBody(node->data.for_in.body, &set, visitLoopLocal);
+    walkLoopBody(node->data.for_in.body, &set, visitLoopWrite);
+    free(set.syms);
+    free(set.names);
+}
+
+// Tranche d'un parallel for, dans l'isolat du worker
+static void runLoopJob(Future* future) {
+    ASTNode* node = parser_parallel_node(future->loop_index);
+    if (!node || node->line != future->loop_line || node->column != future->loop_column) {
+        fprintf(stderr, "%s[RUNTIME ERROR] %s: %sparallel for (line %d) not found in worker\n",
+                COLOR_RED, current_exec_filename, COLOR_RESET, future->loop_line);
+        exit(1);
+    }
+    int old_scope = scope_level;
+    int mark = var_count;
+    scope_level++;
+    for (int i = 0; i < future->arg_count; i++) {
+        int slot = newLoopVar(future->names[i], false);
+        if (slot < 0) runtime_error(node, "Too many variables");
+        storeValue(&vars[slot], transferIn(&future->args[i]));
+    }
+    int reductions = 0;
+    for (ASTNode* r = node->fourth; r; r = r->next) {
+        resetReduction(r);
+        reductions++;
+    }
+    
+    if (future->is_range) {
+        executeForInRange(node, future->start, future->from, future->to);
+    } else {
+        EvalValue items = transferIn(&future->items);
+        executeForInList(node, listFromId(items.str));
+        rstr_release(items.str);
+    }
+    
+    future->result.kind = XFER_LIST;
+    future->result.items = transferItems(reductions);
+    future->result.count = reductions;
+    int k = 0;
+    for (ASTNode* r = node->fourth; r; r = r->next) {
+        EvalValue v = varValue(reductionVar(r));
+        transferOut(v, &future->result.items[k++], r, 0);
+        rstr_release(v.str);
+    }
+    releaseScopeVars(mark, old_scope);
+    scope_level = old_scope;
+}
+
+// Tranche de list.pmap(f), dans l'isolat du worker
+static void runMapJob(Future* future) {
+    Function* func = workerFunction(future);
+    EvalValue items = transferIn(&future->items);
+    List* src = listFromId(items.str);
+    gcPushRoot(&src->gc);
+    List* out = newList(src->count);
+    gcPushRoot(&out->gc);
+    for (int i = 0; i < src->count; i++) listPush(out, callKey(func, src->items[i]));
+    EvalValue result = listValue(out);
+    transferOut(result, &future->result, func->body, 0);
+    rstr_release(result.str);
+    gcPopRoots(2);
+    rstr_release(items.str);
+}
+
+// Découpe [0, count) en tranches d'au moins une itération
+static int parallelChunks(int workers, long count, long* per_chunk) {
+    long chunks = (long)workers * PARALLEL_CHUNKS_PER_WORKER;
+    if (chunks > count) chunks = count;
+    *per_chunk = (count + chunks - 1) / chunks;
+    return (int)((count + *per_chunk - 1) / *per_chunk);
+}
+
+// Éléments [from, to) de la liste, copiés pour un worker
+static void transferSlice(List* list, long from, long to, Transfer* out, ASTNode* node) {
+    out->kind = XFER_LIST;
+    out->count = (int)(to - from);
+    out->items = transferItems(out->count);
+    for (long i = from; i < to; i++) transferOut(list->items[i], &out->items[i - from], node, 1);
+}
+
+static void waitFutures(Future** jobs, int count) {
+    for (int i = 0; i < count; i++) {
+        while (!__atomic_load_n(&jobs[i]->done, __ATOMIC_ACQUIRE)) isolateWait(-1);
+    }
+}
+
+static void executeParallelFor(ASTNode* node) {
+    ASTNode* iterable = node->data.for_in.iterable;
+    if (!iterable || !node->data.for_in.var_name) return;
+    for (ASTNode* r = node->fourth; r; r = r->next) {
+        reduceOp(r);
+        reductionVar(r);
+    }
+    checkLoopWrites(node);
+    
+    double start = 0.0;
+    long count;
+    List* list = NULL;
+    if (node->third) {
+        start = evalFloat(iterable);
+        count = rangeCount(node, start, evalFloat(node->third));
+    } else {
+        char* id = evalStr(iterable);
+        list = listFromId(id);
+        rstr_release(id);
+        if (!list) runtime_error(node, "parallel for expects a range (a..b) or a list");
+        count = list->count;
+    }
+    
+    int workers = count >= PARALLEL_MIN_ITEMS && pool_worker_index() < 0 ? ensurePool(node) : 0;
+    if (workers < 2) {
+        if (list) executeForInList(node, list);
+        else executeForInRange(node, start, 0, count);
+        return;
+    }
+    
+    // Captures copiées une fois, lues par toutes les tranches
+    CaptureSet set = { intern(node->data.for_in.var_name), NULL, NULL, 0, 0 };
+    for (ASTNode* r = node->fourth; r; r = r->next) addCapture(&set, r);
+    collectCaptures(node->data.for_in.body, &set);
+    Transfer* captures = transferItems(set.count);
+    for (int i = 0; i < set.count; i++) {
+        EvalValue v = varValue(&vars[findVarSym(set.syms[i])]);
+        transferOut(v, &captures[i], node, 0);
+        rstr_release(v.str);
+    }
+    
+    long per_chunk;
+    int chunks = parallelChunks(workers, count, &per_chunk);
+    Future** jobs = calloc(chunks, sizeof(Future*));
+    if (!jobs) { fprintf(stderr, "%s[FATAL]%s Out of memory (parallel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    int index = parser_parallel_index(node);
+    for (int c = 0; c < chunks; c++) {
+        long from = c * per_chunk;
+        long to = from + per_chunk < count ? from + per_chunk : count;
+        Future* future = newFuture(JOB_LOOP);
+        future->loop_index = index;
+        future->loop_line = node->line;
+        future->loop_column = node->column;
+        future->args = captures;
+        future->arg_count = set.count;
+        future->names = set.names;
+        if (list) {
+            transferSlice(list, from, to, &future->items, node);
+        } else {
+            future->is_range = true;
+            future->start = start;
+            future->from = from;
+            future->to = to;
+        }
+        jobs[c] = future;
+        pool_submit(futureRun, future);
+    }
+    waitFutures(jobs, chunks);
+    
+    for (int c = 0; c < chunks; c++) {
+        EvalValue parts = transferIn(&jobs[c]->result);
+        List* partial = listFromId(parts.str);
+        gcPushRoot(&partial->gc);
+        int k = 0;
+        for (ASTNode* r = node->fourth; r; r = r->next) combineReduction(r, partial->items[k++]);
+        gcPopRoots(1);
+        rstr_release(parts.str);
+        releaseFuture(jobs[c]);
+    }
+    free(jobs);
+    for (int i = 0; i < set.count; i++) freeTransfer(&captures[i]);
+    free(captures);
+    free(set.syms);
+    free(set.names);
+}
+
+static EvalValue parallelMap(ASTNode* node, List* list) {
+    Function* func = namedFunction(node, node->right, "pmap");
+    long count = list->count;
+    int workers = count >= PARALLEL_MIN_ITEMS && pool_worker_index() < 0 ? ensurePool(node) : 0;
+    List* out = newList((int)count);
+    gcPushRoot(&out->gc);
+    if (workers < 2) {
+        for (long i = 0; i < count; i++) listPush(out, callKey(func, list->items[i]));
+        gcPopRoots(1);
+        return listValue(out);
     }
+    
+    long per_chunk;
+    int chunks = parallelChunks(workers, count, &per_chunk);
+    Future** jobs = calloc(chunks, sizeof(Future*));
+    if (!jobs) { fprintf(stderr, "%s[FATAL]%s Out of memory (parallel)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    for (int c = 0; c < chunks; c++) {
+        long from = c * per_chunk;
+        long to = from + per_chunk < count ? from + per_chunk : count;
+        Future* future = newFuture(JOB_MAP);
+        strncpy(future->func_name, func->name, sizeof(future->func_name) - 1);
+        transferSlice(list, from, to, &future->items, node);
+        jobs[c] = future;
+        pool_submit(futureRun, future);
+    }
+    waitFutures(jobs, chunks);
+    
+    for (int c = 0; c < chunks; c++) {
+        EvalValue part = transferIn(&jobs[c]->result);
+        List* mapped = listFromId(part.str);
+        for (int i = 0; i < mapped->count; i++) listPush(out, copyValue(mapped->items[i]));
+        rstr_release(part.str);
+        releaseFuture(jobs[c]);
+    }
+    free(jobs);
+    gcPopRoots(1);
+    return listValue(out);
 }
 
 // ======================================================
 // [SECTION] MAIN EXECUTION FUNCTION
 // ======================================================
 static void run(const char* source, const char* filename) {
+    initIsolateStorage();
     initWorkingDir(filename);
     
         
@@ -2351,22 +7475,19 @@ static void run(const char* source, const char* filename) {
         return;
     }
     
-    // 1. ÉTAPE DE PRÉ-ENREGISTREMENT (Fonctions et Classes)
-    for (int i = 0; i < count; i++) {
-        if (nodes[i]) {
-            if (nodes[i]->type == NODE_FUNC) {
-                int param_count = 0;
-                ASTNode* param = nodes[i]->left;
-                while (param) {
-                    param_count++;
-                    param = param->right;
-                }
-                registerFunction(nodes[i]->data.name, nodes[i]->left, nodes[i]->right, param_count);
-            } else if (nodes[i]->type == NODE_CLASS) {
-                execute(nodes[i]); // Enregistrement des classes
-            }
-        }
+    optimizeProgram(nodes, count);
+    if (pool_worker_index() < 0 && !isolate_source) {
+        isolate_source = strdup(source); // relue par chaque worker (spawn)
+        isolate_filename = strdup(filename);
+    }
+    if (dump_ast) {
+        dumpProgram(nodes, count);
+        return;
     }
+    sched_set_hooks(saveTaskContext, restoreTaskContext);
+    
+    // 1. ÉTAPE DE PRÉ-ENREGISTREMENT (Fonctions et Classes)
+    registerDefinitions(nodes, count, false);
     
     ASTNode* main_node = NULL;
     
@@ -2382,11 +7503,12 @@ static void run(const char* source, const char* filename) {
         }
 
         // On ignore les définitions de fonctions (déjà enregistrées à l'étape 1)
-        if (nodes[i]->type == NODE_FUNC || nodes[i]->type == NODE_CLASS) {
+        if (nodes[i]->type == NODE_FUNC || nodes[i]->type == NODE_CLASS || nodes[i]->type == NODE_ASYNC) {
             continue;
         }
 
         // On exécute tout le reste (Imports, Variables globales, print, etc.)
+        if (gc_pending || gc_sweeping) gcSafepoint();
         execute(nodes[i]);
     }
     
@@ -2395,6 +7517,14 @@ static void run(const char* source, const char* filename) {
         execute(main_node);
     }
     
+    // Tâches async jamais attendues : elles vont jusqu'au bout
+    sched_drain();
+    pool_wait_idle(); // futures jamais attendues
+    
+    // Fermer les handles d'append encore en cache (vide leurs buffers)
+    io_release_appends(0);
+    gcPrintStats();
+    
     // NETTOYAGE
     for (int i = 0; i < count; i++) {
         if (nodes[i]) {
@@ -2412,7 +7542,7 @@ static void run(const char* source, const char* filename) {
     // Nettoyage variables globales
     for (int i = 0; i < var_count; i++) {
         if (vars[i].is_string && vars[i].value.str_val) {
-            free(vars[i].value.str_val);
+            rstr_release(vars[i].value.str_val);
         }
     }
     var_count = 0;
@@ -2427,7 +7557,7 @@ static void run(const char* source, const char* filename) {
             free(functions[i].param_names);
         }
         if (functions[i].return_string) {
-            free(functions[i].return_string);
+            rstr_release(functions[i].return_string);
         }
     }
     func_count = 0;
@@ -2664,8 +7794,12 @@ int main(int argc, char* argv[]) {
         // No filename provided, start REPL
         repl();
     } else {
-        // Check if first argument is a flag
-        if (argv[1][0] == '-') {
+        const char* path = argv[1];
+        if (strcmp(argv[1], "--dump-ast") == 0 && argc >= 3) {
+            dump_ast = true;
+            path = argv[2];
+        } else if (argv[1][0] == '-') {
+            // Check if first argument is a flag
             // It's a flag but not recognized, show error
             printf("Cannot assign to constant '%s'", argv);
             printf("Use %s--help%s for usage information.\n", COLOR_CYAN, COLOR_RESET);
@@ -2673,12 +7807,12 @@ int main(int argc, char* argv[]) {
         }
         
         // Load and run the file
-        char* source = loadFile(argv[1]);
+        char* source = loadFile(path);
         if (!source) {
             return 1;
         }
         
-        run(source, argv[1]);
+        run(source, path);
         free(source);
     }
     
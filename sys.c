@@ -1,7 +1,19 @@
+// sys.c - Module système pour SwiftFlow (arguments, commandes, processus)
+#define _GNU_SOURCE // posix_spawn_file_actions_addchdir_np, pipe2
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
 #include "common.h"
 #include "sys.h"
 
@@ -47,3 +59,348 @@ int sys_exec_int(const char* cmd) {
     if (res == -1) return -1;
     return (res >> 8) & 0xFF; 
 }
+
+// ======================================================
+// [SECTION] PROCESSUS
+// ======================================================
+// Enfants lancés par posix_spawn, stdout et stderr reliés à des tubes non
+// bloquants. Rien ne bloque ici : l'appelant attend sur les descripteurs de
+// sys_proc_pollfds() (boucle d'événements) puis appelle sys_proc_progress(),
+// qui lit les tubes de tous les enfants de l'isolat, écrit leur stdin et
+// récolte ceux qui sont terminés. Lire tous les tubes à chaque réveil évite
+// qu'un enfant dont personne n'attend la fin reste bloqué sur un tube plein.
+// La fin d'un enfant réveille la boucle par son pidfd (lisible quand il se
+// termine) : pas de SIGCHLD, donc rien à coordonner entre les threads des
+// workers. Sans pidfd (noyau < 5.3), l'enfant est récolté après la
+// fermeture de ses tubes, en sondant toutes les SYS_REAP_POLL_MS.
+
+#define SYS_READ_CHUNK 65536
+#define SYS_REAP_POLL_MS 5
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+    size_t pos;       // début de ce qui n'a pas encore été rendu
+} SysBuffer;
+
+struct SysProc {
+    pid_t pid;
+    int pid_fd;       // pidfd, -1 s'il n'existe pas ou une fois l'enfant récolté
+    int out_fd;       // -1 une fois fermé
+    int err_fd;
+    int in_fd;
+    char* input;      // données pour stdin, écrites au fil des réveils
+    size_t input_len;
+    size_t input_pos;
+    SysBuffer out;
+    SysBuffer err;
+    bool exited;
+    int status;       // code de sortie, 128 + signal
+    struct timespec started;
+    double wall;      // secondes, du lancement à la récolte
+    double cpu;       // temps CPU utilisateur + système de l'enfant
+    bool released;    // plus de détenteur : libéré après sa récolte
+    struct SysProc* next;
+};
+
+static ISOLATE SysProc* procs = NULL;   // enfants pas encore récoltés ou encore détenus
+static ISOLATE int running = 0;
+
+extern char** environ;
+
+static void bufferAppend(SysBuffer* b, const char* data, size_t len) {
+    if (b->pos > 0 && b->pos >= b->len / 2) { // lignes déjà rendues : on récupère la place
+        memmove(b->data, b->data + b->pos, b->len - b->pos);
+        b->len -= b->pos;
+        b->pos = 0;
+    }
+    if (b->len + len + 1 > b->cap) {
+        size_t cap = b->cap ? b->cap : 4096;
+        while (cap < b->len + len + 1) cap *= 2;
+        char* grown = realloc(b->data, cap);
+        if (!grown) { fprintf(stderr, "%s[FATAL]%s Out of memory (process output)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        b->data = grown;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    b->data[b->len] = '\0';
+}
+
+static void closeFd(int* fd) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+}
+
+// Lit tout ce qui est disponible ; ferme le tube à la fin du flux
+static void drainPipe(int* fd, SysBuffer* b) {
+    char chunk[SYS_READ_CHUNK];
+    while (*fd >= 0) {
+        ssize_t n = read(*fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            bufferAppend(b, chunk, (size_t)n);
+        } else if (n == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeFd(fd);
+        } else if (errno != EINTR) {
+            return;
+        }
+    }
+}
+
+// Écriture sur stdin sans recevoir SIGPIPE si l'enfant a fermé son entrée
+static void feedInput(SysProc* p) {
+    if (p->in_fd < 0) return;
+    sigset_t pipe_set, old_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+    while (p->input_pos < p->input_len) {
+        ssize_t n = write(p->in_fd, p->input + p->input_pos, p->input_len - p->input_pos);
+        if (n > 0) {
+            p->input_pos += (size_t)n;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) p->input_pos = p->input_len; // EPIPE : entrée abandonnée
+            break;
+        }
+    }
+    if (p->input_pos == p->input_len) {
+        closeFd(&p->in_fd);
+        free(p->input);
+        p->input = NULL;
+    }
+    // Un SIGPIPE reçu pendant le blocage est consommé, pas livré
+    struct timespec zero = { 0, 0 };
+    while (sigtimedwait(&pipe_set, NULL, &zero) > 0) {}
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+}
+
+static double elapsedSince(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void reap(SysProc* p) {
+    if (p->exited) return;
+    int status;
+    struct rusage usage;
+    pid_t r = wait4(p->pid, &status, WNOHANG, &usage);
+    if (r == 0 || (r < 0 && errno == EINTR)) return;
+    p->exited = true;
+    running--;
+    closeFd(&p->pid_fd);
+    p->wall = elapsedSince(&p->started);
+    if (r > 0) {
+        p->cpu = (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                 (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+    if (r < 0) p->status = -1;
+    else if (WIFEXITED(status)) p->status = WEXITSTATUS(status);
+    else if (WIFSIGNALED(status)) p->status = 128 + WTERMSIG(status);
+    else p->status = -1;
+}
+
+static void freeProc(SysProc* p) {
+    closeFd(&p->pid_fd);
+    closeFd(&p->out_fd);
+    closeFd(&p->err_fd);
+    closeFd(&p->in_fd);
+    free(p->input);
+    free(p->out.data);
+    free(p->err.data);
+    free(p);
+}
+
+static SysProc* newProc(void) {
+    SysProc* p = calloc(1, sizeof(SysProc));
+    if (!p) { fprintf(stderr, "%s[FATAL]%s Out of memory (process)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    p->pid_fd = p->out_fd = p->err_fd = p->in_fd = -1;
+    clock_gettime(CLOCK_MONOTONIC, &p->started);
+    p->next = procs;
+    procs = p;
+    return p;
+}
+
+// Échec du lancement : processus déjà terminé, comme le shell (127 : introuvable)
+static SysProc* failedProc(const char* program, int err) {
+    SysProc* p = newProc();
+    p->pid = -1;
+    p->exited = true;
+    p->status = err == ENOENT ? 127 : 126;
+    char msg[512];
+    int len = snprintf(msg, sizeof(msg), "%s: %s\n", program, strerror(err));
+    bufferAppend(&p->err, msg, (size_t)(len < (int)sizeof(msg) ? len : (int)sizeof(msg) - 1));
+    return p;
+}
+
+SysProc* sys_proc_spawn(char* const argv[], char* const envp[], const char* cwd,
+                        const char* input, size_t input_len) {
+    sys_proc_progress(); // enfants terminés entre-temps : tubes fermés avant d'en ouvrir d'autres
+    int out_pipe[2] = { -1, -1 }, err_pipe[2] = { -1, -1 }, in_pipe[2] = { -1, -1 };
+    // O_CLOEXEC : un enfant lancé en même temps n'hérite pas des tubes des autres
+    if (pipe2(out_pipe, O_CLOEXEC) < 0 || pipe2(err_pipe, O_CLOEXEC) < 0 ||
+        (input && pipe2(in_pipe, O_CLOEXEC) < 0)) {
+        int err = errno;
+        for (int i = 0; i < 2; i++) {
+            if (out_pipe[i] >= 0) close(out_pipe[i]);
+            if (err_pipe[i] >= 0) close(err_pipe[i]);
+            if (in_pipe[i] >= 0) close(in_pipe[i]);
+        }
+        return failedProc(argv[0], err);
+    }
+    
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (input) posix_spawn_file_actions_adddup2(&actions, in_pipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+    if (cwd) posix_spawn_file_actions_addchdir_np(&actions, cwd);
+    
+    // L'enfant repart des signaux par défaut, sans masque hérité
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t none, defaults;
+    sigemptyset(&none);
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    
+    pid_t pid;
+    int err = posix_spawnp(&pid, argv[0], &actions, &attr, argv, envp ? envp : environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+    if (input) close(in_pipe[0]);
+    if (err != 0) {
+        close(out_pipe[0]);
+        close(err_pipe[0]);
+        if (input) close(in_pipe[1]);
+        return failedProc(argv[0], err);
+    }
+    
+    SysProc* p = newProc();
+    p->pid = pid;
+#ifdef SYS_pidfd_open
+    p->pid_fd = (int)syscall(SYS_pidfd_open, pid, 0); // -1 (ENOSYS) : sondage
+#endif
+    p->out_fd = out_pipe[0];
+    p->err_fd = err_pipe[0];
+    fcntl(p->out_fd, F_SETFL, O_NONBLOCK);
+    fcntl(p->err_fd, F_SETFL, O_NONBLOCK);
+    if (input) {
+        p->in_fd = in_pipe[1];
+        fcntl(p->in_fd, F_SETFL, O_NONBLOCK);
+        p->input = malloc(input_len ? input_len : 1);
+        if (!p->input) { fprintf(stderr, "%s[FATAL]%s Out of memory (process)\n", COLOR_RED, COLOR_RESET); exit(1); }
+        memcpy(p->input, input, input_len);
+        p->input_len = input_len;
+        feedInput(p);
+    }
+    running++;
+    return p;
+}
+
+void sys_proc_release(SysProc* p) {
+    p->released = true;
+    closeFd(&p->in_fd); // personne n'écrira plus : l'enfant voit la fin de son entrée
+    sys_proc_progress();
+}
+
+int sys_proc_pid(SysProc* p) {
+    return (int)p->pid;
+}
+
+bool sys_proc_done(SysProc* p) {
+    return p->exited && p->out_fd < 0 && p->err_fd < 0;
+}
+
+int sys_proc_status(SysProc* p) {
+    return p->status;
+}
+
+int sys_proc_running(void) {
+    return running;
+}
+
+double sys_proc_wall(SysProc* p) {
+    return p->exited ? p->wall : elapsedSince(&p->started);
+}
+
+double sys_proc_cpu(SysProc* p) {
+    return p->cpu;
+}
+
+bool sys_proc_kill(SysProc* p, int sig) {
+    if (p->exited || p->pid <= 0) return false;
+    return kill(p->pid, sig) == 0;
+}
+
+const char* sys_proc_line(SysProc* p, size_t* len) {
+    SysBuffer* b = &p->out;
+    if (b->pos == b->len) return NULL;
+    const char* start = b->data + b->pos;
+    const char* nl = memchr(start, '\n', b->len - b->pos);
+    if (!nl && p->out_fd >= 0) return NULL; // ligne incomplète : la suite arrive
+    size_t line = nl ? (size_t)(nl - start) : b->len - b->pos;
+    b->pos += line + (nl ? 1 : 0);
+    *len = line;
+    return start;
+}
+
+bool sys_proc_eof(SysProc* p) {
+    return p->out_fd < 0 && p->out.pos == p->out.len;
+}
+
+const char* sys_proc_output(SysProc* p, bool err, size_t* len) {
+    SysBuffer* b = err ? &p->err : &p->out;
+    if (!b->data) {
+        *len = 0;
+        return "";
+    }
+    const char* start = b->data + b->pos;
+    *len = b->len - b->pos;
+    b->pos = b->len;
+    return start;
+}
+
+struct pollfd* sys_proc_pollfds(int* count, int* timeout_ms) {
+    // Tableau propre à chaque appel : une tâche garée garde le sien pendant
+    // que d'autres tâches de l'isolat en construisent un nouveau
+    int n = 0, cap = 0;
+    for (SysProc* p = procs; p; p = p->next) cap += 4;
+    struct pollfd* fds = malloc((size_t)(cap ? cap : 1) * sizeof(struct pollfd));
+    if (!fds) { fprintf(stderr, "%s[FATAL]%s Out of memory (process)\n", COLOR_RED, COLOR_RESET); exit(1); }
+    *timeout_ms = -1;
+    for (SysProc* p = procs; p; p = p->next) {
+        if (p->out_fd >= 0) fds[n++] = (struct pollfd){ p->out_fd, POLLIN, 0 };
+        if (p->err_fd >= 0) fds[n++] = (struct pollfd){ p->err_fd, POLLIN, 0 };
+        if (p->in_fd >= 0) fds[n++] = (struct pollfd){ p->in_fd, POLLOUT, 0 };
+        if (p->pid_fd >= 0) fds[n++] = (struct pollfd){ p->pid_fd, POLLIN, 0 };
+        else if (!p->exited && p->out_fd < 0 && p->err_fd < 0) *timeout_ms = SYS_REAP_POLL_MS;
+    }
+    *count = n;
+    return fds;
+}
+
+void sys_proc_progress(void) {
+    SysProc** link = &procs;
+    while (*link) {
+        SysProc* p = *link;
+        drainPipe(&p->out_fd, &p->out);
+        drainPipe(&p->err_fd, &p->err);
+        feedInput(p);
+        if (p->pid_fd >= 0 || (p->out_fd < 0 && p->err_fd < 0)) reap(p);
+        if (p->released && p->exited) {
+            *link = p->next;
+            freeProc(p);
+            continue;
+        }
+        link = &p->next;
+    }
+}
@@ -1,8 +1,52 @@
 #ifndef SYS_H
 #define SYS_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <poll.h>
+
 void init_sys_module(int argc, char** argv);
 char* sys_get_argv(int index);
 int sys_exec_int(const char* cmd);
 
+// ============================================================
+// PROCESSUS ENFANTS
+// posix_spawn, stdout et stderr capturés par des tubes, stdin alimenté
+// depuis une chaîne. Aucune fonction ne bloque : attendre sur
+// sys_proc_pollfds() puis appeler sys_proc_progress(). Un lancement qui
+// échoue rend un processus déjà terminé (127 : programme introuvable, 126
+// sinon) avec le message sur stderr.
+// ============================================================
+
+typedef struct SysProc SysProc;
+
+// envp NULL : environnement courant ; cwd NULL : répertoire courant ;
+// input NULL : stdin hérité
+SysProc* sys_proc_spawn(char* const argv[], char* const envp[], const char* cwd,
+                        const char* input, size_t input_len);
+// Le détenteur lâche le processus ; libéré une fois l'enfant récolté
+void sys_proc_release(SysProc* p);
+
+int sys_proc_pid(SysProc* p);
+bool sys_proc_done(SysProc* p);      // terminé, récolté et tubes vidés
+int sys_proc_status(SysProc* p);     // code de sortie, 128 + signal
+int sys_proc_running(void);          // enfants de l'isolat pas encore récoltés
+double sys_proc_wall(SysProc* p);    // secondes depuis le lancement (jusqu'à la récolte)
+double sys_proc_cpu(SysProc* p);     // temps CPU de l'enfant, connu à la récolte
+bool sys_proc_kill(SysProc* p, int sig);
+
+// Prochaine ligne de stdout sans '\n' (pointeur valable jusqu'au prochain
+// sys_proc_progress), NULL tant qu'aucune n'est complète
+const char* sys_proc_line(SysProc* p, size_t* len);
+bool sys_proc_eof(SysProc* p);       // stdout fermé et entièrement lu
+// Sortie (stdout, ou stderr si err) pas encore rendue, consommée
+const char* sys_proc_output(SysProc* p, bool err, size_t* len);
+
+// Descripteurs à surveiller pour tous les enfants de l'isolat (tubes et
+// pidfd) ; *timeout_ms borne l'attente (-1 : aucune borne). Le tableau
+// appartient à l'appelant (free).
+struct pollfd* sys_proc_pollfds(int* count, int* timeout_ms);
+// Lit, écrit et récolte ce qui est prêt, pour tous les enfants
+void sys_proc_progress(void);
+
 #endif